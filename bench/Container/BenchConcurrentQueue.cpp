@@ -0,0 +1,230 @@
+#include <benchmark/benchmark.h>
+#include <rad/Container/ConcurrentQueue.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// The baseline: a bounded std::deque under a mutex, with the same interface as the rings.
+template<class T>
+class MutexQueue
+{
+public:
+    explicit MutexQueue(size_t capacity) : m_capacity(capacity) {}
+
+    bool TryPush(T value)
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_queue.size() >= m_capacity)
+        {
+            return false;
+        }
+        m_queue.push_back(std::move(value));
+        return true;
+    }
+
+    size_t TryPushBatch(T* values, size_t count)
+    {
+        std::lock_guard lock(m_mutex);
+        count = (std::min)(count, m_capacity - m_queue.size());
+        m_queue.insert(m_queue.end(), std::make_move_iterator(values), std::make_move_iterator(values + count));
+        return count;
+    }
+
+    bool TryPop(T& value)
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_queue.empty())
+        {
+            return false;
+        }
+        value = std::move(m_queue.front());
+        m_queue.pop_front();
+        return true;
+    }
+
+    size_t TryPopBatch(T* values, size_t maxCount)
+    {
+        std::lock_guard lock(m_mutex);
+        const size_t count = (std::min)(maxCount, m_queue.size());
+        std::move(m_queue.begin(), m_queue.begin() + count, values);
+        m_queue.erase(m_queue.begin(), m_queue.begin() + count);
+        return count;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<T> m_queue;
+    size_t m_capacity;
+
+}; // class MutexQueue
+
+inline constexpr size_t QueueCapacity = 1024;
+inline constexpr size_t ItemCount = 1 << 16;
+
+// Spin with yield, the threads may outnumber the cores.
+template<class Queue>
+static void Push(Queue& queue, uint64_t value)
+{
+    while (!queue.TryPush(value))
+    {
+        std::this_thread::yield();
+    }
+}
+
+template<class Queue>
+static uint64_t Pop(Queue& queue)
+{
+    uint64_t value = 0;
+    while (!queue.TryPop(value))
+    {
+        std::this_thread::yield();
+    }
+    return value;
+}
+
+// Move ItemCount items from range(0) producers to range(1) consumers, range(2) items per push/pop.
+template<class Queue>
+static void BM_Throughput(benchmark::State& state)
+{
+    const size_t producerCount = size_t(state.range(0));
+    const size_t consumerCount = size_t(state.range(1));
+    const size_t batchSize = size_t(state.range(2));
+    for (auto _ : state)
+    {
+        Queue queue(QueueCapacity);
+        std::atomic<size_t> consumedCount = 0;
+        std::atomic<uint64_t> sum = 0;
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < producerCount; ++i)
+        {
+            threads.emplace_back([&, i]() {
+                const size_t begin = ItemCount * i / producerCount;
+                const size_t end = ItemCount * (i + 1) / producerCount;
+                std::vector<uint64_t> values(batchSize);
+                for (size_t index = begin; index < end;)
+                {
+                    if (batchSize == 1)
+                    {
+                        Push(queue, index++);
+                        continue;
+                    }
+                    const size_t count = (std::min)(batchSize, end - index);
+                    for (size_t j = 0; j < count; ++j)
+                    {
+                        values[j] = index + j;
+                    }
+                    size_t pushed = 0;
+                    while (pushed < count)
+                    {
+                        const size_t n = queue.TryPushBatch(values.data() + pushed, count - pushed);
+                        if (n == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                        pushed += n;
+                    }
+                    index += count;
+                }
+            });
+        }
+        for (size_t i = 0; i < consumerCount; ++i)
+        {
+            threads.emplace_back([&]() {
+                std::vector<uint64_t> values(batchSize);
+                uint64_t localSum = 0;
+                while (consumedCount.load(std::memory_order_relaxed) < ItemCount)
+                {
+                    size_t n = 0;
+                    if (batchSize == 1)
+                    {
+                        n = queue.TryPop(values[0]) ? 1 : 0;
+                    }
+                    else
+                    {
+                        n = queue.TryPopBatch(values.data(), batchSize);
+                    }
+                    if (n == 0)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (size_t j = 0; j < n; ++j)
+                    {
+                        localSum += values[j];
+                    }
+                    consumedCount.fetch_add(n, std::memory_order_relaxed);
+                }
+                sum.fetch_add(localSum, std::memory_order_relaxed);
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        if (sum.load() != uint64_t(ItemCount) * (ItemCount - 1) / 2)
+        {
+            state.SkipWithError("Items lost or duplicated");
+            break;
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * ItemCount));
+}
+
+static void ThroughputArgs(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({ "producers", "consumers", "batch" });
+    for (int64_t batchSize : { 1, 32 })
+    {
+        for (auto [producerCount, consumerCount] : { std::pair(1, 1), std::pair(2, 2), std::pair(4, 4),
+            std::pair(8, 8), std::pair(1, 8), std::pair(8, 1) })
+        {
+            benchmark->Args({ producerCount, consumerCount, batchSize });
+        }
+    }
+}
+
+static void SpscThroughputArgs(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({ "producers", "consumers", "batch" });
+    benchmark->Args({ 1, 1, 1 });
+    benchmark->Args({ 1, 1, 32 });
+}
+
+BENCHMARK(BM_Throughput<rad::SpscQueue<uint64_t>>)->Apply(SpscThroughputArgs)->UseRealTime();
+BENCHMARK(BM_Throughput<rad::MpmcQueue<uint64_t>>)->Apply(ThroughputArgs)->UseRealTime();
+BENCHMARK(BM_Throughput<MutexQueue<uint64_t>>)->Apply(ThroughputArgs)->UseRealTime();
+
+// Round trip of one item: the benchmark thread pushes to the echo thread, which pushes it back.
+template<class Queue>
+static void BM_RoundTrip(benchmark::State& state)
+{
+    Queue requests(QueueCapacity);
+    Queue responses(QueueCapacity);
+    std::thread echo([&]() {
+        for (uint64_t value = 0; value != UINT64_MAX;)
+        {
+            value = Pop(requests);
+            Push(responses, value);
+        }
+    });
+    uint64_t value = 0;
+    for (auto _ : state)
+    {
+        Push(requests, value);
+        benchmark::DoNotOptimize(Pop(responses));
+        ++value;
+    }
+    Push(requests, UINT64_MAX);
+    Pop(responses);
+    echo.join();
+}
+
+BENCHMARK(BM_RoundTrip<rad::SpscQueue<uint64_t>>)->UseRealTime();
+BENCHMARK(BM_RoundTrip<rad::MpmcQueue<uint64_t>>)->UseRealTime();
+BENCHMARK(BM_RoundTrip<MutexQueue<uint64_t>>)->UseRealTime();
@@ -0,0 +1,139 @@
+#include <benchmark/benchmark.h>
+#include <rad/Container/FlatHashMap.h>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#if __has_include(<boost/unordered/unordered_flat_map.hpp>)
+#include <boost/unordered/unordered_flat_map.hpp>
+#define RAD_BENCH_BOOST_FLAT_MAP 1
+#endif
+
+// Distinct random keys; the strings are longer than the SSO buffer of the common implementations.
+template<class K>
+static std::vector<K> MakeKeys(size_t count, uint64_t seed)
+{
+    std::mt19937_64 random(seed);
+    std::vector<K> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        // The index makes the keys distinct, and the seed keeps the hits and misses apart.
+        const uint64_t value = (random() << 24) ^ (i << 1) ^ (seed & 1);
+        if constexpr (std::is_same_v<K, std::string>)
+        {
+            keys.push_back("benchmark-key-" + std::to_string(value));
+        }
+        else
+        {
+            keys.push_back(K(value));
+        }
+    }
+    return keys;
+}
+
+template<class Map>
+static Map MakeMap(const std::vector<typename Map::key_type>& keys)
+{
+    Map map;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        map.try_emplace(keys[i], uint64_t(i));
+    }
+    return map;
+}
+
+template<class Map>
+static void BM_Insert(benchmark::State& state)
+{
+    const auto keys = MakeKeys<typename Map::key_type>(size_t(state.range(0)), 0);
+    for (auto _ : state)
+    {
+        Map map;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            map.try_emplace(keys[i], uint64_t(i));
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<class Map>
+static void BM_FindHit(benchmark::State& state)
+{
+    const auto keys = MakeKeys<typename Map::key_type>(size_t(state.range(0)), 0);
+    const Map map = MakeMap<Map>(keys);
+    for (auto _ : state)
+    {
+        uint64_t sum = 0;
+        for (const auto& key : keys)
+        {
+            sum += map.find(key)->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<class Map>
+static void BM_FindMiss(benchmark::State& state)
+{
+    const Map map = MakeMap<Map>(MakeKeys<typename Map::key_type>(size_t(state.range(0)), 0));
+    const auto missingKeys = MakeKeys<typename Map::key_type>(size_t(state.range(0)), 1);
+    for (auto _ : state)
+    {
+        size_t count = 0;
+        for (const auto& key : missingKeys)
+        {
+            count += (map.find(key) != map.end());
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<class Map>
+static void BM_Erase(benchmark::State& state)
+{
+    const auto keys = MakeKeys<typename Map::key_type>(size_t(state.range(0)), 0);
+    const Map source = MakeMap<Map>(keys);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Map map = source;
+        state.ResumeTiming();
+        for (const auto& key : keys)
+        {
+            map.erase(key);
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+using RadIntMap = rad::FlatHashMap<uint64_t, uint64_t>;
+using StdIntMap = std::unordered_map<uint64_t, uint64_t>;
+using RadStringMap = rad::FlatHashMap<std::string, uint64_t>;
+using StdStringMap = std::unordered_map<std::string, uint64_t>;
+#if defined(RAD_BENCH_BOOST_FLAT_MAP)
+using BoostIntMap = boost::unordered_flat_map<uint64_t, uint64_t>;
+using BoostStringMap = boost::unordered_flat_map<std::string, uint64_t>;
+#endif
+
+#define RAD_BENCH_MAP(Map) \
+    BENCHMARK(BM_Insert<Map>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20); \
+    BENCHMARK(BM_FindHit<Map>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20); \
+    BENCHMARK(BM_FindMiss<Map>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20); \
+    BENCHMARK(BM_Erase<Map>)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)
+
+RAD_BENCH_MAP(RadIntMap);
+RAD_BENCH_MAP(StdIntMap);
+RAD_BENCH_MAP(RadStringMap);
+RAD_BENCH_MAP(StdStringMap);
+#if defined(RAD_BENCH_BOOST_FLAT_MAP)
+RAD_BENCH_MAP(BoostIntMap);
+RAD_BENCH_MAP(BoostStringMap);
+#endif
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <rad/Container/SmallVector.h>
+#include <boost/container/small_vector.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+inline constexpr std::size_t InlineCapacity = 16;
+
+// int is trivially copyable, std::unique_ptr is trivially relocatable (moved by memcpy on growth),
+// and std::string is not (the SSO buffer is referenced from inside the object in libstdc++);
+// the values don't allocate, to measure the container only.
+template<class T>
+static T MakeValue(int64_t i)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        return std::string(1, char('a' + i % 26));
+    }
+    else if constexpr (std::is_same_v<T, std::unique_ptr<int>>)
+    {
+        return nullptr;
+    }
+    else
+    {
+        return T(i);
+    }
+}
+
+// push_back range(0) elements into an empty vector: within the inline capacity up to InlineCapacity,
+// beyond it relocates to the heap.
+template<class Vector>
+static void BM_PushBack(benchmark::State& state)
+{
+    using T = typename Vector::value_type;
+    const int64_t count = state.range(0);
+    for (auto _ : state)
+    {
+        Vector vec;
+        for (int64_t i = 0; i < count; ++i)
+        {
+            vec.push_back(MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(vec.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+
+template<class T>
+using RadVector = rad::SmallVector<T, InlineCapacity>;
+template<class T>
+using BoostVector = boost::container::small_vector<T, InlineCapacity>;
+
+#define RAD_BENCH_SMALL_VECTOR(Vector) \
+    BENCHMARK(BM_PushBack<Vector>)->Arg(8)->Arg(InlineCapacity)->Arg(64)->Arg(1024)
+
+RAD_BENCH_SMALL_VECTOR(RadVector<int>);
+RAD_BENCH_SMALL_VECTOR(BoostVector<int>);
+RAD_BENCH_SMALL_VECTOR(RadVector<std::unique_ptr<int>>);
+RAD_BENCH_SMALL_VECTOR(BoostVector<std::unique_ptr<int>>);
+RAD_BENCH_SMALL_VECTOR(RadVector<std::string>);
+RAD_BENCH_SMALL_VECTOR(BoostVector<std::string>);
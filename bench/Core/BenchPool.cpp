@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+#include <rad/Core/Memory.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template<std::size_t Size>
+struct alignas(16) Bytes
+{
+    std::byte data[Size];
+};
+
+struct PoolPolicy
+{
+    template<std::size_t Size>
+    static void* Allocate() { return rad::PoolAlloc(Size); }
+    template<std::size_t Size>
+    static void Free(void* p) { rad::PoolFree(p, Size); }
+};
+
+struct MallocPolicy
+{
+    template<std::size_t Size>
+    static void* Allocate() { return std::malloc(Size); }
+    template<std::size_t Size>
+    static void Free(void* p) { std::free(p); }
+};
+
+template<template<class> class Allocator>
+struct AllocatorPolicy
+{
+    template<std::size_t Size>
+    static void* Allocate() { return Allocator<Bytes<Size>>().allocate(1); }
+    template<std::size_t Size>
+    static void Free(void* p) { Allocator<Bytes<Size>>().deallocate(static_cast<Bytes<Size>*>(p), 1); }
+};
+
+using PoolAllocatorPolicy = AllocatorPolicy<rad::PoolAllocator>;
+using StdAllocatorPolicy = AllocatorPolicy<std::allocator>;
+
+inline constexpr std::size_t BatchSize = 256;
+
+// Allocate a batch of blocks and free them on the same thread.
+template<class Policy, std::size_t Size>
+static void BM_LocalChurn(benchmark::State& state)
+{
+    std::vector<void*> blocks(BatchSize);
+    for (auto _ : state)
+    {
+        for (void*& p : blocks)
+        {
+            p = Policy::template Allocate<Size>();
+        }
+        benchmark::DoNotOptimize(blocks.data());
+        for (void* p : blocks)
+        {
+            Policy::template Free<Size>(p);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * BatchSize));
+}
+
+// Each thread allocates a batch and hands it over to the previous thread, which frees it
+// (the producer/consumer pattern: the blocks are freed by another thread than the allocating one).
+template<class Policy, std::size_t Size>
+static void BM_CrossThreadChurn(benchmark::State& state)
+{
+    static std::atomic<std::vector<void*>*> s_mailboxes[64];
+    const int threadIndex = state.thread_index();
+    const int threadCount = state.threads();
+    std::atomic<std::vector<void*>*>& outbox = s_mailboxes[threadIndex];
+    std::atomic<std::vector<void*>*>& inbox = s_mailboxes[(threadIndex + 1) % threadCount];
+    // Recycle the emptied batches, to keep their allocations out of the measurement.
+    std::vector<void*>* spare = nullptr;
+    auto freeBatch = [&](std::vector<void*>* blocks) {
+        for (void* p : *blocks)
+        {
+            Policy::template Free<Size>(p);
+        }
+        if (spare == nullptr)
+        {
+            spare = blocks;
+        }
+        else
+        {
+            delete blocks;
+        }
+    };
+    for (auto _ : state)
+    {
+        std::vector<void*>* batch = spare ? std::exchange(spare, nullptr) : new std::vector<void*>(BatchSize);
+        for (void*& p : *batch)
+        {
+            p = Policy::template Allocate<Size>();
+        }
+        // Take the previous batch back if not consumed yet.
+        if (std::vector<void*>* unconsumed = outbox.exchange(batch, std::memory_order_acq_rel))
+        {
+            freeBatch(unconsumed);
+        }
+        if (std::vector<void*>* received = inbox.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            freeBatch(received);
+        }
+    }
+    // Nobody else publishes to the outbox.
+    if (std::vector<void*>* unconsumed = outbox.exchange(nullptr, std::memory_order_acq_rel))
+    {
+        freeBatch(unconsumed);
+    }
+    delete spare;
+    state.SetItemsProcessed(int64_t(state.iterations() * BatchSize));
+}
+
+#define RAD_BENCH_POOL(Policy, Size) \
+    BENCHMARK(BM_LocalChurn<Policy, Size>)->ThreadRange(1, 8)->UseRealTime(); \
+    BENCHMARK(BM_CrossThreadChurn<Policy, Size>)->ThreadRange(1, 8)->UseRealTime()
+
+RAD_BENCH_POOL(PoolPolicy, 16);
+RAD_BENCH_POOL(MallocPolicy, 16);
+RAD_BENCH_POOL(PoolPolicy, 64);
+RAD_BENCH_POOL(MallocPolicy, 64);
+RAD_BENCH_POOL(PoolPolicy, 256);
+RAD_BENCH_POOL(MallocPolicy, 256);
+RAD_BENCH_POOL(PoolAllocatorPolicy, 48);
+RAD_BENCH_POOL(StdAllocatorPolicy, 48);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <rad/Core/RefCounted.h>
+#include <rad/Core/Memory.h>
+#include <thread>
+
+template<class Counter>
+class Object : public rad::RefCounted<Object<Counter>, Counter>
+{
+};
+
+// Copy and release a Ref on the thread which creates the object (the owner of the biased counter).
+template<class Counter>
+static void BM_RefCopy(benchmark::State& state)
+{
+    rad::Ref<Object<Counter>> ref = RAD_NEW Object<Counter>();
+    for (auto _ : state)
+    {
+        rad::Ref<Object<Counter>> copy = ref;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+BENCHMARK(BM_RefCopy<rad::RefCounterAtomic>);
+BENCHMARK(BM_RefCopy<rad::RefCounterNonAtomic>);
+BENCHMARK(BM_RefCopy<rad::RefCounterThreadBiased>);
+
+// Copy and release a Ref of the object created on another thread (the shared counter of the biased counter).
+template<class Counter>
+static void BM_RefCopyNonOwner(benchmark::State& state)
+{
+    rad::Ref<Object<Counter>> ref;
+    std::thread([&]() { ref = RAD_NEW Object<Counter>(); }).join();
+    for (auto _ : state)
+    {
+        rad::Ref<Object<Counter>> copy = ref;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+BENCHMARK(BM_RefCopyNonOwner<rad::RefCounterAtomic>);
+BENCHMARK(BM_RefCopyNonOwner<rad::RefCounterThreadBiased>);
+
+// Copy and release the Refs of an object shared by all benchmark threads.
+template<class Counter>
+static void BM_RefCopyContended(benchmark::State& state)
+{
+    static rad::Ref<Object<Counter>> s_ref;
+    if (state.thread_index() == 0)
+    {
+        s_ref = RAD_NEW Object<Counter>();
+    }
+    for (auto _ : state)
+    {
+        rad::Ref<Object<Counter>> copy = s_ref;
+        benchmark::DoNotOptimize(copy);
+    }
+    if (state.thread_index() == 0)
+    {
+        s_ref.reset();
+        rad::RefCounterThreadBiased::MergeQueued();
+    }
+}
+
+BENCHMARK(BM_RefCopyContended<rad::RefCounterAtomic>)->ThreadRange(1, 8);
+BENCHMARK(BM_RefCopyContended<rad::RefCounterThreadBiased>)->ThreadRange(1, 8);
+
+// Read the object of an AtomicRef shared by all benchmark threads.
+static rad::AtomicRef<Object<rad::RefCounterAtomic>> g_atomicRef(RAD_NEW Object<rad::RefCounterAtomic>());
+
+static void BM_AtomicRefRead(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto guard = g_atomicRef.read();
+        benchmark::DoNotOptimize(guard.get());
+    }
+}
+
+static void BM_AtomicRefLoad(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        rad::Ref<Object<rad::RefCounterAtomic>> ref = g_atomicRef.load();
+        benchmark::DoNotOptimize(ref);
+    }
+}
+
+BENCHMARK(BM_AtomicRefRead)->ThreadRange(1, 8);
+BENCHMARK(BM_AtomicRefLoad)->ThreadRange(1, 8);
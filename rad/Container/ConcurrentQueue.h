@@ -0,0 +1,548 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <rad/Core/Memory.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rad
+{
+
+// Bounded lock-free ring queues for the producer/consumer stages; the capacity is rounded up
+// to a power of two. The indices written by the producers and by the consumers are on separate
+// cache lines to avoid false sharing.
+
+inline constexpr size_t QueueCacheLineSize = 64;
+
+// Single producer single consumer ring, wait-free: each side caches the index of the other side,
+// and reloads it (one cache miss) only when the ring looks full/empty.
+template<class T>
+class SpscQueue
+{
+public:
+    using ValueType = T;
+
+    explicit SpscQueue(size_t capacity) :
+        m_capacity(std::bit_ceil((std::max)(capacity, size_t(2)))),
+        m_mask(m_capacity - 1)
+    {
+        m_slots = static_cast<T*>(AlignedAlloc(m_capacity * sizeof(T),
+            (std::max)(alignof(T), QueueCacheLineSize)));
+        if (m_slots == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~SpscQueue()
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (size_t head = m_head.load(std::memory_order_relaxed); head != tail; ++head)
+        {
+            std::destroy_at(&m_slots[head & m_mask]);
+        }
+        AlignedFree(m_slots);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t GetCapacity() const { return m_capacity; }
+
+    // Approximate if called concurrently.
+    size_t GetSize() const
+    {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    bool IsEmpty() const { return (GetSize() == 0); }
+
+    /// @name Producer
+    /// @{
+
+    // Return false if full, value is not moved.
+    template<class... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == m_capacity)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == m_capacity)
+            {
+                return false;
+            }
+        }
+        std::construct_at(&m_slots[tail & m_mask], std::forward<Args>(args)...);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& value) { return TryEmplace(value); }
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    // Move as many values as possible, publish them at once; return the number pushed.
+    size_t TryPushBatch(T* values, size_t count)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t space = m_capacity - (tail - m_headCache);
+        if (space < count)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            space = m_capacity - (tail - m_headCache);
+        }
+        count = (std::min)(count, space);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::construct_at(&m_slots[(tail + i) & m_mask], std::move(values[i]));
+        }
+        if (count > 0)
+        {
+            m_tail.store(tail + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /// @}
+
+    /// @name Consumer
+    /// @{
+
+    // Return false if empty.
+    bool TryPop(T& value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache)
+            {
+                return false;
+            }
+        }
+        T* slot = &m_slots[head & m_mask];
+        value = std::move(*slot);
+        std::destroy_at(slot);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Move at most maxCount values out, release the slots at once; return the number popped.
+    size_t TryPopBatch(T* values, size_t maxCount)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        size_t count = m_tailCache - head;
+        if (count < maxCount)
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            count = m_tailCache - head;
+        }
+        count = (std::min)(count, maxCount);
+        for (size_t i = 0; i < count; ++i)
+        {
+            T* slot = &m_slots[(head + i) & m_mask];
+            values[i] = std::move(*slot);
+            std::destroy_at(slot);
+        }
+        if (count > 0)
+        {
+            m_head.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /// @}
+
+private:
+    // Read-only after construction.
+    T* m_slots = nullptr;
+    size_t m_capacity;
+    size_t m_mask;
+
+    // Written by the producer.
+    alignas(QueueCacheLineSize) std::atomic<size_t> m_tail = 0;
+    size_t m_headCache = 0;
+
+    // Written by the consumer.
+    alignas(QueueCacheLineSize) std::atomic<size_t> m_head = 0;
+    size_t m_tailCache = 0;
+
+}; // class SpscQueue
+
+// Multiple producers multiple consumers ring (Dmitry Vyukov's bounded MPMC queue):
+// each cell has a sequence number telling whether it is ready for the producer or the consumer
+// of the current round; a position is claimed with a CAS, no locks and no ABA.
+template<class T>
+class MpmcQueue
+{
+public:
+    using ValueType = T;
+
+    explicit MpmcQueue(size_t capacity) :
+        m_capacity(std::bit_ceil((std::max)(capacity, size_t(2)))),
+        m_mask(m_capacity - 1)
+    {
+        m_cells = static_cast<Cell*>(AlignedAlloc(m_capacity * sizeof(Cell),
+            (std::max)(alignof(Cell), QueueCacheLineSize)));
+        if (m_cells == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        for (size_t i = 0; i < m_capacity; ++i)
+        {
+            std::construct_at(&m_cells[i].sequence, i);
+        }
+    }
+
+    ~MpmcQueue()
+    {
+        const size_t enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (size_t pos = m_dequeuePos.load(std::memory_order_relaxed); pos != enqueuePos; ++pos)
+        {
+            std::destroy_at(m_cells[pos & m_mask].GetValue());
+        }
+        AlignedFree(m_cells);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    size_t GetCapacity() const { return m_capacity; }
+
+    // Approximate if called concurrently.
+    size_t GetSize() const
+    {
+        const size_t dequeuePos = m_dequeuePos.load(std::memory_order_acquire);
+        const size_t enqueuePos = m_enqueuePos.load(std::memory_order_acquire);
+        return (enqueuePos > dequeuePos) ? (enqueuePos - dequeuePos) : 0;
+    }
+
+    bool IsEmpty() const { return (GetSize() == 0); }
+
+    // Return false if full, value is not moved.
+    template<class... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence - pos);
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The consumer of the previous round hasn't finished.
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        std::construct_at(cell->GetValue(), std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& value) { return TryEmplace(value); }
+    bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+    // Claim the consecutive free cells with a single CAS; return the number pushed.
+    size_t TryPushBatch(T* values, size_t count)
+    {
+        if (count == 0)
+        {
+            // Would retry forever: nothing is claimed even if the cell is free.
+            return 0;
+        }
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t claimed = 0;
+        while (true)
+        {
+            claimed = 0;
+            while ((claimed < count) &&
+                (m_cells[(pos + claimed) & m_mask].sequence.load(std::memory_order_acquire) == pos + claimed))
+            {
+                ++claimed;
+            }
+            if (claimed == 0)
+            {
+                const size_t sequence = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<ptrdiff_t>(sequence - pos) < 0)
+                {
+                    return 0;
+                }
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            // The free cells stay free until claimed, which fails if pos is stale.
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        for (size_t i = 0; i < claimed; ++i)
+        {
+            Cell* cell = &m_cells[(pos + i) & m_mask];
+            std::construct_at(cell->GetValue(), std::move(values[i]));
+            cell->sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    // Return false if empty.
+    bool TryPop(T& value)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const ptrdiff_t diff = static_cast<ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The producer of the current round hasn't finished.
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        T* p = cell->GetValue();
+        value = std::move(*p);
+        std::destroy_at(p);
+        cell->sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Claim the consecutive ready cells with a single CAS; return the number popped.
+    size_t TryPopBatch(T* values, size_t maxCount)
+    {
+        if (maxCount == 0)
+        {
+            return 0;
+        }
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        size_t claimed = 0;
+        while (true)
+        {
+            claimed = 0;
+            while ((claimed < maxCount) &&
+                (m_cells[(pos + claimed) & m_mask].sequence.load(std::memory_order_acquire) == pos + claimed + 1))
+            {
+                ++claimed;
+            }
+            if (claimed == 0)
+            {
+                const size_t sequence = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<ptrdiff_t>(sequence - (pos + 1)) < 0)
+                {
+                    return 0;
+                }
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        for (size_t i = 0; i < claimed; ++i)
+        {
+            Cell* cell = &m_cells[(pos + i) & m_mask];
+            T* p = cell->GetValue();
+            values[i] = std::move(*p);
+            std::destroy_at(p);
+            cell->sequence.store(pos + i + m_capacity, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+        T* GetValue() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    // Read-only after construction.
+    Cell* m_cells = nullptr;
+    size_t m_capacity;
+    size_t m_mask;
+
+    alignas(QueueCacheLineSize) std::atomic<size_t> m_enqueuePos = 0;
+    alignas(QueueCacheLineSize) std::atomic<size_t> m_dequeuePos = 0;
+
+}; // class MpmcQueue
+
+// Blocking wrapper of SpscQueue/MpmcQueue: the waiting threads sleep on std::atomic::wait;
+// the other side notifies only if someone is waiting, the fast path has no extra atomic writes.
+template<class Queue>
+class BlockingQueue
+{
+public:
+    using ValueType = typename Queue::ValueType;
+
+    explicit BlockingQueue(size_t capacity) :
+        m_queue(capacity)
+    {
+    }
+
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    size_t GetCapacity() const { return m_queue.GetCapacity(); }
+    size_t GetSize() const { return m_queue.GetSize(); }
+    bool IsEmpty() const { return m_queue.IsEmpty(); }
+
+    bool TryPush(ValueType&& value)
+    {
+        if (m_queue.TryPush(std::move(value)))
+        {
+            Notify(m_pushEvent);
+            return true;
+        }
+        return false;
+    }
+
+    bool TryPop(ValueType& value)
+    {
+        if (m_queue.TryPop(value))
+        {
+            Notify(m_popEvent);
+            return true;
+        }
+        return false;
+    }
+
+    // Wait while full.
+    void Push(ValueType value)
+    {
+        Wait(m_popEvent, [&]() { return m_queue.TryPush(std::move(value)); });
+        Notify(m_pushEvent);
+    }
+
+    // Wait while empty; ValueType must be default constructible.
+    ValueType Pop()
+    {
+        ValueType value;
+        Wait(m_pushEvent, [&]() { return m_queue.TryPop(value); });
+        Notify(m_popEvent);
+        return value;
+    }
+
+    // Wait until all values are pushed.
+    void PushBatch(ValueType* values, size_t count)
+    {
+        while (count > 0)
+        {
+            size_t pushed = 0;
+            Wait(m_popEvent, [&]() { pushed = m_queue.TryPushBatch(values, count); return (pushed > 0); });
+            Notify(m_pushEvent);
+            values += pushed;
+            count -= pushed;
+        }
+    }
+
+    // Wait until at least one value is popped (unless maxCount is 0); return the number popped.
+    size_t PopBatch(ValueType* values, size_t maxCount)
+    {
+        if (maxCount == 0)
+        {
+            return 0;
+        }
+        size_t popped = 0;
+        Wait(m_pushEvent, [&]() { popped = m_queue.TryPopBatch(values, maxCount); return (popped > 0); });
+        Notify(m_popEvent);
+        return popped;
+    }
+
+private:
+    // The event counter is incremented only when there are waiters.
+    struct alignas(QueueCacheLineSize) Event
+    {
+        std::atomic<uint32_t> counter = 0;
+        std::atomic<uint32_t> waiterCount = 0;
+    };
+
+    static void Notify(Event& event)
+    {
+        // Order the queue operation before loading waiterCount; pairs with the fence in Wait.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (event.waiterCount.load(std::memory_order_relaxed) > 0)
+        {
+            event.counter.fetch_add(1, std::memory_order_release);
+            event.counter.notify_all();
+        }
+    }
+
+    template<class TryOp>
+    static void Wait(Event& event, TryOp&& tryOp)
+    {
+        static constexpr int SpinCount = 64;
+        for (int i = 0; i < SpinCount; ++i)
+        {
+            if (tryOp())
+            {
+                return;
+            }
+        }
+        while (true)
+        {
+            event.waiterCount.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const uint32_t counter = event.counter.load(std::memory_order_acquire);
+            // Retry after registered as a waiter: either see the other side's operation,
+            // or the other side sees the waiter and bumps the counter.
+            if (tryOp())
+            {
+                event.waiterCount.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            event.counter.wait(counter, std::memory_order_acquire);
+            event.waiterCount.fetch_sub(1, std::memory_order_relaxed);
+            if (tryOp())
+            {
+                return;
+            }
+        }
+    }
+
+    Queue m_queue;
+    Event m_pushEvent;
+    Event m_popEvent;
+
+}; // class BlockingQueue
+
+template<class T>
+using BlockingSpscQueue = BlockingQueue<SpscQueue<T>>;
+template<class T>
+using BlockingMpmcQueue = BlockingQueue<MpmcQueue<T>>;
+
+} // namespace rad
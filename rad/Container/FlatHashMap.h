@@ -0,0 +1,1046 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <rad/Core/Hash.h>
+#include <rad/Core/Memory.h>
+#include <rad/Core/TypeTraits.h>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(RAD_ARCH_X86) && RAD_COMPILED_X86_SSE2
+#define RAD_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace rad
+{
+
+// Open-addressing hash table with the Swiss table layout (as absl::flat_hash_map):
+// each slot has a control byte, which is empty, deleted (tombstone), or the 7 low bits (H2) of the hash;
+// the probing compares the control bytes of a group of slots (16 with SSE2, 8 with SWAR) at once,
+// and only the slots matching H2 are compared by keys. The capacity is 2^n-1, with a sentinel control byte
+// at the end for iteration, and the first group cloned after the sentinel for unaligned group loads.
+// Elements are stored inline: insertion may rehash, which invalidates the iterators and references;
+// e.g. m[k] = m[j] can read from a moved element if m[k] grows the table, copy m[j] first.
+
+using FlatHashCtrl = int8_t;
+inline constexpr FlatHashCtrl FlatHashCtrlEmpty = -128;
+inline constexpr FlatHashCtrl FlatHashCtrlDeleted = -2;
+inline constexpr FlatHashCtrl FlatHashCtrlSentinel = -1;
+
+// Bit mask of the slots in a group matching a condition; Shift is log2 of the bits per slot.
+template<class T, int Shift>
+class FlatHashBitMask
+{
+public:
+    explicit FlatHashBitMask(T mask) : m_mask(mask) {}
+
+    explicit operator bool() const { return (m_mask != 0); }
+    uint32_t LowestBitSet() const { return static_cast<uint32_t>(std::countr_zero(m_mask)) >> Shift; }
+    uint32_t TrailingZeros() const { return static_cast<uint32_t>(std::countr_zero(m_mask)) >> Shift; }
+    uint32_t LeadingZeros() const { return static_cast<uint32_t>(std::countl_zero(m_mask)) >> Shift; }
+
+    // Iterate the indices of the slots matched.
+    FlatHashBitMask begin() const { return *this; }
+    FlatHashBitMask end() const { return FlatHashBitMask(0); }
+    uint32_t operator*() const { return LowestBitSet(); }
+    FlatHashBitMask& operator++()
+    {
+        m_mask &= (m_mask - 1);
+        return *this;
+    }
+    bool operator!=(const FlatHashBitMask& other) const { return (m_mask != other.m_mask); }
+
+private:
+    T m_mask;
+
+}; // class FlatHashBitMask
+
+#if defined(RAD_FLAT_HASH_SSE2)
+class FlatHashGroup
+{
+public:
+    static constexpr size_t Width = 16;
+    using BitMask = FlatHashBitMask<uint16_t, 0>;
+
+    explicit FlatHashGroup(const FlatHashCtrl* ctrl) :
+        m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+    {
+    }
+
+    BitMask Match(FlatHashCtrl h2) const
+    {
+        return BitMask(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl))));
+    }
+
+    BitMask MatchEmpty() const
+    {
+        return Match(FlatHashCtrlEmpty);
+    }
+
+    BitMask MatchEmptyOrDeleted() const
+    {
+        return BitMask(static_cast<uint16_t>(
+            _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(FlatHashCtrlSentinel), m_ctrl))));
+    }
+
+    uint32_t CountLeadingEmptyOrDeleted() const
+    {
+        const uint32_t mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(FlatHashCtrlSentinel), m_ctrl)));
+        return static_cast<uint32_t>(std::countr_zero(mask + 1));
+    }
+
+private:
+    __m128i m_ctrl;
+
+}; // class FlatHashGroup
+#else
+// Portable implementation with 64-bit SWAR, the high bit of each byte is set for the slots matched.
+class FlatHashGroup
+{
+public:
+    static constexpr size_t Width = 8;
+    using BitMask = FlatHashBitMask<uint64_t, 3>;
+
+    explicit FlatHashGroup(const FlatHashCtrl* ctrl)
+    {
+        std::memcpy(&m_ctrl, ctrl, sizeof(m_ctrl));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        m_ctrl = __builtin_bswap64(m_ctrl);
+#endif
+    }
+
+    // May have false positives (only if a byte before matches), the keys are compared anyway.
+    BitMask Match(FlatHashCtrl h2) const
+    {
+        const uint64_t x = m_ctrl ^ (Lsbs * static_cast<uint8_t>(h2));
+        return BitMask((x - Lsbs) & ~x & Msbs);
+    }
+
+    BitMask MatchEmpty() const
+    {
+        return BitMask((m_ctrl & ~(m_ctrl << 6)) & Msbs);
+    }
+
+    BitMask MatchEmptyOrDeleted() const
+    {
+        return BitMask((m_ctrl & ~(m_ctrl << 7)) & Msbs);
+    }
+
+    uint32_t CountLeadingEmptyOrDeleted() const
+    {
+        constexpr uint64_t gaps = 0x00FEFEFEFEFEFEFEull;
+        return static_cast<uint32_t>((std::countr_zero(((~m_ctrl & (m_ctrl >> 7)) | gaps) + 1) + 7) >> 3);
+    }
+
+private:
+    static constexpr uint64_t Msbs = 0x8080808080808080ull;
+    static constexpr uint64_t Lsbs = 0x0101010101010101ull;
+    uint64_t m_ctrl;
+
+}; // class FlatHashGroup
+#endif
+
+// The control bytes of the tables without storage: find and iteration work without checking the capacity.
+alignas(16) inline constexpr FlatHashCtrl FlatHashEmptyGroup[16] =
+{
+    FlatHashCtrlSentinel, FlatHashCtrlEmpty, FlatHashCtrlEmpty, FlatHashCtrlEmpty,
+    FlatHashCtrlEmpty, FlatHashCtrlEmpty, FlatHashCtrlEmpty, FlatHashCtrlEmpty,
+    FlatHashCtrlEmpty, FlatHashCtrlEmpty, FlatHashCtrlEmpty, FlatHashCtrlEmpty,
+    FlatHashCtrlEmpty, FlatHashCtrlEmpty, FlatHashCtrlEmpty, FlatHashCtrlEmpty,
+};
+
+// The common implementation of FlatHashMap and FlatHashSet, the Policy defines the element type:
+// key_type, value_type, GetKey(value), and Transfer(dst, src) to relocate an element.
+template<class Policy, class Hash, class KeyEqual>
+class FlatHashTable
+{
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+    // Heterogeneous lookup, if both Hash and KeyEqual are transparent (e.g. StringHash and StringEqual).
+    static constexpr bool IsTransparent =
+        requires { typename Hash::is_transparent; typename KeyEqual::is_transparent; };
+
+    template<bool IsConst>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Policy::value_type;
+        using difference_type = ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+        Iterator() = default;
+
+        template<bool OtherIsConst>
+            requires (IsConst && !OtherIsConst)
+        Iterator(const Iterator<OtherIsConst>& other) :
+            m_ctrl(other.m_ctrl), m_slot(other.m_slot)
+        {
+        }
+
+        reference operator*() const { return *m_slot; }
+        pointer operator->() const { return m_slot; }
+
+        Iterator& operator++()
+        {
+            ++m_ctrl;
+            ++m_slot;
+            SkipEmptyOrDeleted();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator iter = *this;
+            ++*this;
+            return iter;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return (lhs.m_ctrl == rhs.m_ctrl);
+        }
+
+    private:
+        friend class FlatHashTable;
+        template<bool> friend class Iterator;
+
+        Iterator(const FlatHashCtrl* ctrl, value_type* slot) :
+            m_ctrl(ctrl), m_slot(slot)
+        {
+            SkipEmptyOrDeleted();
+        }
+
+        // Stop at the next full slot, or at the sentinel (end).
+        void SkipEmptyOrDeleted()
+        {
+            while (*m_ctrl < FlatHashCtrlSentinel)
+            {
+                const uint32_t shift = FlatHashGroup(m_ctrl).CountLeadingEmptyOrDeleted();
+                m_ctrl += shift;
+                m_slot += shift;
+            }
+            if (*m_ctrl == FlatHashCtrlSentinel)
+            {
+                m_ctrl = nullptr;
+                m_slot = nullptr;
+            }
+        }
+
+        // nullptr for end.
+        const FlatHashCtrl* m_ctrl = nullptr;
+        value_type* m_slot = nullptr;
+
+    }; // class Iterator
+
+    using iterator = Iterator<Policy::IsConstIterator>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashTable() noexcept = default;
+
+    explicit FlatHashTable(size_type capacity, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+        m_hash(hash), m_equal(equal)
+    {
+        reserve(capacity);
+    }
+
+    FlatHashTable(const FlatHashTable& other) :
+        m_hash(other.m_hash), m_equal(other.m_equal)
+    {
+        CopyFrom(other);
+    }
+
+    FlatHashTable(FlatHashTable&& other) noexcept :
+        m_ctrl(other.m_ctrl),
+        m_slots(other.m_slots),
+        m_size(other.m_size),
+        m_capacity(other.m_capacity),
+        m_growthLeft(other.m_growthLeft),
+        m_hash(std::move(other.m_hash)),
+        m_equal(std::move(other.m_equal))
+    {
+        other.m_ctrl = const_cast<FlatHashCtrl*>(FlatHashEmptyGroup);
+        other.m_slots = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+        other.m_growthLeft = 0;
+    }
+
+    ~FlatHashTable()
+    {
+        DestroySlots();
+        Deallocate(m_ctrl, m_capacity);
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& other)
+    {
+        if (this != &other)
+        {
+            FlatHashTable(other).swap(*this);
+        }
+        return *this;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& other) noexcept
+    {
+        if (this != &other)
+        {
+            FlatHashTable(std::move(other)).swap(*this);
+        }
+        return *this;
+    }
+
+    /// @name Iterators
+    /// @{
+    iterator begin() { return iterator(m_ctrl, m_slots); }
+    const_iterator begin() const { return const_iterator(m_ctrl, m_slots); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cend() const { return end(); }
+    /// @}
+
+    /// @name Capacity
+    /// @{
+    bool empty() const noexcept { return (m_size == 0); }
+    size_type size() const noexcept { return m_size; }
+    // The number of slots.
+    size_type capacity() const noexcept { return m_capacity; }
+    size_type bucket_count() const noexcept { return m_capacity; }
+    float load_factor() const noexcept { return m_capacity ? float(m_size) / float(m_capacity) : 0.0f; }
+    float max_load_factor() const noexcept { return 7.0f / 8.0f; }
+
+    // Make room for count elements without rehashing.
+    void reserve(size_type count)
+    {
+        if (count > m_size + m_growthLeft)
+        {
+            Resize(NormalizeCapacity(GrowthToLowerboundCapacity(count)));
+        }
+    }
+
+    // Rehash to the capacity for at least count elements (and the current elements),
+    // also drops the tombstones; rehash(0) shrinks to fit.
+    void rehash(size_type count)
+    {
+        if ((count == 0) && (m_size == 0))
+        {
+            DestroySlots();
+            Deallocate(m_ctrl, m_capacity);
+            m_ctrl = const_cast<FlatHashCtrl*>(FlatHashEmptyGroup);
+            m_slots = nullptr;
+            m_capacity = 0;
+            m_growthLeft = 0;
+            return;
+        }
+        const size_type capacity = NormalizeCapacity((std::max)(count, GrowthToLowerboundCapacity(m_size)));
+        if ((count == 0) || (capacity > m_capacity))
+        {
+            Resize(capacity);
+        }
+    }
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+    // Keep the capacity.
+    void clear() noexcept
+    {
+        DestroySlots();
+        m_size = 0;
+        if (m_capacity > 0)
+        {
+            ResetCtrl();
+        }
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return MakeResult(FindOrInsert(Policy::GetKey(value),
+            [&](value_type* slot) { std::construct_at(slot, value); }));
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return MakeResult(FindOrInsert(Policy::GetKey(value),
+            [&](value_type* slot) { std::construct_at(slot, std::move(value)); }));
+    }
+
+    template<std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            emplace(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> list)
+    {
+        insert(list.begin(), list.end());
+    }
+
+    // Construct the element to get the key, destroyed if the key exists.
+    template<class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        alignas(value_type) std::byte buffer[sizeof(value_type)];
+        value_type* temp = std::construct_at(reinterpret_cast<value_type*>(buffer), std::forward<Args>(args)...);
+        bool transferred = false;
+        try
+        {
+            auto result = FindOrInsert(Policy::GetKey(*temp),
+                [&](value_type* slot) { Policy::Transfer(slot, temp); transferred = true; });
+            if (!transferred)
+            {
+                std::destroy_at(temp);
+            }
+            return MakeResult(result);
+        }
+        catch (...)
+        {
+            if (!transferred)
+            {
+                std::destroy_at(temp);
+            }
+            throw;
+        }
+    }
+
+    // Return the iterator following the erased.
+    iterator erase(const_iterator pos)
+    {
+        assert(pos != end());
+        iterator next(pos.m_ctrl, pos.m_slot);
+        ++next;
+        EraseAt(static_cast<size_type>(pos.m_slot - m_slots));
+        return next;
+    }
+
+    size_type erase(const key_type& key)
+    {
+        return EraseKey(key);
+    }
+
+    template<class K>
+        requires (IsTransparent && !std::is_convertible_v<const K&, const_iterator>)
+    size_type erase(const K& key)
+    {
+        return EraseKey(key);
+    }
+
+    void swap(FlatHashTable& other) noexcept
+    {
+        using std::swap;
+        swap(m_ctrl, other.m_ctrl);
+        swap(m_slots, other.m_slots);
+        swap(m_size, other.m_size);
+        swap(m_capacity, other.m_capacity);
+        swap(m_growthLeft, other.m_growthLeft);
+        swap(m_hash, other.m_hash);
+        swap(m_equal, other.m_equal);
+    }
+    /// @}
+
+    /// @name Lookup
+    /// @{
+    iterator find(const key_type& key) { return FindIterator<iterator>(key); }
+    const_iterator find(const key_type& key) const { return FindIterator<const_iterator>(key); }
+    bool contains(const key_type& key) const { return (FindIndex(key, HashOf(key)) != NotFound); }
+    size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+    template<class K>
+        requires IsTransparent
+    iterator find(const K& key) { return FindIterator<iterator>(key); }
+
+    template<class K>
+        requires IsTransparent
+    const_iterator find(const K& key) const { return FindIterator<const_iterator>(key); }
+
+    template<class K>
+        requires IsTransparent
+    bool contains(const K& key) const { return (FindIndex(key, HashOf(key)) != NotFound); }
+
+    template<class K>
+        requires IsTransparent
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+    /// @}
+
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_equal; }
+
+    friend bool operator==(const FlatHashTable& lhs, const FlatHashTable& rhs)
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+        for (const value_type& value : lhs)
+        {
+            auto iter = rhs.find(Policy::GetKey(value));
+            if ((iter == rhs.end()) || !(*iter == value))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend void swap(FlatHashTable& lhs, FlatHashTable& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+protected:
+    static constexpr size_type NotFound = size_type(-1);
+
+    template<class K>
+    size_type HashOf(const K& key) const
+    {
+        // Mix to use the low bits (H2) and the high bits (H1) of the hashes of poor quality.
+        return static_cast<size_type>(HashMix(static_cast<uint64_t>(m_hash(key))));
+    }
+
+    // Construct the element with construct(slot) if the key doesn't exist; return the slot index,
+    // and whether inserted. The key and the arguments of construct may refer to the elements.
+    template<class K, class Construct>
+    std::pair<size_type, bool> FindOrInsert(const K& key, Construct&& construct)
+    {
+        const size_type hash = HashOf(key);
+        size_type index = FindIndex(key, hash);
+        if (index != NotFound)
+        {
+            return { index, false };
+        }
+        index = FindFirstNonFull(hash);
+        if ((m_growthLeft == 0) && (m_ctrl[index] != FlatHashCtrlDeleted)) [[unlikely]]
+        {
+            // Construct before rehashing, the arguments may refer to the elements.
+            alignas(value_type) std::byte buffer[sizeof(value_type)];
+            value_type* temp = reinterpret_cast<value_type*>(buffer);
+            construct(temp);
+            try
+            {
+                GrowForInsert();
+            }
+            catch (...)
+            {
+                std::destroy_at(temp);
+                throw;
+            }
+            index = FindFirstNonFull(hash);
+            Policy::Transfer(m_slots + index, temp);
+        }
+        else
+        {
+            construct(m_slots + index);
+        }
+        m_growthLeft -= (m_ctrl[index] == FlatHashCtrlEmpty) ? 1 : 0;
+        SetCtrl(index, H2(hash));
+        ++m_size;
+        return { index, true };
+    }
+
+    std::pair<iterator, bool> MakeResult(std::pair<size_type, bool> result)
+    {
+        return { iterator(m_ctrl + result.first, m_slots + result.first), result.second };
+    }
+
+    iterator MakeIterator(size_type index)
+    {
+        return iterator(m_ctrl + index, m_slots + index);
+    }
+
+    template<class K>
+    size_type FindIndex(const K& key, size_type hash) const
+    {
+        Probe probe(hash, m_capacity);
+        while (true)
+        {
+            FlatHashGroup group(m_ctrl + probe.m_offset);
+            for (uint32_t i : group.Match(H2(hash)))
+            {
+                const size_type index = probe.Offset(i);
+                if (m_equal(Policy::GetKey(m_slots[index]), key)) [[likely]]
+                {
+                    return index;
+                }
+            }
+            if (group.MatchEmpty()) [[likely]]
+            {
+                return NotFound;
+            }
+            probe.Next();
+            assert(probe.m_index <= m_capacity);
+        }
+    }
+
+private:
+    static constexpr size_t NumClonedBytes = FlatHashGroup::Width - 1;
+
+    // Triangular probing of the groups, visits all groups when the capacity is 2^n-1.
+    struct Probe
+    {
+        Probe(size_type hash, size_type mask) :
+            m_mask(mask), m_offset(H1(hash) & mask)
+        {
+        }
+
+        size_type Offset(size_type i) const { return (m_offset + i) & m_mask; }
+
+        void Next()
+        {
+            m_index += FlatHashGroup::Width;
+            m_offset = (m_offset + m_index) & m_mask;
+        }
+
+        size_type m_mask;
+        size_type m_offset;
+        size_type m_index = 0;
+    };
+
+    static size_type H1(size_type hash) { return (hash >> 7); }
+    static FlatHashCtrl H2(size_type hash) { return static_cast<FlatHashCtrl>(hash & 0x7F); }
+
+    static size_type NormalizeCapacity(size_type count)
+    {
+        return count ? (~size_type(0) >> std::countl_zero(count)) : 1;
+    }
+
+    // Max load factor 7/8.
+    static size_type CapacityToGrowth(size_type capacity)
+    {
+        if ((FlatHashGroup::Width == 8) && (capacity == 7))
+        {
+            return 6;
+        }
+        return capacity - capacity / 8;
+    }
+
+    static size_type GrowthToLowerboundCapacity(size_type growth)
+    {
+        if ((FlatHashGroup::Width == 8) && (growth == 7))
+        {
+            return 8;
+        }
+        return growth + static_cast<size_type>((static_cast<int64_t>(growth) - 1) / 7);
+    }
+
+    static constexpr size_t SlotAlignment = (std::max)(alignof(value_type), alignof(std::max_align_t));
+
+    static size_type GetSlotOffset(size_type capacity)
+    {
+        return (capacity + FlatHashGroup::Width + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+    }
+
+    static size_type GetAllocSize(size_type capacity)
+    {
+        return GetSlotOffset(capacity) + capacity * sizeof(value_type);
+    }
+
+    static void Deallocate(FlatHashCtrl* ctrl, size_type capacity)
+    {
+        if (capacity > 0)
+        {
+            ::operator delete(ctrl, GetAllocSize(capacity), std::align_val_t(SlotAlignment));
+        }
+    }
+
+    // Set the control byte and its clone after the sentinel.
+    void SetCtrl(size_type index, FlatHashCtrl h)
+    {
+        m_ctrl[index] = h;
+        m_ctrl[((index - NumClonedBytes) & m_capacity) + (NumClonedBytes & m_capacity)] = h;
+    }
+
+    void ResetCtrl()
+    {
+        std::memset(m_ctrl, FlatHashCtrlEmpty, m_capacity + FlatHashGroup::Width);
+        m_ctrl[m_capacity] = FlatHashCtrlSentinel;
+        m_growthLeft = CapacityToGrowth(m_capacity) - m_size;
+    }
+
+    size_type FindFirstNonFull(size_type hash) const
+    {
+        Probe probe(hash, m_capacity);
+        while (true)
+        {
+            auto mask = FlatHashGroup(m_ctrl + probe.m_offset).MatchEmptyOrDeleted();
+            if (mask)
+            {
+                return probe.Offset(mask.LowestBitSet());
+            }
+            probe.Next();
+            assert(probe.m_index <= m_capacity);
+        }
+    }
+
+    void GrowForInsert()
+    {
+        if (m_capacity == 0)
+        {
+            Resize(1);
+        }
+        else if ((m_capacity > FlatHashGroup::Width) && (m_size * 32 <= m_capacity * 25))
+        {
+            // Many tombstones, rehash in the same capacity.
+            Resize(m_capacity);
+        }
+        else
+        {
+            Resize(m_capacity * 2 + 1);
+        }
+    }
+
+    void Resize(size_type capacity)
+    {
+        assert(CapacityToGrowth(capacity) >= m_size);
+        FlatHashCtrl* oldCtrl = m_ctrl;
+        value_type* oldSlots = m_slots;
+        const size_type oldCapacity = m_capacity;
+
+        void* data = ::operator new(GetAllocSize(capacity), std::align_val_t(SlotAlignment));
+        m_ctrl = static_cast<FlatHashCtrl*>(data);
+        m_slots = reinterpret_cast<value_type*>(static_cast<std::byte*>(data) + GetSlotOffset(capacity));
+        m_capacity = capacity;
+        ResetCtrl();
+
+        for (size_type i = 0; i < oldCapacity; ++i)
+        {
+            if (oldCtrl[i] >= 0)
+            {
+                const size_type hash = HashOf(Policy::GetKey(oldSlots[i]));
+                const size_type index = FindFirstNonFull(hash);
+                SetCtrl(index, H2(hash));
+                Policy::Transfer(m_slots + index, oldSlots + i);
+            }
+        }
+        Deallocate(oldCtrl, oldCapacity);
+    }
+
+    void CopyFrom(const FlatHashTable& other)
+    {
+        reserve(other.size());
+        for (const value_type& value : other)
+        {
+            // The keys are unique, no need to compare.
+            const size_type hash = HashOf(Policy::GetKey(value));
+            const size_type index = FindFirstNonFull(hash);
+            std::construct_at(m_slots + index, value);
+            m_growthLeft -= (m_ctrl[index] == FlatHashCtrlEmpty) ? 1 : 0;
+            SetCtrl(index, H2(hash));
+            ++m_size;
+        }
+    }
+
+    void DestroySlots() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>)
+        {
+            if (m_size == 0)
+            {
+                return;
+            }
+            for (size_type i = 0; i < m_capacity; ++i)
+            {
+                if (m_ctrl[i] >= 0)
+                {
+                    std::destroy_at(m_slots + i);
+                }
+            }
+        }
+    }
+
+    void EraseAt(size_type index)
+    {
+        std::destroy_at(m_slots + index);
+        --m_size;
+        // Mark as empty if no probe sequence could have passed the slot when full:
+        // the slot is within a run of less than a group of full or deleted slots.
+        const size_type indexBefore = (index - FlatHashGroup::Width) & m_capacity;
+        const auto emptyAfter = FlatHashGroup(m_ctrl + index).MatchEmpty();
+        const auto emptyBefore = FlatHashGroup(m_ctrl + indexBefore).MatchEmpty();
+        const bool wasNeverFull = emptyBefore && emptyAfter &&
+            (emptyAfter.TrailingZeros() + emptyBefore.LeadingZeros() < FlatHashGroup::Width);
+        SetCtrl(index, wasNeverFull ? FlatHashCtrlEmpty : FlatHashCtrlDeleted);
+        m_growthLeft += wasNeverFull ? 1 : 0;
+    }
+
+    template<class K>
+    size_type EraseKey(const K& key)
+    {
+        const size_type index = FindIndex(key, HashOf(key));
+        if (index == NotFound)
+        {
+            return 0;
+        }
+        EraseAt(index);
+        return 1;
+    }
+
+    template<class Iter, class K>
+    Iter FindIterator(const K& key) const
+    {
+        const size_type index = FindIndex(key, HashOf(key));
+        if (index == NotFound)
+        {
+            return Iter();
+        }
+        return Iter(m_ctrl + index, m_slots + index);
+    }
+
+    FlatHashCtrl* m_ctrl = const_cast<FlatHashCtrl*>(FlatHashEmptyGroup);
+    value_type* m_slots = nullptr;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+    size_type m_growthLeft = 0;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+
+}; // class FlatHashTable
+
+template<class K, class V>
+struct FlatHashMapPolicy
+{
+    using key_type = K;
+    using value_type = std::pair<const K, V>;
+    static constexpr bool IsConstIterator = false;
+
+    static const K& GetKey(const value_type& value) { return value.first; }
+
+    static void Transfer(value_type* dst, value_type* src)
+    {
+        if constexpr (IsTriviallyRelocatableV<K> && IsTriviallyRelocatableV<V>)
+        {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+        }
+        else
+        {
+            // The key is about to be destroyed, move it (as boost::unordered_flat_map).
+            std::construct_at(dst, std::move(const_cast<K&>(src->first)), std::move(src->second));
+            std::destroy_at(src);
+        }
+    }
+};
+
+template<class K>
+struct FlatHashSetPolicy
+{
+    using key_type = K;
+    using value_type = K;
+    static constexpr bool IsConstIterator = true;
+
+    static const K& GetKey(const value_type& value) { return value; }
+
+    static void Transfer(value_type* dst, value_type* src)
+    {
+        RelocateAt(src, dst);
+    }
+};
+
+// Hash map with the elements stored inline (see FlatHashTable), a faster alternative to std::unordered_map,
+// but the references to the elements are not stable.
+template<class K, class V, class Hash = Hasher<K>, class KeyEqual = std::equal_to<>>
+class FlatHashMap : public FlatHashTable<FlatHashMapPolicy<K, V>, Hash, KeyEqual>
+{
+    using Base = FlatHashTable<FlatHashMapPolicy<K, V>, Hash, KeyEqual>;
+
+public:
+    using mapped_type = V;
+    using typename Base::key_type;
+    using typename Base::value_type;
+    using typename Base::size_type;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using Base::Base;
+    using Base::IsTransparent;
+
+    FlatHashMap() = default;
+
+    template<std::input_iterator InputIt>
+    FlatHashMap(InputIt first, InputIt last)
+    {
+        this->insert(first, last);
+    }
+
+    FlatHashMap(std::initializer_list<value_type> list)
+    {
+        this->insert(list.begin(), list.end());
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+    {
+        return TryEmplace(key, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+    {
+        return TryEmplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    // Construct the key from K only if not found (e.g. std::string from std::string_view).
+    template<class KeyArg, class... Args>
+        requires (IsTransparent && !std::is_convertible_v<KeyArg, const key_type&> &&
+            std::is_constructible_v<key_type, KeyArg>)
+    std::pair<iterator, bool> try_emplace(KeyArg&& key, Args&&... args)
+    {
+        return TryEmplace(std::forward<KeyArg>(key), std::forward<Args>(args)...);
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value)
+    {
+        auto result = TryEmplace(key, std::forward<M>(value));
+        if (!result.second)
+        {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& value)
+    {
+        auto result = TryEmplace(std::move(key), std::forward<M>(value));
+        if (!result.second)
+        {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    V& operator[](const key_type& key)
+    {
+        return TryEmplace(key).first->second;
+    }
+
+    V& operator[](key_type&& key)
+    {
+        return TryEmplace(std::move(key)).first->second;
+    }
+
+    template<class KeyArg>
+        requires (IsTransparent && !std::is_convertible_v<KeyArg, const key_type&> &&
+            std::is_constructible_v<key_type, KeyArg>)
+    V& operator[](KeyArg&& key)
+    {
+        return TryEmplace(std::forward<KeyArg>(key)).first->second;
+    }
+
+    V& at(const key_type& key)
+    {
+        return AtImpl(*this, key);
+    }
+
+    const V& at(const key_type& key) const
+    {
+        return AtImpl(*this, key);
+    }
+
+    template<class KeyArg>
+        requires IsTransparent
+    V& at(const KeyArg& key)
+    {
+        return AtImpl(*this, key);
+    }
+
+    template<class KeyArg>
+        requires IsTransparent
+    const V& at(const KeyArg& key) const
+    {
+        return AtImpl(*this, key);
+    }
+
+private:
+    template<class KeyArg, class... Args>
+    std::pair<iterator, bool> TryEmplace(KeyArg&& key, Args&&... args)
+    {
+        return this->MakeResult(this->FindOrInsert(key,
+            [&](value_type* slot)
+            {
+                std::construct_at(slot, std::piecewise_construct,
+                    std::forward_as_tuple(std::forward<KeyArg>(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+            }));
+    }
+
+    template<class Self, class KeyArg>
+    static auto& AtImpl(Self& self, const KeyArg& key)
+    {
+        auto iter = self.find(key);
+        if (iter == self.end())
+        {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return iter->second;
+    }
+
+}; // class FlatHashMap
+
+template<class K, class Hash = Hasher<K>, class KeyEqual = std::equal_to<>>
+class FlatHashSet : public FlatHashTable<FlatHashSetPolicy<K>, Hash, KeyEqual>
+{
+    using Base = FlatHashTable<FlatHashSetPolicy<K>, Hash, KeyEqual>;
+
+public:
+    using typename Base::key_type;
+    using typename Base::value_type;
+    using typename Base::iterator;
+    using Base::Base;
+    using Base::IsTransparent;
+    using Base::insert;
+
+    FlatHashSet() = default;
+
+    template<std::input_iterator InputIt>
+    FlatHashSet(InputIt first, InputIt last)
+    {
+        this->insert(first, last);
+    }
+
+    FlatHashSet(std::initializer_list<value_type> list)
+    {
+        this->insert(list.begin(), list.end());
+    }
+
+    // Construct the key from K only if not found (e.g. std::string from std::string_view).
+    template<class KeyArg>
+        requires (IsTransparent && !std::is_convertible_v<KeyArg, const key_type&> &&
+            std::is_constructible_v<key_type, KeyArg>)
+    std::pair<iterator, bool> insert(KeyArg&& key)
+    {
+        return this->MakeResult(this->FindOrInsert(key,
+            [&](value_type* slot) { std::construct_at(slot, std::forward<KeyArg>(key)); }));
+    }
+
+}; // class FlatHashSet
+
+} // namespace rad
@@ -0,0 +1,702 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <rad/Core/Sort.h>
+#include <rad/Container/Span.h>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rad
+{
+
+// Sorted-vector maps for the read-mostly lookup tables: FlatMap stores the keys and the values
+// in separate arrays (structure of arrays), so the binary search only touches the keys;
+// insertion and erasure move the elements after (O(n)), prefer the bulk construction.
+
+// The input is sorted by keys and has no duplicate keys, skip sorting.
+struct SortedUniqueTag
+{
+    explicit SortedUniqueTag() = default;
+};
+
+inline constexpr SortedUniqueTag SortedUnique{};
+
+// Return the indices of the keys in the sorted order, stable; radix sort if the keys are numbers
+// in the natural order.
+template<class K, class Compare>
+std::vector<size_t> FlatSortIndices(const std::vector<K>& keys, const Compare& comp)
+{
+    if constexpr (RadixSortable<K> &&
+        (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<K>>))
+    {
+        return RadixSortIndices(keys.data(), keys.size());
+    }
+    else
+    {
+        return SortIndices(keys, comp);
+    }
+}
+
+// Copy of the sorted keys in the Eytzinger (BFS) layout of the implicit binary search tree:
+// the nodes of the first levels are packed together, and the descendants of a node four levels
+// down are contiguous, which can be prefetched; faster than binary search for the tables much
+// larger than the caches.
+template<class K>
+class FlatEytzingerIndex
+{
+public:
+    bool IsEmpty() const { return m_keys.empty(); }
+
+    void Build(const std::vector<K>& sorted)
+    {
+        m_keys = sorted;
+        m_ranks.resize(sorted.size());
+        BuildSubtree(sorted, 0, 1);
+    }
+
+    void Clear()
+    {
+        m_keys = {};
+        m_ranks = {};
+    }
+
+    // Return the index in the sorted keys, as std::lower_bound.
+    template<class U, class Compare>
+    size_t LowerBound(const U& value, const Compare& comp) const
+    {
+        const size_t count = m_keys.size();
+        const K* keys = m_keys.data();
+        // 1-based node index, the children of k are 2k and 2k+1.
+        size_t k = 1;
+        while (k <= count)
+        {
+            Prefetch(keys, k * PrefetchStride);
+            k = 2 * k + (comp(keys[k - 1], value) ? 1 : 0);
+        }
+        // Cancel the right turns and the last left turn, which is the lower bound.
+        k >>= std::countr_one(k) + 1;
+        return (k == 0) ? count : m_ranks[k - 1];
+    }
+
+private:
+    // Descendants four levels down.
+    static constexpr size_t PrefetchStride = 16;
+
+    static void Prefetch(const K* keys, size_t index)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        // May be out of range, prefetch doesn't fault.
+        __builtin_prefetch(reinterpret_cast<const void*>(
+            reinterpret_cast<uintptr_t>(keys) + (index - 1) * sizeof(K)));
+#else
+        (void)keys;
+        (void)index;
+#endif
+    }
+
+    size_t BuildSubtree(const std::vector<K>& sorted, size_t rank, size_t k)
+    {
+        if (k <= sorted.size())
+        {
+            rank = BuildSubtree(sorted, rank, 2 * k);
+            m_keys[k - 1] = sorted[rank];
+            m_ranks[k - 1] = static_cast<uint32_t>(rank);
+            ++rank;
+            rank = BuildSubtree(sorted, rank, 2 * k + 1);
+        }
+        return rank;
+    }
+
+    std::vector<K> m_keys;
+    std::vector<uint32_t> m_ranks;
+
+}; // class FlatEytzingerIndex
+
+template<class K, class V, class Compare = std::less<>>
+class FlatMap
+{
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    // Random access iterator of the key-value pairs, dereferenced to the pairs of references.
+    template<bool IsConst>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = ptrdiff_t;
+        using reference = std::pair<const K&, std::conditional_t<IsConst, const V&, V&>>;
+        struct pointer
+        {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        Iterator() = default;
+
+        template<bool OtherIsConst>
+            requires (IsConst && !OtherIsConst)
+        Iterator(const Iterator<OtherIsConst>& other) :
+            m_map(other.m_map), m_index(other.m_index)
+        {
+        }
+
+        reference operator*() const { return { m_map->m_keys[m_index], m_map->m_values[m_index] }; }
+        pointer operator->() const { return { **this }; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator& operator++() { ++m_index; return *this; }
+        Iterator operator++(int) { Iterator iter = *this; ++m_index; return iter; }
+        Iterator& operator--() { --m_index; return *this; }
+        Iterator operator--(int) { Iterator iter = *this; --m_index; return iter; }
+        Iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        Iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        friend Iterator operator+(Iterator iter, difference_type n) { return iter += n; }
+        friend Iterator operator+(difference_type n, Iterator iter) { return iter += n; }
+        friend Iterator operator-(Iterator iter, difference_type n) { return iter -= n; }
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs)
+        {
+            return static_cast<difference_type>(lhs.m_index) - static_cast<difference_type>(rhs.m_index);
+        }
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return (lhs.m_index == rhs.m_index); }
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) { return (lhs.m_index <=> rhs.m_index); }
+
+        // The index in keys() and values().
+        size_t GetIndex() const { return m_index; }
+
+    private:
+        friend class FlatMap;
+        template<bool> friend class Iterator;
+        using MapPointer = std::conditional_t<IsConst, const FlatMap*, FlatMap*>;
+
+        Iterator(MapPointer map, size_t index) :
+            m_map(map), m_index(index)
+        {
+        }
+
+        MapPointer m_map = nullptr;
+        size_t m_index = 0;
+
+    }; // class Iterator
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp) :
+        m_comp(comp)
+    {
+    }
+
+    // Bulk construction: sort once, and keep the first of the duplicate keys.
+    FlatMap(std::vector<K> keys, std::vector<V> values, const Compare& comp = Compare()) :
+        m_keys(std::move(keys)), m_values(std::move(values)), m_comp(comp)
+    {
+        if (m_keys.size() != m_values.size())
+        {
+            throw std::invalid_argument("FlatMap: the numbers of keys and values mismatch");
+        }
+        SortUnique();
+    }
+
+    FlatMap(SortedUniqueTag, std::vector<K> keys, std::vector<V> values, const Compare& comp = Compare()) :
+        m_keys(std::move(keys)), m_values(std::move(values)), m_comp(comp)
+    {
+        assert(m_keys.size() == m_values.size());
+        assert(std::adjacent_find(m_keys.begin(), m_keys.end(),
+            [&](const K& a, const K& b) { return !m_comp(a, b); }) == m_keys.end());
+    }
+
+    template<std::input_iterator InputIt>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare()) :
+        m_comp(comp)
+    {
+        for (; first != last; ++first)
+        {
+            m_keys.push_back(first->first);
+            m_values.push_back(first->second);
+        }
+        SortUnique();
+    }
+
+    FlatMap(std::initializer_list<value_type> list, const Compare& comp = Compare()) :
+        FlatMap(list.begin(), list.end(), comp)
+    {
+    }
+
+    /// @name Iterators
+    /// @{
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, m_keys.size()); }
+    const_iterator end() const { return const_iterator(this, m_keys.size()); }
+    const_iterator cend() const { return end(); }
+    /// @}
+
+    /// @name Capacity
+    /// @{
+    bool empty() const noexcept { return m_keys.empty(); }
+    size_type size() const noexcept { return m_keys.size(); }
+
+    void reserve(size_type count)
+    {
+        m_keys.reserve(count);
+        m_values.reserve(count);
+    }
+
+    void shrink_to_fit()
+    {
+        m_keys.shrink_to_fit();
+        m_values.shrink_to_fit();
+    }
+    /// @}
+
+    // The sorted keys, and the values in the same order (structure of arrays).
+    Span<K> keys() const { return m_keys; }
+    Span<V> values() const { return m_values; }
+    V* GetValueData() { return m_values.data(); }
+
+    // Search in the Eytzinger layout instead of the binary search, for the tables much larger
+    // than the caches; costs a copy of the keys.
+    void SetEytzingerSearch(bool enable)
+    {
+        m_isEytzingerEnabled = enable;
+        UpdateSearchIndex();
+    }
+
+    bool IsEytzingerSearch() const { return m_isEytzingerEnabled; }
+
+    /// @name Lookup
+    /// @{
+    template<class U = K>
+    iterator find(const U& key) { return iterator(this, FindIndex(key)); }
+    template<class U = K>
+    const_iterator find(const U& key) const { return const_iterator(this, FindIndex(key)); }
+    template<class U = K>
+    bool contains(const U& key) const { return (FindIndex(key) != m_keys.size()); }
+    template<class U = K>
+    size_type count(const U& key) const { return contains(key) ? 1 : 0; }
+
+    template<class U = K>
+    iterator lower_bound(const U& key) { return iterator(this, LowerBoundIndex(key)); }
+    template<class U = K>
+    const_iterator lower_bound(const U& key) const { return const_iterator(this, LowerBoundIndex(key)); }
+
+    template<class U = K>
+    iterator upper_bound(const U& key)
+    {
+        return iterator(this, std::upper_bound(m_keys.begin(), m_keys.end(), key, m_comp) - m_keys.begin());
+    }
+
+    template<class U = K>
+    const_iterator upper_bound(const U& key) const
+    {
+        return const_iterator(this, std::upper_bound(m_keys.begin(), m_keys.end(), key, m_comp) - m_keys.begin());
+    }
+
+    template<class U = K>
+    V& at(const U& key)
+    {
+        const size_t index = FindIndex(key);
+        if (index == m_keys.size())
+        {
+            throw std::out_of_range("FlatMap::at: key not found");
+        }
+        return m_values[index];
+    }
+
+    template<class U = K>
+    const V& at(const U& key) const
+    {
+        const size_t index = FindIndex(key);
+        if (index == m_keys.size())
+        {
+            throw std::out_of_range("FlatMap::at: key not found");
+        }
+        return m_values[index];
+    }
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+    template<class KeyArg, class... Args>
+    std::pair<iterator, bool> try_emplace(KeyArg&& key, Args&&... args)
+    {
+        const size_t index = LowerBoundIndex(key);
+        if ((index < m_keys.size()) && !m_comp(key, m_keys[index]))
+        {
+            return { iterator(this, index), false };
+        }
+        V value(std::forward<Args>(args)...);
+        m_keys.emplace(m_keys.begin() + index, std::forward<KeyArg>(key));
+        try
+        {
+            m_values.emplace(m_values.begin() + index, std::move(value));
+        }
+        catch (...)
+        {
+            m_keys.erase(m_keys.begin() + index);
+            throw;
+        }
+        UpdateSearchIndex();
+        return { iterator(this, index), true };
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template<class KeyArg, class M>
+    std::pair<iterator, bool> insert_or_assign(KeyArg&& key, M&& value)
+    {
+        auto result = try_emplace(std::forward<KeyArg>(key), std::forward<M>(value));
+        if (!result.second)
+        {
+            m_values[result.first.m_index] = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    template<class KeyArg>
+    V& operator[](KeyArg&& key)
+    {
+        return m_values[try_emplace(std::forward<KeyArg>(key)).first.m_index];
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        const size_t index = pos.m_index;
+        m_keys.erase(m_keys.begin() + index);
+        m_values.erase(m_values.begin() + index);
+        UpdateSearchIndex();
+        return iterator(this, index);
+    }
+
+    template<class U = K>
+        requires (!std::is_convertible_v<const U&, const_iterator>)
+    size_type erase(const U& key)
+    {
+        const size_t index = FindIndex(key);
+        if (index == m_keys.size())
+        {
+            return 0;
+        }
+        erase(const_iterator(this, index));
+        return 1;
+    }
+
+    void clear() noexcept
+    {
+        m_keys.clear();
+        m_values.clear();
+        m_eytzinger.Clear();
+    }
+
+    void swap(FlatMap& other) noexcept
+    {
+        using std::swap;
+        swap(m_keys, other.m_keys);
+        swap(m_values, other.m_values);
+        swap(m_eytzinger, other.m_eytzinger);
+        swap(m_isEytzingerEnabled, other.m_isEytzingerEnabled);
+        swap(m_comp, other.m_comp);
+    }
+    /// @}
+
+    key_compare key_comp() const { return m_comp; }
+
+    friend bool operator==(const FlatMap& lhs, const FlatMap& rhs)
+    {
+        return (lhs.m_keys == rhs.m_keys) && (lhs.m_values == rhs.m_values);
+    }
+
+    friend void swap(FlatMap& lhs, FlatMap& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+private:
+    template<class U>
+    size_t LowerBoundIndex(const U& key) const
+    {
+        if (m_isEytzingerEnabled)
+        {
+            return m_eytzinger.LowerBound(key, m_comp);
+        }
+        return BranchlessLowerBound(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+
+    // Return size() if not found.
+    template<class U>
+    size_t FindIndex(const U& key) const
+    {
+        const size_t index = LowerBoundIndex(key);
+        if ((index < m_keys.size()) && !m_comp(key, m_keys[index]))
+        {
+            return index;
+        }
+        return m_keys.size();
+    }
+
+    void SortUnique()
+    {
+        const std::vector<size_t> indices = FlatSortIndices(m_keys, m_comp);
+        std::vector<K> keys;
+        std::vector<V> values;
+        keys.reserve(m_keys.size());
+        values.reserve(m_values.size());
+        for (size_t index : indices)
+        {
+            if (keys.empty() || m_comp(keys.back(), m_keys[index]))
+            {
+                keys.push_back(std::move(m_keys[index]));
+                values.push_back(std::move(m_values[index]));
+            }
+        }
+        m_keys = std::move(keys);
+        m_values = std::move(values);
+        UpdateSearchIndex();
+    }
+
+    void UpdateSearchIndex()
+    {
+        if (m_isEytzingerEnabled)
+        {
+            m_eytzinger.Build(m_keys);
+        }
+        else if (!m_eytzinger.IsEmpty())
+        {
+            m_eytzinger.Clear();
+        }
+    }
+
+    std::vector<K> m_keys;
+    std::vector<V> m_values;
+    FlatEytzingerIndex<K> m_eytzinger;
+    bool m_isEytzingerEnabled = false;
+    [[no_unique_address]] Compare m_comp;
+
+}; // class FlatMap
+
+template<class K, class Compare = std::less<>>
+class FlatSet
+{
+public:
+    using key_type = K;
+    using value_type = K;
+    using key_compare = Compare;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using iterator = typename std::vector<K>::const_iterator;
+    using const_iterator = iterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp) :
+        m_keys(), m_comp(comp)
+    {
+    }
+
+    // Bulk construction: sort once (radix sort if possible), and remove the duplicates.
+    explicit FlatSet(std::vector<K> keys, const Compare& comp = Compare()) :
+        m_keys(std::move(keys)), m_comp(comp)
+    {
+        SortUnique();
+    }
+
+    FlatSet(SortedUniqueTag, std::vector<K> keys, const Compare& comp = Compare()) :
+        m_keys(std::move(keys)), m_comp(comp)
+    {
+        assert(std::adjacent_find(m_keys.begin(), m_keys.end(),
+            [&](const K& a, const K& b) { return !m_comp(a, b); }) == m_keys.end());
+    }
+
+    template<std::input_iterator InputIt>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare()) :
+        m_keys(first, last), m_comp(comp)
+    {
+        SortUnique();
+    }
+
+    FlatSet(std::initializer_list<K> list, const Compare& comp = Compare()) :
+        m_keys(list), m_comp(comp)
+    {
+        SortUnique();
+    }
+
+    iterator begin() const { return m_keys.begin(); }
+    iterator end() const { return m_keys.end(); }
+    iterator cbegin() const { return m_keys.begin(); }
+    iterator cend() const { return m_keys.end(); }
+
+    bool empty() const noexcept { return m_keys.empty(); }
+    size_type size() const noexcept { return m_keys.size(); }
+    void reserve(size_type count) { m_keys.reserve(count); }
+    void shrink_to_fit() { m_keys.shrink_to_fit(); }
+
+    Span<K> keys() const { return m_keys; }
+
+    // See FlatMap::SetEytzingerSearch.
+    void SetEytzingerSearch(bool enable)
+    {
+        m_isEytzingerEnabled = enable;
+        UpdateSearchIndex();
+    }
+
+    bool IsEytzingerSearch() const { return m_isEytzingerEnabled; }
+
+    template<class U = K>
+    iterator find(const U& key) const { return m_keys.begin() + FindIndex(key); }
+    template<class U = K>
+    bool contains(const U& key) const { return (FindIndex(key) != m_keys.size()); }
+    template<class U = K>
+    size_type count(const U& key) const { return contains(key) ? 1 : 0; }
+    template<class U = K>
+    iterator lower_bound(const U& key) const { return m_keys.begin() + LowerBoundIndex(key); }
+    template<class U = K>
+    iterator upper_bound(const U& key) const { return std::upper_bound(m_keys.begin(), m_keys.end(), key, m_comp); }
+
+    template<class KeyArg>
+    std::pair<iterator, bool> insert(KeyArg&& key)
+    {
+        const size_t index = LowerBoundIndex(key);
+        if ((index < m_keys.size()) && !m_comp(key, m_keys[index]))
+        {
+            return { m_keys.begin() + index, false };
+        }
+        m_keys.emplace(m_keys.begin() + index, std::forward<KeyArg>(key));
+        UpdateSearchIndex();
+        return { m_keys.begin() + index, true };
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        auto iter = m_keys.erase(pos);
+        const size_t index = static_cast<size_t>(iter - m_keys.begin());
+        UpdateSearchIndex();
+        return m_keys.begin() + index;
+    }
+
+    template<class U = K>
+        requires (!std::is_convertible_v<const U&, const_iterator>)
+    size_type erase(const U& key)
+    {
+        const size_t index = FindIndex(key);
+        if (index == m_keys.size())
+        {
+            return 0;
+        }
+        erase(m_keys.begin() + index);
+        return 1;
+    }
+
+    void clear() noexcept
+    {
+        m_keys.clear();
+        m_eytzinger.Clear();
+    }
+
+    void swap(FlatSet& other) noexcept
+    {
+        using std::swap;
+        swap(m_keys, other.m_keys);
+        swap(m_eytzinger, other.m_eytzinger);
+        swap(m_isEytzingerEnabled, other.m_isEytzingerEnabled);
+        swap(m_comp, other.m_comp);
+    }
+
+    key_compare key_comp() const { return m_comp; }
+
+    friend bool operator==(const FlatSet& lhs, const FlatSet& rhs)
+    {
+        return (lhs.m_keys == rhs.m_keys);
+    }
+
+    friend void swap(FlatSet& lhs, FlatSet& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+private:
+    template<class U>
+    size_t LowerBoundIndex(const U& key) const
+    {
+        if (m_isEytzingerEnabled)
+        {
+            return m_eytzinger.LowerBound(key, m_comp);
+        }
+        return BranchlessLowerBound(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+
+    template<class U>
+    size_t FindIndex(const U& key) const
+    {
+        const size_t index = LowerBoundIndex(key);
+        if ((index < m_keys.size()) && !m_comp(key, m_keys[index]))
+        {
+            return index;
+        }
+        return m_keys.size();
+    }
+
+    void SortUnique()
+    {
+        if constexpr (RadixSortable<K> &&
+            (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<K>>))
+        {
+            RadixSort(m_keys);
+        }
+        else
+        {
+            std::sort(m_keys.begin(), m_keys.end(), m_comp);
+        }
+        m_keys.erase(std::unique(m_keys.begin(), m_keys.end(),
+            [&](const K& a, const K& b) { return !m_comp(a, b); }), m_keys.end());
+        UpdateSearchIndex();
+    }
+
+    void UpdateSearchIndex()
+    {
+        if (m_isEytzingerEnabled)
+        {
+            m_eytzinger.Build(m_keys);
+        }
+        else if (!m_eytzinger.IsEmpty())
+        {
+            m_eytzinger.Clear();
+        }
+    }
+
+    std::vector<K> m_keys;
+    FlatEytzingerIndex<K> m_eytzinger;
+    bool m_isEytzingerEnabled = false;
+    [[no_unique_address]] Compare m_comp;
+
+}; // class FlatSet
+
+} // namespace rad
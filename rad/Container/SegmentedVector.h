@@ -0,0 +1,465 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <rad/Core/Memory.h>
+#include <rad/Core/TypeTraits.h>
+#include <rad/Container/Span.h>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rad
+{
+
+/// Vector of geometrically growing segments: segment k holds FirstSegmentSize << k elements,
+/// growth allocates a new segment and never moves the elements, so the pointers and references
+/// to the elements stay valid until they are erased (unlike std::vector); the segments are large
+/// and few (unlike the fixed blocks of std::deque). The segment of an index is found in O(1)
+/// by the bit scan reverse of (index / FirstSegmentSize + 1).
+/// The segments can be visited separately (GetSegment), e.g. processed by different threads.
+/// The segment table is allocated with the first segment, an empty vector is three pointers.
+template<class T, std::size_t FirstSegmentSize = 16>
+class SegmentedVector
+{
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static_assert(std::has_single_bit(FirstSegmentSize), "FirstSegmentSize must be a power of two.");
+    static constexpr size_type FirstSegmentShift = std::countr_zero(FirstSegmentSize);
+    static_assert(FirstSegmentShift < 32, "FirstSegmentSize is too large.");
+    // The segments beyond a 48-bit address space can't be allocated anyway.
+    static constexpr size_type MaxSegmentCount = 48 - FirstSegmentShift;
+
+    struct Location
+    {
+        size_type segment;
+        size_type offset;
+    };
+
+    static Location Locate(size_type index)
+    {
+        const size_type bucket = (index >> FirstSegmentShift) + 1;
+        const size_type segment = static_cast<size_type>(std::bit_width(bucket)) - 1;
+        return { segment, index + FirstSegmentSize - (FirstSegmentSize << segment) };
+    }
+
+    static constexpr size_type GetSegmentSize(size_type segment) { return FirstSegmentSize << segment; }
+    static constexpr size_type GetSegmentFirstIndex(size_type segment)
+    {
+        return (FirstSegmentSize << segment) - FirstSegmentSize;
+    }
+
+    /// Caches the position in the current segment: the increments are pointer increments except at the
+    /// segment boundaries; the other moves seek by Locate.
+    template<bool IsConst>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        Iterator() = default;
+
+        template<bool OtherIsConst>
+            requires (IsConst && !OtherIsConst)
+        Iterator(const Iterator<OtherIsConst>& other) :
+            m_vector(other.m_vector), m_index(other.m_index), m_ptr(other.m_ptr), m_segmentEnd(other.m_segmentEnd)
+        {
+        }
+
+        reference operator*() const { return *m_ptr; }
+        pointer operator->() const { return m_ptr; }
+        reference operator[](difference_type n) const { return (*m_vector)[m_index + n]; }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            if (++m_ptr == m_segmentEnd)
+            {
+                Seek(m_index);
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) { Iterator iter = *this; ++*this; return iter; }
+        Iterator& operator--() { Seek(m_index - 1); return *this; }
+        Iterator operator--(int) { Iterator iter = *this; --*this; return iter; }
+        Iterator& operator+=(difference_type n) { Seek(m_index + n); return *this; }
+        Iterator& operator-=(difference_type n) { Seek(m_index - n); return *this; }
+        friend Iterator operator+(Iterator iter, difference_type n) { return iter += n; }
+        friend Iterator operator+(difference_type n, Iterator iter) { return iter += n; }
+        friend Iterator operator-(Iterator iter, difference_type n) { return iter -= n; }
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs)
+        {
+            return static_cast<difference_type>(lhs.m_index) - static_cast<difference_type>(rhs.m_index);
+        }
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return (lhs.m_index == rhs.m_index); }
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) { return (lhs.m_index <=> rhs.m_index); }
+
+    private:
+        friend class SegmentedVector;
+        template<bool> friend class Iterator;
+        using VectorPointer = std::conditional_t<IsConst, const SegmentedVector*, SegmentedVector*>;
+
+        Iterator(VectorPointer vector, size_type index) :
+            m_vector(vector)
+        {
+            Seek(index);
+        }
+
+        void Seek(size_type index)
+        {
+            m_index = index;
+            const Location location = Locate(index);
+            T* segment = (location.segment < m_vector->m_allocatedSegmentCount) ?
+                m_vector->m_segments[location.segment] : nullptr;
+            // Past the allocated segments: end() of a full vector.
+            m_ptr = segment ? segment + location.offset : nullptr;
+            m_segmentEnd = segment ? segment + GetSegmentSize(location.segment) : nullptr;
+        }
+
+        VectorPointer m_vector = nullptr;
+        size_type m_index = 0;
+        pointer m_ptr = nullptr;
+        pointer m_segmentEnd = nullptr;
+
+    }; // class Iterator
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SegmentedVector() noexcept = default;
+
+    // Delegate to the default constructor: the object is constructed once it returns,
+    // so the destructor frees the elements and segments if an element constructor throws.
+    explicit SegmentedVector(size_type count) :
+        SegmentedVector()
+    {
+        resize(count);
+    }
+
+    SegmentedVector(std::initializer_list<T> list) :
+        SegmentedVector()
+    {
+        reserve(list.size());
+        for (const T& value : list)
+        {
+            emplace_back(value);
+        }
+    }
+
+    SegmentedVector(const SegmentedVector& other) :
+        SegmentedVector()
+    {
+        reserve(other.size());
+        for (const T& value : other)
+        {
+            emplace_back(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+    {
+        swap(other);
+    }
+
+    ~SegmentedVector()
+    {
+        clear();
+        FreeSegments(0);
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& other)
+    {
+        if (this != &other)
+        {
+            SegmentedVector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            SegmentedVector moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    /// @name Iterators
+    /// @{
+    iterator begin() noexcept { return iterator(this, 0); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(this, m_size); }
+    const_iterator end() const noexcept { return const_iterator(this, m_size); }
+    const_iterator cend() const noexcept { return end(); }
+    /// @}
+
+    /// @name Capacity
+    /// @{
+    bool empty() const noexcept { return (m_size == 0); }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return GetSegmentFirstIndex(m_allocatedSegmentCount); }
+    static constexpr size_type max_size() noexcept { return GetSegmentFirstIndex(MaxSegmentCount); }
+
+    // Allocate the segments to hold count elements.
+    void reserve(size_type count)
+    {
+        if (count > capacity())
+        {
+            if (count > max_size())
+            {
+                throw std::length_error("SegmentedVector::reserve: count exceeds max_size");
+            }
+            const size_type segmentCount = Locate(count - 1).segment + 1;
+            while (m_allocatedSegmentCount < segmentCount)
+            {
+                AllocateSegment();
+            }
+        }
+    }
+
+    // Free the segments without elements.
+    void shrink_to_fit()
+    {
+        FreeSegments(GetSegmentCount());
+    }
+    /// @}
+
+    /// @name Segments
+    /// @{
+
+    // The number of segments with elements.
+    size_type GetSegmentCount() const noexcept
+    {
+        return (m_size > 0) ? (Locate(m_size - 1).segment + 1) : 0;
+    }
+
+    // The elements in a segment, contiguous.
+    MutableSpan<T> GetSegment(size_type segment)
+    {
+        return MutableSpan<T>(m_segments[segment], GetSegmentElementCount(segment));
+    }
+
+    Span<T> GetSegment(size_type segment) const
+    {
+        return Span<T>(m_segments[segment], GetSegmentElementCount(segment));
+    }
+
+    // Call f(span, firstIndex) for the elements of each segment; the segments are independent
+    // (can be dispatched to different threads) and the sizes double, so the tail segments dominate.
+    template<class Func>
+    void ForEachSegment(Func&& f)
+    {
+        const size_type segmentCount = GetSegmentCount();
+        for (size_type segment = 0; segment < segmentCount; ++segment)
+        {
+            f(GetSegment(segment), GetSegmentFirstIndex(segment));
+        }
+    }
+
+    template<class Func>
+    void ForEachSegment(Func&& f) const
+    {
+        const size_type segmentCount = GetSegmentCount();
+        for (size_type segment = 0; segment < segmentCount; ++segment)
+        {
+            f(GetSegment(segment), GetSegmentFirstIndex(segment));
+        }
+    }
+
+    /// @}
+
+    /// @name Element access
+    /// @{
+    reference operator[](size_type index)
+    {
+        assert(index < m_size);
+        const Location location = Locate(index);
+        return m_segments[location.segment][location.offset];
+    }
+
+    const_reference operator[](size_type index) const
+    {
+        assert(index < m_size);
+        const Location location = Locate(index);
+        return m_segments[location.segment][location.offset];
+    }
+
+    reference at(size_type index)
+    {
+        if (index >= m_size)
+        {
+            throw std::out_of_range("SegmentedVector::at: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const
+    {
+        if (index >= m_size)
+        {
+            throw std::out_of_range("SegmentedVector::at: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[m_size - 1]; }
+    const_reference back() const { return (*this)[m_size - 1]; }
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        const Location location = Locate(m_size);
+        if (location.segment >= m_allocatedSegmentCount)
+        {
+            AllocateSegment();
+        }
+        T* p = std::construct_at(m_segments[location.segment] + location.offset, std::forward<Args>(args)...);
+        ++m_size;
+        return *p;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        assert(m_size > 0);
+        std::destroy_at(&back());
+        --m_size;
+    }
+
+    void resize(size_type count)
+    {
+        reserve(count);
+        while (m_size < count)
+        {
+            emplace_back();
+        }
+        while (m_size > count)
+        {
+            pop_back();
+        }
+    }
+
+    // Keep the segments allocated.
+    void clear() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            const size_type segmentCount = GetSegmentCount();
+            for (size_type segment = 0; segment < segmentCount; ++segment)
+            {
+                MutableSpan<T> elements = GetSegment(segment);
+                std::destroy(elements.begin(), elements.end());
+            }
+        }
+        m_size = 0;
+    }
+
+    void swap(SegmentedVector& other) noexcept
+    {
+        std::swap(m_segments, other.m_segments);
+        std::swap(m_allocatedSegmentCount, other.m_allocatedSegmentCount);
+        std::swap(m_size, other.m_size);
+    }
+    /// @}
+
+    friend void swap(SegmentedVector& lhs, SegmentedVector& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    friend bool operator==(const SegmentedVector& lhs, const SegmentedVector& rhs)
+    {
+        return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+private:
+    size_type GetSegmentElementCount(size_type segment) const
+    {
+        assert(segment < m_allocatedSegmentCount);
+        const size_type firstIndex = GetSegmentFirstIndex(segment);
+        return (m_size > firstIndex) ? (std::min)(m_size - firstIndex, GetSegmentSize(segment)) : 0;
+    }
+
+    void AllocateSegment()
+    {
+        const size_type segment = m_allocatedSegmentCount;
+        if (segment >= MaxSegmentCount)
+        {
+            throw std::length_error("SegmentedVector: size exceeds max_size");
+        }
+        if (GetSegmentSize(segment) > SIZE_MAX / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        if (!m_segments)
+        {
+            m_segments = std::make_unique<T*[]>(MaxSegmentCount);
+        }
+        void* p = AlignedAlloc(GetSegmentSize(segment) * sizeof(T), (std::max)(alignof(T), std::size_t(64)));
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        m_segments[segment] = static_cast<T*>(p);
+        ++m_allocatedSegmentCount;
+    }
+
+    // Free the segments from firstSegment, which must have no elements.
+    void FreeSegments(size_type firstSegment)
+    {
+        while (m_allocatedSegmentCount > firstSegment)
+        {
+            --m_allocatedSegmentCount;
+            AlignedFree(m_segments[m_allocatedSegmentCount]);
+            m_segments[m_allocatedSegmentCount] = nullptr;
+        }
+    }
+
+    // Fixed size table, never reallocated: the segments are allocated in order.
+    std::unique_ptr<T*[]> m_segments;
+    size_type m_allocatedSegmentCount = 0;
+    size_type m_size = 0;
+
+}; // class SegmentedVector
+
+// Smaller than std::deque (80 bytes in libstdc++, 48 in libc++ and MSVC STL).
+static_assert(sizeof(SegmentedVector<int>) == 3 * sizeof(void*));
+
+// The elements are in the separate segments.
+template<class T, std::size_t FirstSegmentSize>
+struct IsTriviallyRelocatable<SegmentedVector<T, FirstSegmentSize>> : std::true_type
+{
+};
+
+} // namespace rad
@@ -1,12 +1,544 @@
 #pragma once
 
 #include <rad/Core/Platform.h>
-#include <boost/container/small_vector.hpp>
+#include <rad/Core/Memory.h>
+#include <rad/Core/TypeTraits.h>
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace rad
 {
 
+/// Vector with the storage of N elements inline, allocates from the heap when grows beyond N.
+/// Compared to boost::container::small_vector: size and capacity are 32-bit (the header is a pointer
+/// and two uint32_t), and the elements of IsTriviallyRelocatable types are relocated by memcpy/memmove
+/// on growth, insertion and erasure instead of one by one.
 template<class T, std::size_t N>
-using SmallVector = boost::container::small_vector<T, N>;
+class SmallVector
+{
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static_assert(N <= std::numeric_limits<uint32_t>::max());
+    static constexpr size_type InlineCapacity = N;
+
+    SmallVector() noexcept :
+        m_data(GetInlineData())
+    {
+    }
+
+    explicit SmallVector(size_type count) :
+        SmallVector()
+    {
+        resize(count);
+    }
+
+    SmallVector(size_type count, const T& value) :
+        SmallVector()
+    {
+        assign(count, value);
+    }
+
+    template<std::input_iterator InputIt>
+    SmallVector(InputIt first, InputIt last) :
+        SmallVector()
+    {
+        assign(first, last);
+    }
+
+    SmallVector(std::initializer_list<T> list) :
+        SmallVector()
+    {
+        assign(list.begin(), list.end());
+    }
+
+    SmallVector(const SmallVector& other) :
+        SmallVector()
+    {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) :
+        SmallVector()
+    {
+        MoveFrom(other);
+    }
+
+    ~SmallVector()
+    {
+        std::destroy_n(m_data, m_size);
+        Deallocate();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other)
+        {
+            clear();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> list)
+    {
+        assign(list.begin(), list.end());
+        return *this;
+    }
+
+    void assign(size_type count, const T& value)
+    {
+        // value may refer to an element.
+        T copy(value);
+        clear();
+        reserve(count);
+        std::uninitialized_fill_n(m_data, count, copy);
+        m_size = static_cast<uint32_t>(count);
+    }
+
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        append(first, last);
+    }
+
+    void assign(std::initializer_list<T> list)
+    {
+        assign(list.begin(), list.end());
+    }
+
+    /// @name Element access
+    /// @{
+    reference at(size_type index)
+    {
+        if (index >= m_size)
+        {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return m_data[index];
+    }
+
+    const_reference at(size_type index) const
+    {
+        if (index >= m_size)
+        {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return m_data[index];
+    }
+
+    reference operator[](size_type index)
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+    const_reference operator[](size_type index) const
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+    reference front() { assert(m_size > 0); return m_data[0]; }
+    const_reference front() const { assert(m_size > 0); return m_data[0]; }
+    reference back() { assert(m_size > 0); return m_data[m_size - 1]; }
+    const_reference back() const { assert(m_size > 0); return m_data[m_size - 1]; }
+
+    T* data() noexcept { return m_data; }
+    const T* data() const noexcept { return m_data; }
+    /// @}
+
+    /// @name Iterators
+    /// @{
+    iterator begin() noexcept { return m_data; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator cbegin() const noexcept { return m_data; }
+    iterator end() noexcept { return m_data + m_size; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+    const_iterator cend() const noexcept { return m_data + m_size; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    /// @}
+
+    /// @name Capacity
+    /// @{
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+    uint32_t size32() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    static constexpr size_type max_size() noexcept { return std::numeric_limits<uint32_t>::max(); }
+    /// Whether the elements are in the inline storage.
+    bool is_inline() const noexcept { return m_data == GetInlineData(); }
+
+    void reserve(size_type capacity)
+    {
+        if (capacity > m_capacity)
+        {
+            Reallocate(capacity);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        if (!is_inline() && (m_size < m_capacity))
+        {
+            Reallocate(m_size);
+        }
+    }
+    /// @}
+
+    /// @name Modifiers
+    /// @{
+    void clear() noexcept
+    {
+        std::destroy_n(m_data, m_size);
+        m_size = 0;
+    }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size < m_capacity) [[likely]]
+        {
+            T* p = std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+            ++m_size;
+            return *p;
+        }
+        return EmplaceBackSlow(std::forward<Args>(args)...);
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        assert(m_size > 0);
+        --m_size;
+        std::destroy_at(m_data + m_size);
+    }
+
+    template<std::input_iterator InputIt>
+    void append(InputIt first, InputIt last)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            const size_type count = static_cast<size_type>(std::distance(first, last));
+            reserve(GetGrownCapacity(m_size + count));
+            std::uninitialized_copy(first, last, m_data + m_size);
+            m_size += static_cast<uint32_t>(count);
+        }
+        else
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        assert((pos >= begin()) && (pos <= end()));
+        const size_type index = static_cast<size_type>(pos - begin());
+        if (index == m_size)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return m_data + index;
+        }
+        // args may refer to an element.
+        T value(std::forward<Args>(args)...);
+        reserve(GetGrownCapacity(m_size + 1));
+        T* p = m_data + index;
+        if constexpr (IsTriviallyRelocatableV<T> && std::is_nothrow_move_constructible_v<T>)
+        {
+            std::memmove(static_cast<void*>(p + 1), static_cast<const void*>(p), (m_size - index) * sizeof(T));
+            std::construct_at(p, std::move(value));
+        }
+        else
+        {
+            std::construct_at(m_data + m_size, std::move(m_data[m_size - 1]));
+            std::move_backward(p, m_data + m_size - 1, m_data + m_size);
+            *p = std::move(value);
+        }
+        ++m_size;
+        return p;
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+        const size_type index = static_cast<size_type>(pos - begin());
+        // value may refer to an element.
+        T copy(value);
+        reserve(GetGrownCapacity(m_size + count));
+        std::uninitialized_fill_n(m_data + m_size, count, copy);
+        m_size += static_cast<uint32_t>(count);
+        std::rotate(m_data + index, m_data + m_size - count, m_data + m_size);
+        return m_data + index;
+    }
+
+    /// The range must not be the elements of this vector.
+    template<std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_type index = static_cast<size_type>(pos - begin());
+        const size_type oldSize = m_size;
+        append(first, last);
+        std::rotate(m_data + index, m_data + oldSize, m_data + m_size);
+        return m_data + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> list)
+    {
+        return insert(pos, list.begin(), list.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        assert((first >= begin()) && (first <= last) && (last <= end()));
+        T* p = m_data + (first - begin());
+        const size_type count = static_cast<size_type>(last - first);
+        if (count == 0)
+        {
+            return p;
+        }
+        if constexpr (IsTriviallyRelocatableV<T>)
+        {
+            std::destroy(p, p + count);
+            UninitializedRelocate(p + count, end(), p);
+        }
+        else
+        {
+            std::move(p + count, end(), p);
+            std::destroy(end() - count, end());
+        }
+        m_size -= static_cast<uint32_t>(count);
+        return p;
+    }
+
+    void resize(size_type count)
+    {
+        if (count < m_size)
+        {
+            std::destroy(m_data + count, end());
+        }
+        else if (count > m_size)
+        {
+            reserve(count);
+            std::uninitialized_value_construct(end(), m_data + count);
+        }
+        m_size = static_cast<uint32_t>(count);
+    }
+
+    void resize(size_type count, const T& value)
+    {
+        if (count <= m_size)
+        {
+            resize(count);
+        }
+        else
+        {
+            insert(end(), count - m_size, value);
+        }
+    }
+
+    void swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (!is_inline() && !other.is_inline())
+        {
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+            std::swap(m_capacity, other.m_capacity);
+            return;
+        }
+        SmallVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+    /// @}
+
+    friend void swap(SmallVector& lhs, SmallVector& rhs) noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+
+    friend bool operator==(const SmallVector& lhs, const SmallVector& rhs)
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend auto operator<=>(const SmallVector& lhs, const SmallVector& rhs)
+        requires std::three_way_comparable<T>
+    {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    T* GetInlineData() noexcept { return reinterpret_cast<T*>(m_inline); }
+    const T* GetInlineData() const noexcept { return reinterpret_cast<const T*>(m_inline); }
+
+    size_type GetGrownCapacity(size_type minCapacity) const
+    {
+        if (minCapacity <= m_capacity)
+        {
+            return m_capacity;
+        }
+        if (minCapacity > max_size())
+        {
+            throw std::length_error("SmallVector: too many elements");
+        }
+        return (std::min)((std::max)(size_type(m_capacity) * 2, minCapacity), max_size());
+    }
+
+    void Reallocate(size_type capacity)
+    {
+        assert(capacity >= m_size);
+        if (capacity > max_size())
+        {
+            throw std::length_error("SmallVector: too many elements");
+        }
+        T* data = GetInlineData();
+        if (capacity > N)
+        {
+            data = std::allocator<T>().allocate(capacity);
+        }
+        else
+        {
+            capacity = N;
+        }
+        if (data == m_data)
+        {
+            return;
+        }
+        try
+        {
+            UninitializedRelocateN(m_data, m_size, data);
+        }
+        catch (...)
+        {
+            if (data != GetInlineData())
+            {
+                std::allocator<T>().deallocate(data, capacity);
+            }
+            throw;
+        }
+        Deallocate();
+        m_data = data;
+        m_capacity = static_cast<uint32_t>(capacity);
+    }
+
+    template<class... Args>
+    reference EmplaceBackSlow(Args&&... args)
+    {
+        const size_type capacity = GetGrownCapacity(size_type(m_size) + 1);
+        T* data = std::allocator<T>().allocate(capacity);
+        T* p = nullptr;
+        try
+        {
+            // Construct before relocating, args may refer to an element.
+            p = std::construct_at(data + m_size, std::forward<Args>(args)...);
+            try
+            {
+                UninitializedRelocateN(m_data, m_size, data);
+            }
+            catch (...)
+            {
+                std::destroy_at(p);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            std::allocator<T>().deallocate(data, capacity);
+            throw;
+        }
+        Deallocate();
+        m_data = data;
+        m_capacity = static_cast<uint32_t>(capacity);
+        ++m_size;
+        return *p;
+    }
+
+    // Take the heap buffer of other, or relocate its inline elements; other is left empty.
+    void MoveFrom(SmallVector& other)
+    {
+        assert(m_size == 0);
+        if (!other.is_inline())
+        {
+            Deallocate();
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+            other.m_data = other.GetInlineData();
+            other.m_capacity = static_cast<uint32_t>(N);
+        }
+        else
+        {
+            reserve(other.m_size);
+            UninitializedRelocateN(other.m_data, other.m_size, m_data);
+        }
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+
+    void Deallocate() noexcept
+    {
+        if (!is_inline())
+        {
+            std::allocator<T>().deallocate(m_data, m_capacity);
+        }
+    }
+
+    T* m_data;
+    uint32_t m_size = 0;
+    uint32_t m_capacity = static_cast<uint32_t>(N);
+    alignas(T) std::byte m_inline[(N > 0 ? N : 1) * sizeof(T)];
+
+}; // class SmallVector
 
-}
+} // namespace rad
@@ -9,6 +9,7 @@
 #include <iterator>
 #include <memory>
 #include <optional>
+#include <ranges>
 #include <type_traits>
 #include <vector>
 
@@ -248,4 +249,125 @@ public:
     /// @}
 }; // class Span
 
+/// MutableSpan refers to a contiguous sequence of objects which can be modified, inspired by:
+/// https://llvm.org/doxygen/classllvm_1_1MutableArrayRef.html.
+/// It converts to Span implicitly.
+template<typename T>
+class [[nodiscard]] MutableSpan : public Span<T> {
+public:
+    using value_type = T;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    /// @name Constructors
+    /// @{
+
+    /// Construct an empty MutableSpan.
+    /*implicit*/ MutableSpan() = default;
+
+    /// Construct an empty MutableSpan from std::nullopt.
+    /*implicit*/ MutableSpan(std::nullopt_t) : Span<T>() {}
+
+    /// Construct a MutableSpan from a single element.
+    /*implicit*/ MutableSpan(T& t) : Span<T>(t) {}
+
+    /// Construct a MutableSpan from a pointer and count.
+    constexpr /*implicit*/ MutableSpan(T* data, size_t count)
+        : Span<T>(data, count) {}
+
+    /// Construct a MutableSpan from a range.
+    constexpr MutableSpan(T* begin, T* end) : Span<T>(begin, end) {}
+
+    /// Construct a MutableSpan from a std::vector.
+    template<typename A>
+    /*implicit*/ MutableSpan(std::vector<T, A>& vec) : Span<T>(vec) {}
+
+    /// Construct a MutableSpan from a std::array
+    template <size_t N>
+    /*implicit*/ constexpr MutableSpan(std::array<T, N>& arr) : Span<T>(arr) {}
+
+    /// Construct a MutableSpan from a C array.
+    template <size_t N>
+    /*implicit*/ constexpr MutableSpan(T(&arr)[N]) : Span<T>(arr) {}
+
+    /// Construct a MutableSpan from a contiguous container with non-const elements.
+    template<typename Container>
+        requires std::ranges::contiguous_range<Container> &&
+            std::is_same_v<std::remove_reference_t<std::ranges::range_reference_t<Container>>, T>
+    MutableSpan(Container& c) :
+        Span<T>(std::ranges::data(c), std::ranges::size(c))
+    {}
+
+    /// @}
+
+    T* data() const { return const_cast<T*>(Span<T>::data()); }
+
+    iterator begin() const { return data(); }
+    iterator end() const { return data() + this->size(); }
+
+    reverse_iterator rbegin() const { return reverse_iterator(end()); }
+    reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+    /// front - Get the first element.
+    T& front() const {
+        assert(!this->empty());
+        return data()[0];
+    }
+
+    /// back - Get the last element.
+    T& back() const {
+        assert(!this->empty());
+        return data()[this->size() - 1];
+    }
+
+    /// slice(n, m) - Chop off the first n elements of the array, and keep m
+    /// elements in the array.
+    MutableSpan<T> slice(size_t n, size_t m) const {
+        assert(n + m <= this->size());
+        return MutableSpan<T>(data() + n, m);
+    }
+
+    /// slice(n) - Chop off the first n elements of the array.
+    MutableSpan<T> slice(size_t n) const { return slice(n, this->size() - n); }
+
+    /// Drop the first \p n elements of the array.
+    MutableSpan<T> drop_front(size_t n = 1) const {
+        assert(this->size() >= n && "Dropping more elements than exist");
+        return slice(n, this->size() - n);
+    }
+
+    /// Drop the last \p n elements of the array.
+    MutableSpan<T> drop_back(size_t n = 1) const {
+        assert(this->size() >= n && "Dropping more elements than exist");
+        return slice(0, this->size() - n);
+    }
+
+    /// Return a copy of *this with only the first \p n elements.
+    MutableSpan<T> take_front(size_t n = 1) const {
+        if (n >= this->size())
+            return *this;
+        return drop_back(this->size() - n);
+    }
+
+    /// Return a copy of *this with only the last \p n elements.
+    MutableSpan<T> take_back(size_t n = 1) const {
+        if (n >= this->size())
+            return *this;
+        return drop_front(this->size() - n);
+    }
+
+    T& operator[](size_t index) const {
+        assert(index < this->size());
+        return data()[index];
+    }
+}; // class MutableSpan
+
 } // namespace rad
@@ -0,0 +1,330 @@
+#include <rad/Container/SpanAlgorithm.h>
+#include <rad/System/CpuInfo.h>
+#include <algorithm>
+
+#if defined(RAD_ARCH_X86) && (defined(RAD_COMPILER_GCC) || defined(RAD_COMPILER_CLANG))
+#define RAD_SPAN_KERNELS_AVX2 1
+#else
+#define RAD_SPAN_KERNELS_AVX2 0
+#endif
+
+#if RAD_COMPILED_X86_SSE2 || defined(RAD_ARCH_X86_64)
+#define RAD_SPAN_COPY_NON_TEMPORAL 1
+#include <emmintrin.h>
+#else
+#define RAD_SPAN_COPY_NON_TEMPORAL 0
+#endif
+
+namespace rad
+{
+
+// The kernels are plain loops written for the auto-vectorizer (fixed size blocks without branches,
+// multiple accumulators for floats), inlined into the wrappers compiled for each ISA.
+
+template<typename T>
+using SpanMask = typename SpanIntOfSize<sizeof(T), false>::type;
+
+template<typename T>
+RAD_FORCE_INLINE void SpanFillImpl(T* data, size_t count, T value)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        data[i] = value;
+    }
+}
+
+template<typename T>
+RAD_FORCE_INLINE size_t SpanFindImpl(const T* data, size_t count, T value)
+{
+    size_t i = 0;
+    for (; i + SpanBlockSize <= count; i += SpanBlockSize)
+    {
+        SpanMask<T> found = 0;
+        for (size_t j = 0; j < SpanBlockSize; ++j)
+        {
+            found |= static_cast<SpanMask<T>>(data[i + j] == value);
+        }
+        if (found)
+        {
+            break;
+        }
+    }
+    for (; i < count; ++i)
+    {
+        if (data[i] == value)
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+template<typename T>
+RAD_FORCE_INLINE size_t SpanCountImpl(const T* data, size_t count, T value)
+{
+    size_t result = 0;
+    size_t i = 0;
+    for (; i + SpanBlockSize <= count; i += SpanBlockSize)
+    {
+        // At most SpanBlockSize, fits in any width.
+        SpanMask<T> blockCount = 0;
+        for (size_t j = 0; j < SpanBlockSize; ++j)
+        {
+            blockCount += static_cast<SpanMask<T>>(data[i + j] == value);
+        }
+        result += blockCount;
+    }
+    for (; i < count; ++i)
+    {
+        result += (data[i] == value) ? 1 : 0;
+    }
+    return result;
+}
+
+template<typename T>
+RAD_FORCE_INLINE void SpanMinMaxImpl(const T* data, size_t count, T* pMin, T* pMax)
+{
+    // A lane per element of a 256-bit vector.
+    static constexpr size_t LaneCount = 32 / sizeof(T);
+    T minValues[LaneCount];
+    T maxValues[LaneCount];
+    for (size_t j = 0; j < LaneCount; ++j)
+    {
+        minValues[j] = data[0];
+        maxValues[j] = data[0];
+    }
+    size_t i = 0;
+    for (; i + LaneCount <= count; i += LaneCount)
+    {
+        for (size_t j = 0; j < LaneCount; ++j)
+        {
+            const T value = data[i + j];
+            minValues[j] = (value < minValues[j]) ? value : minValues[j];
+            maxValues[j] = (maxValues[j] < value) ? value : maxValues[j];
+        }
+    }
+    T minValue = minValues[0];
+    T maxValue = maxValues[0];
+    for (size_t j = 1; j < LaneCount; ++j)
+    {
+        minValue = (minValues[j] < minValue) ? minValues[j] : minValue;
+        maxValue = (maxValue < maxValues[j]) ? maxValues[j] : maxValue;
+    }
+    for (; i < count; ++i)
+    {
+        minValue = (data[i] < minValue) ? data[i] : minValue;
+        maxValue = (maxValue < data[i]) ? data[i] : maxValue;
+    }
+    *pMin = minValue;
+    *pMax = maxValue;
+}
+
+template<typename T>
+RAD_FORCE_INLINE SpanSumType<T> SpanSumImpl(const T* data, size_t count)
+{
+    using Sum = SpanSumType<T>;
+    // The signed overflow is undefined: accumulate the integers unsigned (wrap around),
+    // and convert back at the end (modular since C++20).
+    using Acc = typename std::conditional_t<std::is_integral_v<Sum>, std::make_unsigned<Sum>, std::type_identity<Sum>>::type;
+    // Independent accumulators, the float additions can't be reordered by the compiler.
+    static constexpr size_t LaneCount = 8;
+    Acc sums[LaneCount] = {};
+    size_t i = 0;
+    for (; i + LaneCount <= count; i += LaneCount)
+    {
+        for (size_t j = 0; j < LaneCount; ++j)
+        {
+            sums[j] += static_cast<Acc>(static_cast<Sum>(data[i + j]));
+        }
+    }
+    Acc sum = 0;
+    for (size_t j = 0; j < LaneCount; ++j)
+    {
+        sum += sums[j];
+    }
+    for (; i < count; ++i)
+    {
+        sum += static_cast<Acc>(static_cast<Sum>(data[i]));
+    }
+    return static_cast<Sum>(sum);
+}
+
+template<typename T>
+RAD_FORCE_INLINE bool SpanEqualsImpl(const T* a, const T* b, size_t count)
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        return (count == 0) || (std::memcmp(a, b, count * sizeof(T)) == 0);
+    }
+    else
+    {
+        size_t i = 0;
+        for (; i + SpanBlockSize <= count; i += SpanBlockSize)
+        {
+            SpanMask<T> diff = 0;
+            for (size_t j = 0; j < SpanBlockSize; ++j)
+            {
+                diff |= static_cast<SpanMask<T>>(!(a[i + j] == b[i + j]));
+            }
+            if (diff)
+            {
+                return false;
+            }
+        }
+        for (; i < count; ++i)
+        {
+            if (!(a[i] == b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+template<typename T>
+struct SpanKernelsBaseline
+{
+    static void Fill(T* data, size_t count, T value) { SpanFillImpl(data, count, value); }
+    static size_t Find(const T* data, size_t count, T value) { return SpanFindImpl(data, count, value); }
+    static size_t Count(const T* data, size_t count, T value) { return SpanCountImpl(data, count, value); }
+    static void MinMax(const T* data, size_t count, T* pMin, T* pMax) { SpanMinMaxImpl(data, count, pMin, pMax); }
+    static SpanSumType<T> Sum(const T* data, size_t count) { return SpanSumImpl(data, count); }
+    static bool Equals(const T* a, const T* b, size_t count) { return SpanEqualsImpl(a, b, count); }
+};
+
+#if RAD_SPAN_KERNELS_AVX2
+#define RAD_TARGET_AVX2 __attribute__((target("avx2")))
+template<typename T>
+struct SpanKernelsAVX2
+{
+    RAD_TARGET_AVX2 static void Fill(T* data, size_t count, T value) { SpanFillImpl(data, count, value); }
+    RAD_TARGET_AVX2 static size_t Find(const T* data, size_t count, T value) { return SpanFindImpl(data, count, value); }
+    RAD_TARGET_AVX2 static size_t Count(const T* data, size_t count, T value) { return SpanCountImpl(data, count, value); }
+    RAD_TARGET_AVX2 static void MinMax(const T* data, size_t count, T* pMin, T* pMax) { SpanMinMaxImpl(data, count, pMin, pMax); }
+    RAD_TARGET_AVX2 static SpanSumType<T> Sum(const T* data, size_t count) { return SpanSumImpl(data, count); }
+    RAD_TARGET_AVX2 static bool Equals(const T* a, const T* b, size_t count) { return SpanEqualsImpl(a, b, count); }
+};
+#undef RAD_TARGET_AVX2
+#endif
+
+template<template<typename> class Kernels, typename T>
+static SpanKernels<T> MakeSpanKernels(const char* isaName)
+{
+    SpanKernels<T> kernels = {};
+    kernels.fill = &Kernels<T>::Fill;
+    kernels.find = &Kernels<T>::Find;
+    kernels.count = &Kernels<T>::Count;
+    kernels.minMax = &Kernels<T>::MinMax;
+    kernels.sum = &Kernels<T>::Sum;
+    kernels.equals = &Kernels<T>::Equals;
+    kernels.isaName = isaName;
+    return kernels;
+}
+
+// g_X86Info reads zeros if called during the static initialization before CpuInfo.cpp,
+// which selects the baseline.
+static bool IsAVX2Supported()
+{
+#if defined(CPU_FEATURES_ARCH_X86)
+    return g_X86Info.features.avx2;
+#else
+    return false;
+#endif
+}
+
+template<typename T>
+const SpanKernels<T>& GetSpanKernels()
+{
+    static const SpanKernels<T> kernels = []()
+    {
+#if RAD_SPAN_KERNELS_AVX2
+        if (IsAVX2Supported())
+        {
+            return MakeSpanKernels<SpanKernelsAVX2, T>("AVX2");
+        }
+#endif
+        return MakeSpanKernels<SpanKernelsBaseline, T>("Baseline");
+    }();
+    return kernels;
+}
+
+template const SpanKernels<int8_t>& GetSpanKernels<int8_t>();
+template const SpanKernels<int16_t>& GetSpanKernels<int16_t>();
+template const SpanKernels<int32_t>& GetSpanKernels<int32_t>();
+template const SpanKernels<int64_t>& GetSpanKernels<int64_t>();
+template const SpanKernels<uint8_t>& GetSpanKernels<uint8_t>();
+template const SpanKernels<uint16_t>& GetSpanKernels<uint16_t>();
+template const SpanKernels<uint32_t>& GetSpanKernels<uint32_t>();
+template const SpanKernels<uint64_t>& GetSpanKernels<uint64_t>();
+template const SpanKernels<float>& GetSpanKernels<float>();
+template const SpanKernels<double>& GetSpanKernels<double>();
+
+#if RAD_SPAN_COPY_NON_TEMPORAL
+static size_t GetNonTemporalCopyThreshold()
+{
+    static const size_t threshold = []()
+    {
+        size_t lastLevelSize = 0;
+#if defined(CPU_FEATURES_ARCH_X86)
+        for (int i = 0; i < g_CacheInfo.size; ++i)
+        {
+            const CacheLevelInfo& level = g_CacheInfo.levels[i];
+            if ((level.cache_type == CPU_FEATURE_CACHE_DATA) || (level.cache_type == CPU_FEATURE_CACHE_UNIFIED))
+            {
+                lastLevelSize = (std::max)(lastLevelSize, size_t(level.cache_size));
+            }
+        }
+#endif
+        if (lastLevelSize == 0)
+        {
+            lastLevelSize = 8 * 1024 * 1024;
+        }
+        return lastLevelSize / 2;
+    }();
+    return threshold;
+}
+
+static void CopyNonTemporal(uint8_t* dst, const uint8_t* src, size_t size)
+{
+    // Align the destination for the streaming stores.
+    const size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    size -= head;
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+        const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v0);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 16), v1);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 32), v2);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 48), v3);
+    }
+    // The streaming stores are weakly ordered.
+    _mm_sfence();
+    std::memcpy(dst + i, src + i, size - i);
+}
+#endif
+
+void SpanCopyBytes(void* dst, const void* src, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+#if RAD_SPAN_COPY_NON_TEMPORAL
+    if (size >= GetNonTemporalCopyThreshold())
+    {
+        CopyNonTemporal(static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src), size);
+        return;
+    }
+#endif
+    std::memcpy(dst, src, size);
+}
+
+} // namespace rad
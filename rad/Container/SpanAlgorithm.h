@@ -0,0 +1,190 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <rad/Container/Span.h>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace rad
+{
+
+// Vectorized algorithms on the contiguous ranges (Span, MutableSpan, std::vector...) of arithmetic types.
+// The kernels are compiled for the baseline ISA and for AVX2 (x86 with GCC/Clang), the best supported
+// is selected by CpuInfo once, at the first call of each element type.
+
+template<typename T>
+concept SpanArithmetic = (std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) <= 8)) ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template<std::ranges::contiguous_range Range>
+using SpanElement = std::remove_cvref_t<std::ranges::range_reference_t<Range>>;
+
+// Elements per block: the blocks are evaluated without branches, and the searches exit between the blocks.
+inline constexpr size_t SpanBlockSize = 64;
+
+template<size_t Size, bool IsSigned>
+struct SpanIntOfSize;
+template<> struct SpanIntOfSize<1, true> { using type = int8_t; };
+template<> struct SpanIntOfSize<2, true> { using type = int16_t; };
+template<> struct SpanIntOfSize<4, true> { using type = int32_t; };
+template<> struct SpanIntOfSize<8, true> { using type = int64_t; };
+template<> struct SpanIntOfSize<1, false> { using type = uint8_t; };
+template<> struct SpanIntOfSize<2, false> { using type = uint16_t; };
+template<> struct SpanIntOfSize<4, false> { using type = uint32_t; };
+template<> struct SpanIntOfSize<8, false> { using type = uint64_t; };
+
+// The kernels are instantiated for the fixed width types only (char, long long... are mapped).
+template<SpanArithmetic T>
+using SpanKernelType = typename std::conditional_t<std::is_floating_point_v<T>,
+    std::type_identity<T>, SpanIntOfSize<sizeof(T), std::is_signed_v<T>>>::type;
+
+template<SpanArithmetic T>
+using SpanSumType = std::conditional_t<std::is_floating_point_v<T>, double,
+    std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+template<typename T>
+struct SpanKernels
+{
+    void (*fill)(T* data, size_t count, T value);
+    size_t (*find)(const T* data, size_t count, T value);
+    size_t (*count)(const T* data, size_t count, T value);
+    void (*minMax)(const T* data, size_t count, T* pMin, T* pMax);
+    SpanSumType<T> (*sum)(const T* data, size_t count);
+    bool (*equals)(const T* a, const T* b, size_t count);
+    // "AVX2" or "Baseline".
+    const char* isaName;
+};
+
+// Explicitly instantiated for the fixed width types and float/double.
+template<typename T>
+const SpanKernels<T>& GetSpanKernels();
+
+// memcpy, with non-temporal stores if the size is larger than half of the last level cache,
+// which would be evicted otherwise; the ranges must not overlap.
+void SpanCopyBytes(void* dst, const void* src, size_t size);
+
+template<std::ranges::contiguous_range Range>
+    requires SpanArithmetic<SpanElement<Range>>
+void SpanFill(Range&& range, SpanElement<Range> value)
+{
+    using K = SpanKernelType<SpanElement<Range>>;
+    GetSpanKernels<K>().fill(reinterpret_cast<K*>(std::ranges::data(range)), std::ranges::size(range),
+        std::bit_cast<K>(value));
+}
+
+// Copy src to the beginning of dst (large enough).
+template<std::ranges::contiguous_range DstRange, std::ranges::contiguous_range SrcRange>
+    requires std::is_same_v<SpanElement<DstRange>, SpanElement<SrcRange>> &&
+        std::is_trivially_copyable_v<SpanElement<DstRange>>
+void SpanCopy(DstRange&& dst, const SrcRange& src)
+{
+    assert(std::ranges::size(dst) >= std::ranges::size(src));
+    SpanCopyBytes(std::ranges::data(dst), std::ranges::data(src),
+        std::ranges::size(src) * sizeof(SpanElement<SrcRange>));
+}
+
+// Return the index of the first element equal to value, or the size if not found.
+template<std::ranges::contiguous_range Range>
+    requires SpanArithmetic<SpanElement<Range>>
+size_t SpanFind(const Range& range, SpanElement<Range> value)
+{
+    using K = SpanKernelType<SpanElement<Range>>;
+    return GetSpanKernels<K>().find(reinterpret_cast<const K*>(std::ranges::data(range)),
+        std::ranges::size(range), std::bit_cast<K>(value));
+}
+
+template<std::ranges::contiguous_range Range>
+    requires SpanArithmetic<SpanElement<Range>>
+size_t SpanCount(const Range& range, SpanElement<Range> value)
+{
+    using K = SpanKernelType<SpanElement<Range>>;
+    return GetSpanKernels<K>().count(reinterpret_cast<const K*>(std::ranges::data(range)),
+        std::ranges::size(range), std::bit_cast<K>(value));
+}
+
+// The range must not be empty; NaNs are skipped unless the first element is a NaN (as operator<).
+template<std::ranges::contiguous_range Range>
+    requires SpanArithmetic<SpanElement<Range>>
+std::pair<SpanElement<Range>, SpanElement<Range>> SpanMinMax(const Range& range)
+{
+    using T = SpanElement<Range>;
+    using K = SpanKernelType<T>;
+    assert(std::ranges::size(range) > 0);
+    K minValue = {};
+    K maxValue = {};
+    GetSpanKernels<K>().minMax(reinterpret_cast<const K*>(std::ranges::data(range)),
+        std::ranges::size(range), &minValue, &maxValue);
+    return { std::bit_cast<T>(minValue), std::bit_cast<T>(maxValue) };
+}
+
+// Integers are summed in 64 bits (wrap around on overflow), floats in double with multiple accumulators
+// (the order of additions differs from a sequential loop).
+template<std::ranges::contiguous_range Range>
+    requires SpanArithmetic<SpanElement<Range>>
+SpanSumType<SpanElement<Range>> SpanSum(const Range& range)
+{
+    using K = SpanKernelType<SpanElement<Range>>;
+    return GetSpanKernels<K>().sum(reinterpret_cast<const K*>(std::ranges::data(range)), std::ranges::size(range));
+}
+
+// Element-wise operator== (+0.0 == -0.0, NaN != NaN).
+template<std::ranges::contiguous_range Range1, std::ranges::contiguous_range Range2>
+    requires SpanArithmetic<SpanElement<Range1>> && std::is_same_v<SpanElement<Range1>, SpanElement<Range2>>
+bool SpanEquals(const Range1& a, const Range2& b)
+{
+    using K = SpanKernelType<SpanElement<Range1>>;
+    const size_t count = std::ranges::size(a);
+    if (count != std::ranges::size(b))
+    {
+        return false;
+    }
+    return GetSpanKernels<K>().equals(reinterpret_cast<const K*>(std::ranges::data(a)),
+        reinterpret_cast<const K*>(std::ranges::data(b)), count);
+}
+
+// Whether pred is true for any element; pred is evaluated on whole blocks (vectorizable when inlined),
+// must have no side effects.
+template<std::ranges::contiguous_range Range, typename Pred>
+    requires SpanArithmetic<SpanElement<Range>>
+bool SpanAny(const Range& range, Pred pred)
+{
+    using Mask = typename SpanIntOfSize<sizeof(SpanElement<Range>), false>::type;
+    const auto* data = std::ranges::data(range);
+    const size_t count = std::ranges::size(range);
+    size_t i = 0;
+    for (; i + SpanBlockSize <= count; i += SpanBlockSize)
+    {
+        Mask any = 0;
+        for (size_t j = 0; j < SpanBlockSize; ++j)
+        {
+            any |= static_cast<Mask>(static_cast<bool>(pred(data[i + j])));
+        }
+        if (any)
+        {
+            return true;
+        }
+    }
+    for (; i < count; ++i)
+    {
+        if (pred(data[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<std::ranges::contiguous_range Range, typename Pred>
+    requires SpanArithmetic<SpanElement<Range>>
+bool SpanAll(const Range& range, Pred pred)
+{
+    return !SpanAny(range, [&](SpanElement<Range> value) { return !pred(value); });
+}
+
+} // namespace rad
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <rad/Container/Span.h>
+#include <array>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace rad
+{
+
+// Non-owning views of strided and multi-dimensional data (image rows with a pitch,
+// interleaved channels, tensors), similar to std::mdspan with layout_stride.
+// Unlike Span, T can be non-const to write through the views; strides are in elements and can be negative;
+// slicing returns sub-views without copies.
+
+// 1-D view with a stride between the elements, e.g. a column of an image, or a channel of interleaved pixels.
+template<typename T>
+class StridedSpan
+{
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    // The base pointer and an index: only the elements are addressed, never the one-past-the-end
+    // of a column or reversed view (before the data, or beyond the end of the buffer).
+    class iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() = default;
+        iterator(T* data, ptrdiff_t index, ptrdiff_t stride) : m_data(data), m_index(index), m_stride(stride) {}
+
+        reference operator*() const { return m_data[m_index * m_stride]; }
+        pointer operator->() const { return &m_data[m_index * m_stride]; }
+        reference operator[](difference_type n) const { return m_data[(m_index + n) * m_stride]; }
+        iterator& operator++() { ++m_index; return *this; }
+        iterator operator++(int) { iterator iter = *this; ++m_index; return iter; }
+        iterator& operator--() { --m_index; return *this; }
+        iterator operator--(int) { iterator iter = *this; --m_index; return iter; }
+        iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        friend iterator operator+(iterator iter, difference_type n) { return iter += n; }
+        friend iterator operator+(difference_type n, iterator iter) { return iter += n; }
+        friend iterator operator-(iterator iter, difference_type n) { return iter -= n; }
+        friend difference_type operator-(const iterator& lhs, const iterator& rhs) { return (lhs.m_index - rhs.m_index); }
+        friend bool operator==(const iterator& lhs, const iterator& rhs) { return (lhs.m_index == rhs.m_index); }
+        friend auto operator<=>(const iterator& lhs, const iterator& rhs) { return (lhs.m_index <=> rhs.m_index); }
+
+    private:
+        T* m_data = nullptr;
+        ptrdiff_t m_index = 0;
+        ptrdiff_t m_stride = 1;
+
+    }; // class iterator
+
+    constexpr StridedSpan() = default;
+
+    constexpr StridedSpan(T* data, size_t count, ptrdiff_t stride = 1) :
+        m_data(data), m_count(count), m_stride(stride)
+    {
+    }
+
+    // Contiguous, Span is read-only.
+    template<typename U>
+        requires std::is_convertible_v<const U(*)[], T(*)[]>
+    /*implicit*/ StridedSpan(Span<U> span) :
+        m_data(span.data()), m_count(span.size()), m_stride(1)
+    {
+    }
+
+    template<typename U>
+        requires (!std::is_same_v<U, T> && std::is_convertible_v<U(*)[], T(*)[]>)
+    /*implicit*/ constexpr StridedSpan(const StridedSpan<U>& other) :
+        m_data(other.data()), m_count(other.size()), m_stride(other.stride())
+    {
+    }
+
+    T* data() const { return m_data; }
+    size_t size() const { return m_count; }
+    bool empty() const { return (m_count == 0); }
+    ptrdiff_t stride() const { return m_stride; }
+    bool IsContiguous() const { return (m_stride == 1); }
+
+    iterator begin() const { return iterator(m_data, 0, m_stride); }
+    iterator end() const { return iterator(m_data, ptrdiff_t(m_count), m_stride); }
+
+    T& operator[](size_t index) const
+    {
+        assert(index < m_count);
+        return m_data[ptrdiff_t(index) * m_stride];
+    }
+
+    T& front() const { return (*this)[0]; }
+    T& back() const { return (*this)[m_count - 1]; }
+
+    // count elements from offset, every step-th.
+    StridedSpan slice(size_t offset, size_t count, size_t step = 1) const
+    {
+        assert((count == 0) || (offset + (count - 1) * step < m_count));
+        // An empty slice keeps the data: offset can be past the last element.
+        T* data = (count > 0) ? m_data + ptrdiff_t(offset) * m_stride : m_data;
+        return StridedSpan(data, count, m_stride * ptrdiff_t(step));
+    }
+
+    StridedSpan slice(size_t offset) const
+    {
+        assert(offset <= m_count);
+        return slice(offset, m_count - offset);
+    }
+
+    StridedSpan reversed() const
+    {
+        return StridedSpan(empty() ? m_data : &back(), m_count, -m_stride);
+    }
+
+    // The contiguous case is a separate loop to be vectorized.
+    template<typename Func>
+    void ForEach(Func&& func) const
+    {
+        if (m_stride == 1)
+        {
+            for (size_t i = 0; i < m_count; ++i)
+            {
+                func(m_data[i]);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < m_count; ++i)
+            {
+                func(m_data[ptrdiff_t(i) * m_stride]);
+            }
+        }
+    }
+
+private:
+    T* m_data = nullptr;
+    size_t m_count = 0;
+    ptrdiff_t m_stride = 1;
+
+}; // class StridedSpan
+
+// Multi-dimensional view with an extent and a stride per dimension (in elements), the last dimension
+// varies fastest in the default (row-major) layout; e.g. an image of (height, width, channelCount),
+// or an NCHW tensor.
+template<typename T, size_t Rank>
+class SpanND
+{
+public:
+    static_assert(Rank > 0);
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using Extents = std::array<size_t, Rank>;
+    using Strides = std::array<ptrdiff_t, Rank>;
+
+    constexpr SpanND() = default;
+
+    // Row-major layout.
+    SpanND(T* data, const Extents& extents) :
+        m_data(data), m_extents(extents)
+    {
+        ptrdiff_t stride = 1;
+        for (size_t d = Rank; d-- > 0;)
+        {
+            m_strides[d] = stride;
+            stride *= ptrdiff_t(extents[d]);
+        }
+    }
+
+    SpanND(T* data, const Extents& extents, const Strides& strides) :
+        m_data(data), m_extents(extents), m_strides(strides)
+    {
+    }
+
+    template<typename U>
+        requires (!std::is_same_v<U, T> && std::is_convertible_v<U(*)[], T(*)[]>)
+    /*implicit*/ SpanND(const SpanND<U, Rank>& other) :
+        m_data(other.data()), m_extents(other.extents()), m_strides(other.strides())
+    {
+    }
+
+    static constexpr size_t rank() { return Rank; }
+    T* data() const { return m_data; }
+    const Extents& extents() const { return m_extents; }
+    const Strides& strides() const { return m_strides; }
+    size_t extent(size_t dim) const { return m_extents[dim]; }
+    ptrdiff_t stride(size_t dim) const { return m_strides[dim]; }
+
+    // The number of elements.
+    size_t size() const
+    {
+        size_t count = 1;
+        for (size_t extent : m_extents)
+        {
+            count *= extent;
+        }
+        return count;
+    }
+
+    bool empty() const { return (size() == 0); }
+
+    // Row-major and no gaps.
+    bool IsContiguous() const
+    {
+        ptrdiff_t stride = 1;
+        for (size_t d = Rank; d-- > 0;)
+        {
+            if ((m_extents[d] != 1) && (m_strides[d] != stride))
+            {
+                return false;
+            }
+            stride *= ptrdiff_t(m_extents[d]);
+        }
+        return true;
+    }
+
+    template<typename... Indices>
+        requires ((sizeof...(Indices) == Rank) && (std::is_convertible_v<Indices, size_t> && ...))
+    T& operator()(Indices... indices) const
+    {
+        return m_data[GetOffset({ static_cast<size_t>(indices)... })];
+    }
+
+    T& operator[](const Extents& indices) const
+    {
+        return m_data[GetOffset(indices)];
+    }
+
+    ptrdiff_t GetOffset(const Extents& indices) const
+    {
+        ptrdiff_t offset = 0;
+        for (size_t d = 0; d < Rank; ++d)
+        {
+            assert(indices[d] < m_extents[d]);
+            offset += ptrdiff_t(indices[d]) * m_strides[d];
+        }
+        return offset;
+    }
+
+    // Fix the index of a dimension, e.g. a row of a matrix or a channel of an image.
+    SpanND<T, Rank - 1> slice(size_t dim, size_t index) const
+        requires (Rank > 1)
+    {
+        assert((dim < Rank) && (index < m_extents[dim]));
+        typename SpanND<T, Rank - 1>::Extents extents = {};
+        typename SpanND<T, Rank - 1>::Strides strides = {};
+        for (size_t d = 0, i = 0; d < Rank; ++d)
+        {
+            if (d != dim)
+            {
+                extents[i] = m_extents[d];
+                strides[i] = m_strides[d];
+                ++i;
+            }
+        }
+        return SpanND<T, Rank - 1>(m_data + ptrdiff_t(index) * m_strides[dim], extents, strides);
+    }
+
+    // Keep count indices from offset in a dimension, e.g. a region of an image.
+    SpanND subspan(size_t dim, size_t offset, size_t count) const
+    {
+        assert((dim < Rank) && (offset + count <= m_extents[dim]));
+        SpanND view = *this;
+        view.m_data += ptrdiff_t(offset) * m_strides[dim];
+        view.m_extents[dim] = count;
+        return view;
+    }
+
+    // Swap two dimensions without copies, e.g. transpose a matrix.
+    SpanND transposed(size_t dim0, size_t dim1) const
+    {
+        SpanND view = *this;
+        std::swap(view.m_extents[dim0], view.m_extents[dim1]);
+        std::swap(view.m_strides[dim0], view.m_strides[dim1]);
+        return view;
+    }
+
+    StridedSpan<T> ToStridedSpan() const
+        requires (Rank == 1)
+    {
+        return StridedSpan<T>(m_data, m_extents[0], m_strides[0]);
+    }
+
+    // Visit all elements in the row-major order; the innermost dimension is a separate loop,
+    // which the compiler can vectorize when its stride is 1.
+    template<typename Func>
+    void ForEach(Func&& func) const
+    {
+        if (empty())
+        {
+            return;
+        }
+        ForEachInDim<0>(m_data, func);
+    }
+
+private:
+    template<size_t Dim, typename Func>
+    void ForEachInDim(T* base, Func& func) const
+    {
+        if constexpr (Dim + 1 == Rank)
+        {
+            StridedSpan<T>(base, m_extents[Dim], m_strides[Dim]).ForEach(func);
+        }
+        else
+        {
+            for (size_t i = 0; i < m_extents[Dim]; ++i)
+            {
+                ForEachInDim<Dim + 1>(base + ptrdiff_t(i) * m_strides[Dim], func);
+            }
+        }
+    }
+
+    T* m_data = nullptr;
+    Extents m_extents = {};
+    Strides m_strides = {};
+
+}; // class SpanND
+
+// 2-D view of rows and columns with a row stride (pitch) and a column stride, e.g. a channel of
+// an image with the interleaved channels (colStride = channelCount), or a locked texture.
+template<typename T>
+class Span2D : public SpanND<T, 2>
+{
+public:
+    using Base = SpanND<T, 2>;
+    using Base::Base;
+
+    constexpr Span2D() = default;
+
+    Span2D(const Base& other) : Base(other) {}
+
+    // Tightly packed rows.
+    Span2D(T* data, size_t rowCount, size_t colCount) :
+        Base(data, { rowCount, colCount })
+    {
+    }
+
+    Span2D(T* data, size_t rowCount, size_t colCount, ptrdiff_t rowStride, ptrdiff_t colStride = 1) :
+        Base(data, { rowCount, colCount }, { rowStride, colStride })
+    {
+    }
+
+    // The row pitch in bytes (e.g. of a locked texture), must be a multiple of sizeof(T).
+    static Span2D FromRowPitch(T* data, size_t rowCount, size_t colCount, size_t rowPitch, ptrdiff_t colStride = 1)
+    {
+        assert(rowPitch % sizeof(T) == 0);
+        return Span2D(data, rowCount, colCount, ptrdiff_t(rowPitch / sizeof(T)), colStride);
+    }
+
+    size_t rows() const { return this->extent(0); }
+    size_t cols() const { return this->extent(1); }
+    ptrdiff_t rowStride() const { return this->stride(0); }
+    ptrdiff_t colStride() const { return this->stride(1); }
+
+    T* GetRowData(size_t i) const
+    {
+        assert(i < rows());
+        return this->data() + ptrdiff_t(i) * rowStride();
+    }
+
+    StridedSpan<T> row(size_t i) const { return StridedSpan<T>(GetRowData(i), cols(), colStride()); }
+
+    StridedSpan<T> col(size_t j) const
+    {
+        assert(j < cols());
+        return StridedSpan<T>(this->data() + ptrdiff_t(j) * colStride(), rows(), rowStride());
+    }
+
+    Span2D subspan(size_t rowOffset, size_t rowCount, size_t colOffset, size_t colCount) const
+    {
+        return Base::subspan(0, rowOffset, rowCount).subspan(1, colOffset, colCount);
+    }
+
+    Span2D transposed() const { return Base::transposed(0, 1); }
+
+}; // class Span2D
+
+} // namespace rad
@@ -0,0 +1,265 @@
+#include <rad/Core/AllocTracker.h>
+#include <algorithm>
+#include <mutex>
+
+namespace rad
+{
+
+std::atomic<bool> g_allocTrackingEnabled = false;
+
+struct AllocCounters
+{
+    // Written by the owner thread only (no RMW), read by the others.
+    std::atomic<uint64_t> allocCount = 0;
+    std::atomic<uint64_t> freeCount = 0;
+    std::atomic<uint64_t> allocBytes = 0;
+    std::atomic<uint64_t> freeBytes = 0;
+};
+
+struct AllocThreadCounters
+{
+    AllocCounters counters[AllocTagMaxCount];
+    uint32_t sampleCountdown = 0;
+};
+
+struct AllocTrackerRegistry
+{
+    std::mutex mutex;
+    std::vector<std::string> tagNames;
+    std::vector<AllocThreadCounters*> threads;
+    // Counters merged from the exited threads.
+    AllocThreadCounters exited;
+    std::atomic<AllocSampler*> sampler = nullptr;
+    std::atomic<uint32_t> sampleInterval = 0;
+};
+
+static AllocTrackerRegistry& GetAllocTrackerRegistry()
+{
+    // Never destroyed: threads may exit after the static destruction.
+    static AllocTrackerRegistry* registry = []() {
+        AllocTrackerRegistry* registry = new AllocTrackerRegistry();
+        // Reserved to keep the names returned by GetAllocTagName stable.
+        registry->tagNames.reserve(AllocTagMaxCount);
+        for (const char* name : { "Unknown", "Aligned", "Pool", "Arena", "LargeBuffer", "VirtualBuffer", "RefCounted" })
+        {
+            registry->tagNames.emplace_back(name);
+        }
+        return registry;
+    }();
+    return *registry;
+}
+
+static void AddRelaxed(std::atomic<uint64_t>& counter, uint64_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Set when the thread_local handle is destroyed: trivially destructible, so still valid to read
+// in the later thread teardown (e.g. the flush of a thread_local pool cache).
+static thread_local bool t_allocCountersDestroyed = false;
+
+struct AllocThreadCountersHandle
+{
+    AllocThreadCounters* counters = nullptr;
+
+    ~AllocThreadCountersHandle()
+    {
+        t_allocCountersDestroyed = true;
+        if (counters == nullptr)
+        {
+            return;
+        }
+        AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+        std::lock_guard lock(registry.mutex);
+        for (uint32_t i = 0; i < AllocTagMaxCount; ++i)
+        {
+            AllocCounters& src = counters->counters[i];
+            AllocCounters& dst = registry.exited.counters[i];
+            AddRelaxed(dst.allocCount, src.allocCount.load(std::memory_order_relaxed));
+            AddRelaxed(dst.freeCount, src.freeCount.load(std::memory_order_relaxed));
+            AddRelaxed(dst.allocBytes, src.allocBytes.load(std::memory_order_relaxed));
+            AddRelaxed(dst.freeBytes, src.freeBytes.load(std::memory_order_relaxed));
+        }
+        std::erase(registry.threads, counters);
+        delete counters;
+        counters = nullptr;
+    }
+};
+
+static thread_local AllocThreadCountersHandle t_allocCounters;
+
+// Return nullptr after the thread's counters are merged on exit.
+static AllocThreadCounters* GetThreadCounters()
+{
+    if (t_allocCountersDestroyed)
+    {
+        return nullptr;
+    }
+    if (t_allocCounters.counters == nullptr)
+    {
+        AllocThreadCounters* counters = new AllocThreadCounters();
+        AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+        std::lock_guard lock(registry.mutex);
+        registry.threads.push_back(counters);
+        t_allocCounters.counters = counters;
+    }
+    return t_allocCounters.counters;
+}
+
+AllocTag RegisterAllocTag(std::string_view name)
+{
+    AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+    std::lock_guard lock(registry.mutex);
+    for (size_t i = 0; i < registry.tagNames.size(); ++i)
+    {
+        if (registry.tagNames[i] == name)
+        {
+            return AllocTag(i);
+        }
+    }
+    if (registry.tagNames.size() >= AllocTagMaxCount)
+    {
+        return AllocTag::Unknown;
+    }
+    registry.tagNames.emplace_back(name);
+    return AllocTag(registry.tagNames.size() - 1);
+}
+
+std::string_view GetAllocTagName(AllocTag tag)
+{
+    AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+    std::lock_guard lock(registry.mutex);
+    if (uint32_t(tag) < registry.tagNames.size())
+    {
+        return registry.tagNames[uint32_t(tag)];
+    }
+    return {};
+}
+
+void EnableAllocTracking(bool enable)
+{
+    g_allocTrackingEnabled.store(enable, std::memory_order_relaxed);
+}
+
+void SetAllocSampler(AllocSampler* sampler, uint32_t interval)
+{
+    AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+    registry.sampleInterval.store((std::max)(interval, 1u), std::memory_order_relaxed);
+    registry.sampler.store(sampler, std::memory_order_release);
+}
+
+// Count into the exited counters, for the tracking after the thread's counters are merged on exit.
+static void TrackExited(AllocTag tag, bool isFree, std::size_t size)
+{
+    AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+    std::lock_guard lock(registry.mutex);
+    AllocCounters& counters = registry.exited.counters[uint32_t(tag) % AllocTagMaxCount];
+    AddRelaxed(isFree ? counters.freeCount : counters.allocCount, 1);
+    AddRelaxed(isFree ? counters.freeBytes : counters.allocBytes, size);
+}
+
+void TrackAllocSlow(AllocTag tag, void* p, std::size_t size)
+{
+    AllocThreadCounters* threadCounters = GetThreadCounters();
+    if (threadCounters == nullptr)
+    {
+        // The sample countdown is gone with the thread counters, not sampled.
+        TrackExited(tag, false, size);
+        return;
+    }
+    AllocCounters& counters = threadCounters->counters[uint32_t(tag) % AllocTagMaxCount];
+    AddRelaxed(counters.allocCount, 1);
+    AddRelaxed(counters.allocBytes, size);
+
+    AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+    AllocSampler* sampler = registry.sampler.load(std::memory_order_acquire);
+    if (sampler)
+    {
+        if (threadCounters->sampleCountdown == 0)
+        {
+            // Sample this one, and skip interval - 1.
+            threadCounters->sampleCountdown = registry.sampleInterval.load(std::memory_order_relaxed) - 1;
+            sampler->OnAlloc(tag, p, size);
+        }
+        else
+        {
+            --threadCounters->sampleCountdown;
+        }
+    }
+}
+
+void TrackFreeSlow(AllocTag tag, void* p, std::size_t size)
+{
+    AllocThreadCounters* threadCounters = GetThreadCounters();
+    if (threadCounters == nullptr)
+    {
+        TrackExited(tag, true, size);
+    }
+    else
+    {
+        AllocCounters& counters = threadCounters->counters[uint32_t(tag) % AllocTagMaxCount];
+        AddRelaxed(counters.freeCount, 1);
+        AddRelaxed(counters.freeBytes, size);
+    }
+
+    AllocSampler* sampler = GetAllocTrackerRegistry().sampler.load(std::memory_order_acquire);
+    if (sampler)
+    {
+        sampler->OnFree(tag, p, size);
+    }
+}
+
+std::vector<AllocTagStats> GetAllocStats()
+{
+    AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+    std::lock_guard lock(registry.mutex);
+    std::vector<AllocTagStats> stats;
+    for (uint32_t i = 0; i < AllocTagMaxCount; ++i)
+    {
+        AllocTagStats tagStats = {};
+        tagStats.tag = AllocTag(i);
+        auto accumulate = [&](const AllocCounters& counters) {
+            tagStats.allocCount += counters.allocCount.load(std::memory_order_relaxed);
+            tagStats.freeCount += counters.freeCount.load(std::memory_order_relaxed);
+            tagStats.allocBytes += counters.allocBytes.load(std::memory_order_relaxed);
+            tagStats.freeBytes += counters.freeBytes.load(std::memory_order_relaxed);
+        };
+        accumulate(registry.exited.counters[i]);
+        for (const AllocThreadCounters* threadCounters : registry.threads)
+        {
+            accumulate(threadCounters->counters[i]);
+        }
+        if (i < registry.tagNames.size())
+        {
+            tagStats.name = registry.tagNames[i];
+        }
+        if ((i < registry.tagNames.size()) || (tagStats.allocCount > 0) || (tagStats.freeCount > 0))
+        {
+            stats.push_back(tagStats);
+        }
+    }
+    return stats;
+}
+
+void ResetAllocStats()
+{
+    AllocTrackerRegistry& registry = GetAllocTrackerRegistry();
+    std::lock_guard lock(registry.mutex);
+    auto reset = [](AllocThreadCounters& threadCounters) {
+        for (AllocCounters& counters : threadCounters.counters)
+        {
+            // Racy with the owner threads, the counters are approximate while tracking.
+            counters.allocCount.store(0, std::memory_order_relaxed);
+            counters.freeCount.store(0, std::memory_order_relaxed);
+            counters.allocBytes.store(0, std::memory_order_relaxed);
+            counters.freeBytes.store(0, std::memory_order_relaxed);
+        }
+    };
+    reset(registry.exited);
+    for (AllocThreadCounters* threadCounters : registry.threads)
+    {
+        reset(*threadCounters);
+    }
+}
+
+} // namespace rad
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rad
+{
+
+// Opt-in allocation tracking of the library allocators (AlignedAlloc, PoolAlloc, Arena, LargeBuffer, VirtualBuffer)
+// and RefCounted objects: per-tag counters aggregated per thread, and an optional sampler
+// (e.g. the heap profiler in rad/System/HeapProfiler.h); disabled by default, and costs a relaxed load then.
+
+enum class AllocTag : uint32_t
+{
+    Unknown,
+    Aligned,
+    Pool,
+    Arena,
+    LargeBuffer,
+    VirtualBuffer,  // The committed pages.
+    RefCounted,
+    UserBegin,  // Tags registered by RegisterAllocTag.
+};
+
+inline constexpr uint32_t AllocTagMaxCount = 64;
+
+// Return AllocTag::Unknown if there are too many tags; returns the same tag for the same name.
+AllocTag RegisterAllocTag(std::string_view name);
+std::string_view GetAllocTagName(AllocTag tag);
+
+struct AllocTagStats
+{
+    AllocTag tag;
+    std::string_view name;
+    uint64_t allocCount;
+    uint64_t freeCount;
+    uint64_t allocBytes;
+    // AlignedAlloc/AlignedFree count the usable size of the block (at least the size requested).
+    uint64_t freeBytes;
+};
+
+// Receives the sampled allocations and all frees while installed.
+class AllocSampler
+{
+public:
+    virtual ~AllocSampler() = default;
+    virtual void OnAlloc(AllocTag tag, void* p, std::size_t size) = 0;
+    virtual void OnFree(AllocTag tag, void* p, std::size_t size) = 0;
+};
+
+extern std::atomic<bool> g_allocTrackingEnabled;
+
+void EnableAllocTracking(bool enable);
+
+inline bool IsAllocTrackingEnabled()
+{
+    return g_allocTrackingEnabled.load(std::memory_order_relaxed);
+}
+
+// Sample every interval-th allocation (per thread, 0 is treated as 1), or remove the sampler with nullptr.
+// The sampler must outlive the tracking.
+void SetAllocSampler(AllocSampler* sampler, uint32_t interval);
+
+void TrackAllocSlow(AllocTag tag, void* p, std::size_t size);
+void TrackFreeSlow(AllocTag tag, void* p, std::size_t size);
+
+inline void TrackAlloc(AllocTag tag, void* p, std::size_t size)
+{
+    if (IsAllocTrackingEnabled()) [[unlikely]]
+    {
+        TrackAllocSlow(tag, p, size);
+    }
+}
+
+inline void TrackFree(AllocTag tag, void* p, std::size_t size)
+{
+    if (IsAllocTrackingEnabled()) [[unlikely]]
+    {
+        TrackFreeSlow(tag, p, size);
+    }
+}
+
+// Sum of all threads, only the tags used or registered.
+std::vector<AllocTagStats> GetAllocStats();
+void ResetAllocStats();
+
+} // namespace rad
@@ -0,0 +1,247 @@
+#include <rad/Core/Epoch.h>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rad
+{
+
+struct EpochRetired
+{
+    void* p;
+    EpochDeleter deleter;
+    uint64_t epoch;
+};
+
+// Records are never freed, and reused after the threads exit.
+struct EpochThreadRecord
+{
+    // (epoch << 1) | pinned
+    std::atomic<uint64_t> state = 0;
+    std::atomic<bool> inUse = true;
+    EpochThreadRecord* next = nullptr;
+    // Accessed by the owner thread only.
+    uint32_t pinDepth = 0;
+    uint32_t retireCountSinceCollect = 0;
+    std::vector<EpochRetired> retired;
+};
+
+static constexpr uint32_t EpochCollectInterval = 64;
+
+// Starts from 2, the objects retired in epoch e are freed when the global epoch >= e + 2.
+static std::atomic<uint64_t> g_epoch = 2;
+static std::atomic<EpochThreadRecord*> g_epochRecords = nullptr;
+
+// Objects retired by the exited threads.
+struct EpochOrphans
+{
+    std::mutex mutex;
+    std::vector<EpochRetired> retired;
+};
+
+static EpochOrphans& GetEpochOrphans()
+{
+    // Never destroyed: threads may exit after the static destruction.
+    static EpochOrphans* orphans = new EpochOrphans();
+    return *orphans;
+}
+
+static EpochThreadRecord* AcquireEpochRecord()
+{
+    for (EpochThreadRecord* record = g_epochRecords.load(std::memory_order_acquire);
+        record != nullptr; record = record->next)
+    {
+        bool inUse = false;
+        if (!record->inUse.load(std::memory_order_relaxed) &&
+            record->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+        {
+            return record;
+        }
+    }
+    EpochThreadRecord* record = new EpochThreadRecord();
+    record->next = g_epochRecords.load(std::memory_order_relaxed);
+    while (!g_epochRecords.compare_exchange_weak(record->next, record,
+        std::memory_order_release, std::memory_order_relaxed));
+    return record;
+}
+
+static void FreeRetired(std::vector<EpochRetired>& retired, uint64_t globalEpoch)
+{
+    // Retired in the order of epochs.
+    size_t count = 0;
+    while ((count < retired.size()) && (retired[count].epoch + 2 <= globalEpoch))
+    {
+        ++count;
+    }
+    if (count == 0)
+    {
+        return;
+    }
+    // Deleters may retire more objects.
+    std::vector<EpochRetired> freeing(retired.begin(), retired.begin() + count);
+    retired.erase(retired.begin(), retired.begin() + count);
+    for (const EpochRetired& entry : freeing)
+    {
+        entry.deleter(entry.p);
+    }
+}
+
+struct EpochThreadHandle
+{
+    EpochThreadRecord* record = nullptr;
+
+    ~EpochThreadHandle()
+    {
+        if (record == nullptr)
+        {
+            return;
+        }
+        assert(record->pinDepth == 0);
+        if (!record->retired.empty())
+        {
+            EpochOrphans& orphans = GetEpochOrphans();
+            std::lock_guard lock(orphans.mutex);
+            orphans.retired.insert(orphans.retired.end(),
+                record->retired.begin(), record->retired.end());
+        }
+        record->retired = {};
+        record->retireCountSinceCollect = 0;
+        record->state.store(0, std::memory_order_release);
+        record->inUse.store(false, std::memory_order_release);
+        record = nullptr;
+    }
+};
+
+static thread_local EpochThreadHandle t_epochHandle;
+
+static EpochThreadRecord* GetEpochRecord()
+{
+    if (t_epochHandle.record == nullptr)
+    {
+        t_epochHandle.record = AcquireEpochRecord();
+    }
+    return t_epochHandle.record;
+}
+
+// Advance the global epoch if all pinned threads have observed the current one.
+static uint64_t TryAdvanceEpoch()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t globalEpoch = g_epoch.load(std::memory_order_seq_cst);
+    for (EpochThreadRecord* record = g_epochRecords.load(std::memory_order_acquire);
+        record != nullptr; record = record->next)
+    {
+        uint64_t state = record->state.load(std::memory_order_seq_cst);
+        if ((state & 1) && ((state >> 1) != globalEpoch))
+        {
+            return globalEpoch;
+        }
+    }
+    if (g_epoch.compare_exchange_strong(globalEpoch, globalEpoch + 1, std::memory_order_seq_cst))
+    {
+        return globalEpoch + 1;
+    }
+    return globalEpoch;
+}
+
+void EpochPin()
+{
+    EpochThreadRecord* record = GetEpochRecord();
+    if (record->pinDepth++ == 0)
+    {
+        record->state.store((g_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+void EpochUnpin()
+{
+    EpochThreadRecord* record = t_epochHandle.record;
+    assert(record && record->pinDepth > 0);
+    if (--record->pinDepth == 0)
+    {
+        record->state.store(0, std::memory_order_release);
+    }
+}
+
+bool EpochIsPinned()
+{
+    return t_epochHandle.record && (t_epochHandle.record->pinDepth > 0);
+}
+
+uint64_t EpochGetGlobal()
+{
+    return g_epoch.load(std::memory_order_acquire);
+}
+
+void EpochRetire(void* p, EpochDeleter deleter)
+{
+    EpochThreadRecord* record = GetEpochRecord();
+    record->retired.push_back({ p, deleter, g_epoch.load(std::memory_order_seq_cst) });
+    if (++record->retireCountSinceCollect >= EpochCollectInterval)
+    {
+        EpochCollect();
+    }
+}
+
+void EpochCollect()
+{
+    EpochThreadRecord* record = GetEpochRecord();
+    record->retireCountSinceCollect = 0;
+    const uint64_t globalEpoch = TryAdvanceEpoch();
+    FreeRetired(record->retired, globalEpoch);
+
+    EpochOrphans& orphans = GetEpochOrphans();
+    std::vector<EpochRetired> orphanRetired;
+    {
+        std::unique_lock lock(orphans.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || orphans.retired.empty())
+        {
+            return;
+        }
+        orphanRetired.swap(orphans.retired);
+    }
+    // Orphans from different threads are not sorted.
+    std::vector<EpochRetired> remained;
+    for (const EpochRetired& entry : orphanRetired)
+    {
+        if (entry.epoch + 2 <= globalEpoch)
+        {
+            entry.deleter(entry.p);
+        }
+        else
+        {
+            remained.push_back(entry);
+        }
+    }
+    if (!remained.empty())
+    {
+        std::lock_guard lock(orphans.mutex);
+        orphans.retired.insert(orphans.retired.end(), remained.begin(), remained.end());
+    }
+}
+
+void EpochFlush()
+{
+    assert(!EpochIsPinned());
+    EpochThreadRecord* record = GetEpochRecord();
+    EpochOrphans& orphans = GetEpochOrphans();
+    while (true)
+    {
+        EpochCollect();
+        bool hasOrphans = false;
+        {
+            std::lock_guard lock(orphans.mutex);
+            hasOrphans = !orphans.retired.empty();
+        }
+        if (record->retired.empty() && !hasOrphans)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+}
+
+} // namespace rad
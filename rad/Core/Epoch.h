@@ -0,0 +1,50 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <cstdint>
+
+namespace rad
+{
+
+// Epoch-based memory reclamation (EBR) for lock-free data structures:
+// readers pin the current epoch while accessing the shared objects (EpochGuard),
+// writers unlink an object and retire it; the retired objects are freed after the global epoch
+// has advanced twice, when no thread can still be pinned in the epoch in which they were unlinked.
+
+using EpochDeleter = void(*)(void* p);
+
+// Pin the current thread to the global epoch, can be nested.
+void EpochPin();
+void EpochUnpin();
+bool EpochIsPinned();
+uint64_t EpochGetGlobal();
+
+// Free the object with deleter when no thread can hold a reference to it,
+// the object must be unreachable for the threads pinned afterwards.
+void EpochRetire(void* p, EpochDeleter deleter);
+
+template<class T>
+void EpochRetire(T* p)
+{
+    EpochRetire(const_cast<void*>(static_cast<const void*>(p)),
+        [](void* p) { delete static_cast<T*>(p); });
+}
+
+// Try to advance the global epoch and free the objects retired by the current thread which are safe;
+// called automatically every a few retirements.
+void EpochCollect();
+// Wait until all objects retired by the current thread (and the exited threads) are freed;
+// must not be called while pinned.
+void EpochFlush();
+
+class EpochGuard
+{
+public:
+    EpochGuard() { EpochPin(); }
+    ~EpochGuard() { EpochUnpin(); }
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+}; // class EpochGuard
+
+} // namespace rad
@@ -0,0 +1,122 @@
+#include <rad/Core/Hash.h>
+#include <cstring>
+
+namespace rad
+{
+
+static constexpr uint64_t WyHashSecret[4] =
+{
+    0x2D358DCCAA6C78A5ull, 0x8BB84B93962EACC9ull, 0x4B33A62ED433D4A3ull, 0x4D5A2DA51DE1AA47ull,
+};
+
+static void WyMul(uint64_t& a, uint64_t& b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#elif defined(RAD_COMPILER_MSVC) && defined(RAD_ARCH_X86_64)
+    a = _umul128(a, b, &b);
+#else
+    const uint64_t aHigh = a >> 32;
+    const uint64_t aLow = a & 0xFFFFFFFF;
+    const uint64_t bHigh = b >> 32;
+    const uint64_t bLow = b & 0xFFFFFFFF;
+    const uint64_t hh = aHigh * bHigh;
+    const uint64_t hl = aHigh * bLow;
+    const uint64_t lh = aLow * bHigh;
+    const uint64_t ll = aLow * bLow;
+    const uint64_t t = ll + (hl << 32);
+    uint64_t low = t + (lh << 32);
+    uint64_t carry = (t < ll) + (low < t);
+    uint64_t high = hh + (hl >> 32) + (lh >> 32) + carry;
+    a = low;
+    b = high;
+#endif
+}
+
+static uint64_t WyMix(uint64_t a, uint64_t b)
+{
+    WyMul(a, b);
+    return a ^ b;
+}
+
+// Read as little-endian.
+static uint64_t WyRead8(const uint8_t* p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static uint64_t WyRead4(const uint8_t* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+static uint64_t WyRead3(const uint8_t* p, size_t k)
+{
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+uint64_t WyHash(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint64_t* secret = WyHashSecret;
+    seed ^= WyMix(seed ^ secret[0], secret[1]);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16) [[likely]]
+    {
+        if (size >= 4) [[likely]]
+        {
+            a = (WyRead4(p) << 32) | WyRead4(p + ((size >> 3) << 2));
+            b = (WyRead4(p + size - 4) << 32) | WyRead4(p + size - 4 - ((size >> 3) << 2));
+        }
+        else if (size > 0) [[likely]]
+        {
+            a = WyRead3(p, size);
+            b = 0;
+        }
+    }
+    else
+    {
+        size_t i = size;
+        if (i >= 48) [[unlikely]]
+        {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do
+            {
+                seed = WyMix(WyRead8(p) ^ secret[1], WyRead8(p + 8) ^ seed);
+                seed1 = WyMix(WyRead8(p + 16) ^ secret[2], WyRead8(p + 24) ^ seed1);
+                seed2 = WyMix(WyRead8(p + 32) ^ secret[3], WyRead8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16)
+        {
+            seed = WyMix(WyRead8(p) ^ secret[1], WyRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = WyRead8(p + i - 16);
+        b = WyRead8(p + i - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    WyMul(a, b);
+    return WyMix(a ^ secret[0] ^ size, b ^ secret[1]);
+}
+
+} // namespace rad
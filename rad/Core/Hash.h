@@ -0,0 +1,92 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(RAD_COMPILER_MSVC) && defined(RAD_ARCH_X86_64)
+#include <intrin.h>
+#endif
+
+namespace rad
+{
+
+// 64x64 -> 128-bit multiplication, return the low and the high halves xor-ed (the wyhash mum).
+inline uint64_t MulFold64(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#elif defined(RAD_COMPILER_MSVC) && defined(RAD_ARCH_X86_64)
+    uint64_t high = 0;
+    uint64_t low = _umul128(a, b, &high);
+    return low ^ high;
+#else
+    const uint64_t aLow = a & 0xFFFFFFFF;
+    const uint64_t aHigh = a >> 32;
+    const uint64_t bLow = b & 0xFFFFFFFF;
+    const uint64_t bHigh = b >> 32;
+    const uint64_t ll = aLow * bLow;
+    const uint64_t lh = aLow * bHigh;
+    const uint64_t hl = aHigh * bLow;
+    const uint64_t hh = aHigh * bHigh;
+    const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    const uint64_t low = (mid << 32) | (ll & 0xFFFFFFFF);
+    const uint64_t high = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return low ^ high;
+#endif
+}
+
+// Spread the entropy to all bits, for the hashes of poor quality (e.g. identity hashes of integers).
+inline uint64_t HashMix(uint64_t hash)
+{
+    return MulFold64(hash, 0x9E3779B97F4A7C15ull);
+}
+
+// wyhash (final version 4.2), by Wang Yi: https://github.com/wangyi-fudan/wyhash
+uint64_t WyHash(const void* data, size_t size, uint64_t seed = 0);
+
+inline uint64_t WyHash(std::string_view str, uint64_t seed = 0)
+{
+    return WyHash(str.data(), str.size(), seed);
+}
+
+// Default hasher of FlatHashMap/FlatHashSet: strings are hashed with wyhash (transparent,
+// can be probed with std::string_view or const char*); the others with std::hash,
+// or hash_value found by ADL (e.g. std::filesystem::path).
+template<class T>
+struct Hasher
+{
+    size_t operator()(const T& value) const
+    {
+        if constexpr (std::is_default_constructible_v<std::hash<T>>)
+        {
+            return std::hash<T>()(value);
+        }
+        else
+        {
+            return hash_value(value);
+        }
+    }
+};
+
+template<>
+struct Hasher<std::string>
+{
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const
+    {
+        return static_cast<size_t>(WyHash(str));
+    }
+};
+
+template<>
+struct Hasher<std::string_view> : Hasher<std::string>
+{
+};
+
+} // namespace rad
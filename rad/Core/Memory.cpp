@@ -1,13 +1,39 @@
 #include <rad/Core/Memory.h>
+#include <rad/Core/AllocTracker.h>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(RAD_OS_WINDOWS)
+#include <Windows.h>
+#include <malloc.h>
+#elif defined(RAD_OS_MACOS) || defined(RAD_OS_IPHONE)
+#include <malloc/malloc.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace rad
 {
 
-void* AlignedAlloc(std::size_t size, std::size_t alignment)
+// Untracked, for the allocators which track their own blocks.
+static void* AlignedAllocInternal(std::size_t size, std::size_t alignment)
 {
-    assert(size % alignment == 0);
+    assert((alignment & (alignment - 1)) == 0);
+    // std::aligned_alloc requires the size to be a multiple of the alignment.
+    size = (size + alignment - 1) & ~(alignment - 1);
 #if defined(RAD_OS_WINDOWS)
     return _aligned_malloc(size, alignment);
 #else
@@ -15,8 +41,36 @@ void* AlignedAlloc(std::size_t size, std::size_t alignment)
 #endif
 }
 
+// The same for the allocation and the free, which doesn't know the size and alignment requested.
+static std::size_t GetAlignedAllocUsableSize(void* p)
+{
+#if defined(RAD_OS_WINDOWS)
+    // The alignment only changes the constant overhead subtracted from the block size:
+    // pass the same one for all blocks so the allocation and the free count the same size.
+    return _aligned_msize(p, sizeof(void*), 0);
+#elif defined(RAD_OS_MACOS) || defined(RAD_OS_IPHONE)
+    return malloc_size(p);
+#else
+    return malloc_usable_size(p);
+#endif
+}
+
+void* AlignedAlloc(std::size_t size, std::size_t alignment)
+{
+    void* p = AlignedAllocInternal(size, alignment);
+    if (p && IsAllocTrackingEnabled())
+    {
+        TrackAllocSlow(AllocTag::Aligned, p, GetAlignedAllocUsableSize(p));
+    }
+    return p;
+}
+
 void AlignedFree(void* p)
 {
+    if (p && IsAllocTrackingEnabled())
+    {
+        TrackFreeSlow(AllocTag::Aligned, p, GetAlignedAllocUsableSize(p));
+    }
 #if defined(RAD_OS_WINDOWS)
     _aligned_free(p);
 #else
@@ -24,4 +78,840 @@ void AlignedFree(void* p)
 #endif
 }
 
+static std::size_t GetSystemPageSize()
+{
+#if defined(RAD_OS_WINDOWS)
+    SYSTEM_INFO info = {};
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    return std::size_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+static std::size_t AlignUp(std::size_t size, std::size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+#if defined(RAD_OS_LINUX) || defined(RAD_OS_ANDROID)
+// From linux/mempolicy.h, to avoid the dependency on libnuma.
+static constexpr int LinuxMpolBind = 2;
+static constexpr int LinuxMpolInterleave = 3;
+
+static bool ApplyNumaPolicy(void* data, std::size_t size, NumaPolicy policy, uint64_t nodeMask)
+{
+#if defined(SYS_mbind)
+    if ((policy == NumaPolicy::Default) || (nodeMask == 0))
+    {
+        return false;
+    }
+    const int mode = (policy == NumaPolicy::Bind) ? LinuxMpolBind : LinuxMpolInterleave;
+    unsigned long mask = static_cast<unsigned long>(nodeMask);
+    return (syscall(SYS_mbind, data, size, mode, &mask, sizeof(mask) * 8, 0) == 0);
+#else
+    return false;
+#endif
+}
+#endif
+
+LargeBuffer::~LargeBuffer()
+{
+    Free();
+}
+
+LargeBuffer::LargeBuffer(LargeBuffer&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+LargeBuffer& LargeBuffer::operator=(LargeBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Free();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_mappedSize, other.m_mappedSize);
+        std::swap(m_pageSize, other.m_pageSize);
+        std::swap(m_isNumaApplied, other.m_isNumaApplied);
+    }
+    return *this;
+}
+
+bool LargeBuffer::Allocate(std::size_t size, const LargeBufferOptions& options)
+{
+    Free();
+    if (size == 0)
+    {
+        return false;
+    }
+    const std::size_t systemPageSize = GetSystemPageSize();
+#if defined(RAD_OS_WINDOWS)
+    if (options.pageMode != LargePageMode::None)
+    {
+        // Requires SeLockMemoryPrivilege.
+        const std::size_t largePageSize = GetLargePageMinimum();
+        if (largePageSize > 0)
+        {
+            const std::size_t mappedSize = AlignUp(size, largePageSize);
+            m_data = VirtualAlloc(nullptr, mappedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (m_data)
+            {
+                m_mappedSize = mappedSize;
+                m_pageSize = largePageSize;
+            }
+        }
+    }
+    if (m_data == nullptr)
+    {
+        const std::size_t mappedSize = AlignUp(size, systemPageSize);
+        m_data = VirtualAlloc(nullptr, mappedSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (m_data == nullptr)
+        {
+            return false;
+        }
+        m_mappedSize = mappedSize;
+        m_pageSize = systemPageSize;
+    }
+#else
+#if defined(MAP_HUGETLB)
+    // The page size is encoded in the flags: log2(size) << MAP_HUGE_SHIFT.
+    constexpr int HugeShift = 26;
+    struct ExplicitPage
+    {
+        std::size_t size;
+        int flags;
+    };
+    constexpr ExplicitPage explicitPages[] =
+    {
+        { std::size_t(1) << 30, MAP_HUGETLB | (30 << HugeShift) },
+        { std::size_t(2) << 20, MAP_HUGETLB | (21 << HugeShift) },
+    };
+    std::size_t explicitPageIndex = std::size(explicitPages);
+    if (options.pageMode == LargePageMode::Explicit1G)
+    {
+        explicitPageIndex = 0;
+    }
+    else if (options.pageMode == LargePageMode::Explicit2M)
+    {
+        explicitPageIndex = 1;
+    }
+    for (; explicitPageIndex < std::size(explicitPages); ++explicitPageIndex)
+    {
+        const ExplicitPage& page = explicitPages[explicitPageIndex];
+        const std::size_t mappedSize = AlignUp(size, page.size);
+        void* data = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | page.flags, -1, 0);
+        if (data != MAP_FAILED)
+        {
+            m_data = data;
+            m_mappedSize = mappedSize;
+            m_pageSize = page.size;
+            break;
+        }
+    }
+#endif
+    if (m_data == nullptr)
+    {
+        // Align to 2 MiB for transparent huge pages: map more and trim.
+        const std::size_t hugePageSize = std::size_t(2) << 20;
+        const bool useHugePages = (options.pageMode != LargePageMode::None) && (size >= hugePageSize);
+        const std::size_t alignment = useHugePages ? hugePageSize : systemPageSize;
+        const std::size_t mappedSize = AlignUp(size, alignment);
+        const std::size_t reserveSize = mappedSize + alignment - systemPageSize;
+        char* reserved = static_cast<char*>(mmap(nullptr, reserveSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (reserved == MAP_FAILED)
+        {
+            return false;
+        }
+        char* data = reinterpret_cast<char*>(AlignUp(reinterpret_cast<std::uintptr_t>(reserved), alignment));
+        if (data > reserved)
+        {
+            munmap(reserved, data - reserved);
+        }
+        if (data + mappedSize < reserved + reserveSize)
+        {
+            munmap(data + mappedSize, (reserved + reserveSize) - (data + mappedSize));
+        }
+        m_data = data;
+        m_mappedSize = mappedSize;
+        m_pageSize = systemPageSize;
+#if defined(MADV_HUGEPAGE)
+        if (useHugePages && (madvise(data, mappedSize, MADV_HUGEPAGE) == 0))
+        {
+            m_pageSize = hugePageSize;
+        }
+#endif
+    }
+#if defined(RAD_OS_LINUX) || defined(RAD_OS_ANDROID)
+    m_isNumaApplied = ApplyNumaPolicy(m_data, m_mappedSize, options.numaPolicy, options.numaNodeMask);
+#endif
+#endif
+    m_size = size;
+    TrackAlloc(AllocTag::LargeBuffer, m_data, m_mappedSize);
+    if (options.prefault)
+    {
+        Prefault(m_data, m_mappedSize, m_pageSize, options.prefaultThreadCount);
+    }
+    return true;
+}
+
+void LargeBuffer::Free()
+{
+    if (m_data)
+    {
+        TrackFree(AllocTag::LargeBuffer, m_data, m_mappedSize);
+#if defined(RAD_OS_WINDOWS)
+        VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+        munmap(m_data, m_mappedSize);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_mappedSize = 0;
+        m_pageSize = 0;
+        m_isNumaApplied = false;
+    }
+}
+
+VirtualBuffer::~VirtualBuffer()
+{
+    Release();
+}
+
+VirtualBuffer::VirtualBuffer(VirtualBuffer&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+VirtualBuffer& VirtualBuffer::operator=(VirtualBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_dirtySize, other.m_dirtySize);
+        std::swap(m_committedSize, other.m_committedSize);
+        std::swap(m_reservedSize, other.m_reservedSize);
+        std::swap(m_pageSize, other.m_pageSize);
+    }
+    return *this;
+}
+
+bool VirtualBuffer::Reserve(std::size_t maxSize)
+{
+    Release();
+    if (maxSize == 0)
+    {
+        return false;
+    }
+    const std::size_t pageSize = GetSystemPageSize();
+    const std::size_t reservedSize = AlignUp(maxSize, pageSize);
+#if defined(RAD_OS_WINDOWS)
+    void* data = VirtualAlloc(nullptr, reservedSize, MEM_RESERVE, PAGE_NOACCESS);
+    if (data == nullptr)
+    {
+        return false;
+    }
+#else
+    void* data = mmap(nullptr, reservedSize, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+#endif
+    m_data = static_cast<uint8_t*>(data);
+    m_reservedSize = reservedSize;
+    m_pageSize = pageSize;
+    return true;
+}
+
+void VirtualBuffer::Release()
+{
+    if (m_data)
+    {
+        Decommit(0);
+#if defined(RAD_OS_WINDOWS)
+        VirtualFree(m_data, 0, MEM_RELEASE);
+#else
+        munmap(m_data, m_reservedSize);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_dirtySize = 0;
+        m_committedSize = 0;
+        m_reservedSize = 0;
+        m_pageSize = 0;
+    }
+}
+
+bool VirtualBuffer::Commit(std::size_t size)
+{
+    if (size <= m_committedSize)
+    {
+        return true;
+    }
+    if (size > m_reservedSize)
+    {
+        return false;
+    }
+    const std::size_t granularity = AlignUp(CommitGranularity, m_pageSize);
+    const std::size_t committedSize = (std::min)(AlignUp(size, granularity), m_reservedSize);
+    uint8_t* begin = m_data + m_committedSize;
+    const std::size_t commitSize = committedSize - m_committedSize;
+#if defined(RAD_OS_WINDOWS)
+    if (VirtualAlloc(begin, commitSize, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+    {
+        return false;
+    }
+#else
+    if (mprotect(begin, commitSize, PROT_READ | PROT_WRITE) != 0)
+    {
+        return false;
+    }
+#endif
+    TrackAlloc(AllocTag::VirtualBuffer, begin, commitSize);
+    m_committedSize = committedSize;
+    return true;
+}
+
+void VirtualBuffer::Decommit(std::size_t size)
+{
+    const std::size_t committedSize = AlignUp(size, m_pageSize);
+    if (committedSize >= m_committedSize)
+    {
+        return;
+    }
+    uint8_t* begin = m_data + committedSize;
+    const std::size_t decommitSize = m_committedSize - committedSize;
+    TrackFree(AllocTag::VirtualBuffer, begin, decommitSize);
+#if defined(RAD_OS_WINDOWS)
+    VirtualFree(begin, decommitSize, MEM_DECOMMIT);
+#else
+    // Return the pages to the system, they are zero-filled on the next access.
+    madvise(begin, decommitSize, MADV_DONTNEED);
+    mprotect(begin, decommitSize, PROT_NONE);
+#endif
+    m_committedSize = committedSize;
+    m_dirtySize = (std::min)(m_dirtySize, committedSize);
+}
+
+bool VirtualBuffer::Resize(std::size_t size)
+{
+    if (!Commit(size))
+    {
+        return false;
+    }
+    // The bytes left by a shrink or Clear are still committed: zero them when exposed again,
+    // the pages beyond the dirty size are zero already.
+    const std::size_t dirtyEnd = (std::min)(size, m_dirtySize);
+    if (dirtyEnd > m_size)
+    {
+        std::memset(m_data + m_size, 0, dirtyEnd - m_size);
+    }
+    m_size = size;
+    m_dirtySize = (std::max)(m_dirtySize, size);
+    return true;
+}
+
+void* VirtualBuffer::Append(const void* data, std::size_t size)
+{
+    const std::size_t offset = m_size;
+    // The appended bytes are overwritten, no need to zero them as Resize does.
+    if ((size > m_reservedSize - offset) || !Commit(offset + size))
+    {
+        return nullptr;
+    }
+    if (size > 0)
+    {
+        std::memcpy(m_data + offset, data, size);
+    }
+    m_size = offset + size;
+    m_dirtySize = (std::max)(m_dirtySize, m_size);
+    return m_data + offset;
+}
+
+void VirtualBuffer::ShrinkToFit()
+{
+    Decommit(m_size);
+}
+
+void Prefault(void* data, std::size_t size, std::size_t pageSize, uint32_t threadCount)
+{
+    if ((data == nullptr) || (size == 0))
+    {
+        return;
+    }
+    // Touch every system page, the huge pages are faulted by the first touch anyway.
+    const std::size_t touchStride = (std::min)(pageSize, GetSystemPageSize());
+    const std::size_t pageCount = (size + pageSize - 1) / pageSize;
+    if (threadCount == 0)
+    {
+        threadCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = uint32_t((std::min<std::size_t>)(threadCount, pageCount));
+    auto touch = [=](std::size_t pageBegin, std::size_t pageEnd) {
+        volatile char* bytes = static_cast<volatile char*>(data);
+        const std::size_t end = (std::min)(pageEnd * pageSize, size);
+        for (std::size_t offset = pageBegin * pageSize; offset < end; offset += touchStride)
+        {
+            bytes[offset] = 0;
+        }
+    };
+    if (threadCount <= 1)
+    {
+        touch(0, pageCount);
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    const std::size_t pagesPerThread = (pageCount + threadCount - 1) / threadCount;
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        const std::size_t pageBegin = i * pagesPerThread;
+        const std::size_t pageEnd = (std::min)(pageBegin + pagesPerThread, pageCount);
+        if (pageBegin < pageEnd)
+        {
+            threads.emplace_back(touch, pageBegin, pageEnd);
+        }
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+static constexpr std::size_t PoolSizeClassCount = PoolMaxBlockSize / PoolBlockAlignment;
+static constexpr std::size_t PoolSlabSize = 64 * 1024;
+static constexpr std::size_t PoolCacheLineSize = 64;
+static constexpr uint32_t PoolBatchSize = 32;
+
+struct PoolFreeBlock
+{
+    PoolFreeBlock* next;
+};
+
+struct PoolBatch
+{
+    PoolFreeBlock* head;
+    uint32_t count;
+};
+
+struct alignas(PoolCacheLineSize) PoolSizeClass
+{
+    std::mutex mutex;
+    std::vector<PoolBatch> depot;
+    std::size_t depotCount = 0;
+    std::size_t reservedSize = 0;
+    std::atomic<std::ptrdiff_t> allocatedCount = 0;
+};
+
+static PoolSizeClass* GetPoolSizeClasses()
+{
+    // Never destroyed: the blocks may be freed after the static destruction.
+    static PoolSizeClass* sizeClasses = new PoolSizeClass[PoolSizeClassCount];
+    return sizeClasses;
+}
+
+static std::size_t GetPoolSizeClassIndex(std::size_t size)
+{
+    return (size == 0) ? 0 : (size - 1) / PoolBlockAlignment;
+}
+
+// Get a batch from the depot, or carve a new slab.
+static PoolBatch PoolFetchBatch(std::size_t classIndex)
+{
+    PoolSizeClass& sizeClass = GetPoolSizeClasses()[classIndex];
+    std::lock_guard lock(sizeClass.mutex);
+    if (!sizeClass.depot.empty())
+    {
+        PoolBatch batch = sizeClass.depot.back();
+        sizeClass.depot.pop_back();
+        sizeClass.depotCount -= batch.count;
+        return batch;
+    }
+    char* slab = static_cast<char*>(AlignedAllocInternal(PoolSlabSize, PoolCacheLineSize));
+    if (slab == nullptr)
+    {
+        return { nullptr, 0 };
+    }
+    sizeClass.reservedSize += PoolSlabSize;
+    const std::size_t blockSize = (classIndex + 1) * PoolBlockAlignment;
+    const std::size_t blockCount = PoolSlabSize / blockSize;
+    // Link the blocks in the address order, split into batches.
+    PoolBatch batch = { nullptr, 0 };
+    for (std::size_t i = blockCount; i > 0; --i)
+    {
+        PoolFreeBlock* block = reinterpret_cast<PoolFreeBlock*>(slab + (i - 1) * blockSize);
+        block->next = batch.head;
+        batch.head = block;
+        if (++batch.count == PoolBatchSize && (i > 1))
+        {
+            sizeClass.depot.push_back(batch);
+            sizeClass.depotCount += batch.count;
+            batch = { nullptr, 0 };
+        }
+    }
+    return batch;
+}
+
+static void PoolReturnBatch(std::size_t classIndex, PoolBatch batch, std::ptrdiff_t allocatedCount)
+{
+    PoolSizeClass& sizeClass = GetPoolSizeClasses()[classIndex];
+    sizeClass.allocatedCount.fetch_add(allocatedCount, std::memory_order_relaxed);
+    if (batch.count > 0)
+    {
+        std::lock_guard lock(sizeClass.mutex);
+        sizeClass.depot.push_back(batch);
+        sizeClass.depotCount += batch.count;
+    }
+}
+
+// Trivially destructible (no lifetime end before the thread storage is released), so it can be accessed
+// during the destruction of the other thread_local objects; flushed by PoolThreadCacheFlusher at thread exit.
+struct PoolThreadCache
+{
+    struct FreeList
+    {
+        PoolFreeBlock* head;
+        uint32_t count;
+        // Allocations - frees since the last transfer.
+        std::ptrdiff_t allocatedCount;
+    };
+    FreeList freeLists[PoolSizeClassCount];
+};
+
+static thread_local PoolThreadCache t_poolCache = {};
+// Blocks allocated/freed after the cache is flushed (by the other thread_local destructors)
+// are transferred from/to the depot directly.
+static thread_local bool t_poolCacheFlushed = false;
+
+struct PoolThreadCacheFlusher
+{
+    ~PoolThreadCacheFlusher()
+    {
+        for (std::size_t i = 0; i < PoolSizeClassCount; ++i)
+        {
+            PoolThreadCache::FreeList& freeList = t_poolCache.freeLists[i];
+            PoolReturnBatch(i, { freeList.head, freeList.count }, freeList.allocatedCount);
+            freeList = {};
+        }
+        t_poolCacheFlushed = true;
+    }
+};
+
+// Return nullptr after the cache is flushed.
+static PoolThreadCache* GetPoolThreadCache()
+{
+    if (t_poolCacheFlushed)
+    {
+        return nullptr;
+    }
+    // Register the flush at the first use.
+    static thread_local PoolThreadCacheFlusher flusher;
+    (void)flusher;
+    return &t_poolCache;
+}
+
+static void* PoolAllocInternal(std::size_t size);
+
+void* PoolAlloc(std::size_t size)
+{
+    void* p = PoolAllocInternal(size);
+    TrackAlloc(AllocTag::Pool, p, size);
+    return p;
+}
+
+static void* PoolAllocInternal(std::size_t size)
+{
+    if (size > PoolMaxBlockSize)
+    {
+        return ::operator new(size);
+    }
+    const std::size_t classIndex = GetPoolSizeClassIndex(size);
+    PoolThreadCache* cache = GetPoolThreadCache();
+    if (cache == nullptr)
+    {
+        PoolBatch batch = PoolFetchBatch(classIndex);
+        if (batch.head == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        // Take one and return the rest.
+        PoolFreeBlock* block = batch.head;
+        PoolReturnBatch(classIndex, { block->next, batch.count - 1 }, 1);
+        return block;
+    }
+    PoolThreadCache::FreeList& freeList = cache->freeLists[classIndex];
+    if (freeList.head == nullptr)
+    {
+        PoolBatch batch = PoolFetchBatch(classIndex);
+        if (batch.head == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        freeList.head = batch.head;
+        freeList.count = batch.count;
+        GetPoolSizeClasses()[classIndex].allocatedCount.fetch_add(
+            freeList.allocatedCount, std::memory_order_relaxed);
+        freeList.allocatedCount = 0;
+    }
+    PoolFreeBlock* block = freeList.head;
+    freeList.head = block->next;
+    --freeList.count;
+    ++freeList.allocatedCount;
+    return block;
+}
+
+void PoolFree(void* p, std::size_t size) noexcept
+{
+    if (p == nullptr)
+    {
+        return;
+    }
+    TrackFree(AllocTag::Pool, p, size);
+    if (size > PoolMaxBlockSize)
+    {
+        ::operator delete(p, size);
+        return;
+    }
+    const std::size_t classIndex = GetPoolSizeClassIndex(size);
+    PoolThreadCache* cache = GetPoolThreadCache();
+    PoolFreeBlock* block = static_cast<PoolFreeBlock*>(p);
+    if (cache == nullptr)
+    {
+        block->next = nullptr;
+        PoolReturnBatch(classIndex, { block, 1 }, -1);
+        return;
+    }
+    PoolThreadCache::FreeList& freeList = cache->freeLists[classIndex];
+    block->next = freeList.head;
+    freeList.head = block;
+    ++freeList.count;
+    --freeList.allocatedCount;
+    // Keep at most two batches, transfer one to the depot.
+    if (freeList.count >= 2 * PoolBatchSize)
+    {
+        PoolBatch batch = { freeList.head, PoolBatchSize };
+        PoolFreeBlock* last = freeList.head;
+        for (uint32_t i = 1; i < PoolBatchSize; ++i)
+        {
+            last = last->next;
+        }
+        freeList.head = last->next;
+        freeList.count -= PoolBatchSize;
+        last->next = nullptr;
+        PoolReturnBatch(classIndex, batch, freeList.allocatedCount);
+        freeList.allocatedCount = 0;
+    }
+}
+
+PoolStats GetPoolStats(std::size_t size)
+{
+    PoolStats stats = {};
+    if (size > PoolMaxBlockSize)
+    {
+        return stats;
+    }
+    const std::size_t classIndex = GetPoolSizeClassIndex(size);
+    PoolSizeClass& sizeClass = GetPoolSizeClasses()[classIndex];
+    stats.blockSize = (classIndex + 1) * PoolBlockAlignment;
+    std::lock_guard lock(sizeClass.mutex);
+    stats.reservedSize = sizeClass.reservedSize;
+    stats.depotCount = sizeClass.depotCount;
+    stats.allocatedCount = std::size_t((std::max)(sizeClass.allocatedCount.load(std::memory_order_relaxed), std::ptrdiff_t(0)));
+    return stats;
+}
+
+struct Arena::Block
+{
+    Block* next;
+    std::size_t size;
+    bool isExternal;
+
+    std::uintptr_t GetBegin() noexcept
+    {
+        return reinterpret_cast<std::uintptr_t>(this) + sizeof(Block);
+    }
+};
+
+Arena::Arena(std::size_t blockSize) :
+    m_blockSize(blockSize)
+{
+}
+
+Arena::Arena(void* buffer, std::size_t bufferSize, std::size_t blockSize) :
+    m_blockSize(blockSize)
+{
+    // Place the block header at the aligned beginning of the buffer.
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(buffer);
+    std::uintptr_t aligned = (begin + alignof(Block) - 1) & ~std::uintptr_t(alignof(Block) - 1);
+    if (buffer && (aligned + sizeof(Block) <= begin + bufferSize))
+    {
+        m_first = ::new (reinterpret_cast<void*>(aligned)) Block{ nullptr,
+            bufferSize - (aligned - begin) - sizeof(Block), true };
+        SetCurrent(m_first, 0);
+    }
+}
+
+Arena::~Arena()
+{
+    Release();
+}
+
+void* Arena::AllocateSlow(std::size_t size, std::size_t alignment)
+{
+    // Try the blocks kept after the current one.
+    Block* block = m_current ? m_current->next : m_first;
+    while (block)
+    {
+        std::uintptr_t begin = block->GetBegin();
+        std::uintptr_t aligned = (begin + alignment - 1) & ~std::uintptr_t(alignment - 1);
+        const std::uintptr_t end = begin + block->size;
+        if ((aligned <= end) && (size <= end - aligned))
+        {
+            SetCurrent(block, aligned + size - begin);
+            return reinterpret_cast<void*>(aligned);
+        }
+        block = block->next;
+    }
+
+    if (size > SIZE_MAX - sizeof(Block) - alignment)
+    {
+        return nullptr;
+    }
+    const std::size_t blockSize = (std::max)(m_blockSize, size + alignment);
+    void* p = std::malloc(sizeof(Block) + blockSize);
+    if (p == nullptr)
+    {
+        return nullptr;
+    }
+    TrackAlloc(AllocTag::Arena, p, sizeof(Block) + blockSize);
+    block = ::new (p) Block{ nullptr, blockSize, false };
+    // Insert after the current block, so it is reused first after rewinding.
+    if (m_current)
+    {
+        block->next = m_current->next;
+        m_current->next = block;
+    }
+    else if (m_first)
+    {
+        block->next = m_first;
+        m_first = block;
+    }
+    else
+    {
+        m_first = block;
+    }
+    std::uintptr_t begin = block->GetBegin();
+    std::uintptr_t aligned = (begin + alignment - 1) & ~std::uintptr_t(alignment - 1);
+    SetCurrent(block, aligned + size - begin);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void Arena::SetCurrent(Block* block, std::size_t offset) noexcept
+{
+    m_current = block;
+    if (block)
+    {
+        m_ptr = block->GetBegin() + offset;
+        m_end = block->GetBegin() + block->size;
+    }
+    else
+    {
+        m_ptr = 0;
+        m_end = 0;
+    }
+}
+
+Arena::Marker Arena::GetMarker() const noexcept
+{
+    return { m_current, m_current ? (m_ptr - m_current->GetBegin()) : 0 };
+}
+
+void Arena::Rewind(const Marker& marker) noexcept
+{
+    SetCurrent(static_cast<Block*>(marker.block), marker.offset);
+}
+
+void Arena::Reset() noexcept
+{
+    SetCurrent(m_first, 0);
+}
+
+void Arena::Release() noexcept
+{
+    Block* external = nullptr;
+    Block* block = m_first;
+    while (block)
+    {
+        Block* next = block->next;
+        if (block->isExternal)
+        {
+            external = block;
+            external->next = nullptr;
+        }
+        else
+        {
+            TrackFree(AllocTag::Arena, block, sizeof(Block) + block->size);
+            std::free(block);
+        }
+        block = next;
+    }
+    m_first = external;
+    SetCurrent(nullptr, 0);
+}
+
+std::size_t Arena::GetUsedSize() const noexcept
+{
+    if (m_current == nullptr)
+    {
+        return 0;
+    }
+    std::size_t size = 0;
+    for (Block* block = m_first; block; block = block->next)
+    {
+        if (block == m_current)
+        {
+            return size + (m_ptr - block->GetBegin());
+        }
+        size += block->size;
+    }
+    return size;
+}
+
+std::size_t Arena::GetReservedSize() const noexcept
+{
+    std::size_t size = 0;
+    for (Block* block = m_first; block; block = block->next)
+    {
+        size += block->size;
+    }
+    return size;
+}
+
+void* ArenaResource::do_allocate(std::size_t size, std::size_t alignment)
+{
+    void* p = m_arena.Allocate(size, alignment);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* ArenaBoostResource::do_allocate(std::size_t size, std::size_t alignment)
+{
+    void* p = m_arena.Allocate(size, alignment);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
 } // namespace rad
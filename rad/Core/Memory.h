@@ -1,12 +1,423 @@
 #pragma once
 
 #include <rad/Core/Platform.h>
+#include <rad/Core/TypeTraits.h>
+#include <cstring>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <boost/container/pmr/memory_resource.hpp>
 
 namespace rad
 {
 
+// Move the objects [first, last) to the uninitialized memory at dest and destroy the sources,
+// return the end of dest; IsTriviallyRelocatable types are moved with memmove in bulk.
+// The ranges may overlap if dest is before first (e.g. compaction).
+template<class T>
+T* UninitializedRelocate(T* first, T* last, T* dest)
+{
+    if constexpr (IsTriviallyRelocatableV<T>)
+    {
+        if (first != last)
+        {
+            std::memmove(static_cast<void*>(dest), static_cast<const void*>(first),
+                std::size_t(last - first) * sizeof(T));
+        }
+        return dest + (last - first);
+    }
+    else if constexpr (std::is_nothrow_move_constructible_v<T>)
+    {
+        for (; first != last; ++first, ++dest)
+        {
+            std::construct_at(dest, std::move(*first));
+            std::destroy_at(first);
+        }
+        return dest;
+    }
+    else
+    {
+        // Copy to keep the sources intact if throws (as std::move_if_noexcept), the ranges must not overlap.
+        T* destLast = nullptr;
+        if constexpr (std::is_copy_constructible_v<T>)
+        {
+            destLast = std::uninitialized_copy(first, last, dest);
+        }
+        else
+        {
+            destLast = std::uninitialized_move(first, last, dest);
+        }
+        std::destroy(first, last);
+        return destLast;
+    }
+}
+
+template<class T>
+T* UninitializedRelocateN(T* first, std::size_t count, T* dest)
+{
+    return UninitializedRelocate(first, first + count, dest);
+}
+
+// Move the object at src to the uninitialized memory at dest and destroy the source.
+template<class T>
+T* RelocateAt(T* src, T* dest)
+{
+    if constexpr (IsTriviallyRelocatableV<T>)
+    {
+        std::memmove(static_cast<void*>(dest), static_cast<const void*>(src), sizeof(T));
+        return dest;
+    }
+    else
+    {
+        T* p = std::construct_at(dest, std::move(*src));
+        std::destroy_at(src);
+        return p;
+    }
+}
+
+// The size is rounded up to a multiple of the alignment (a power of two).
 void* AlignedAlloc(std::size_t size, std::size_t alignment);
 void AlignedFree(void* p);
 
+enum class LargePageMode
+{
+    None,           // The system page size.
+    Transparent,    // Transparent huge pages (madvise MADV_HUGEPAGE).
+    Explicit2M,     // Explicit 2 MiB huge pages (MAP_HUGETLB), fall back to Transparent.
+    Explicit1G,     // Explicit 1 GiB huge pages (MAP_HUGETLB), fall back to Explicit2M.
+};
+
+enum class NumaPolicy
+{
+    Default,        // First touch.
+    Bind,           // Allocate on the nodes in numaNodeMask.
+    Interleave,     // Interleave the pages across the nodes in numaNodeMask.
+};
+
+struct LargeBufferOptions
+{
+    LargePageMode pageMode = LargePageMode::Transparent;
+    NumaPolicy numaPolicy = NumaPolicy::Default;
+    uint64_t numaNodeMask = 0;
+    // Touch all pages on allocation (after the NUMA policy is applied).
+    bool prefault = false;
+    // 0 for std::thread::hardware_concurrency().
+    uint32_t prefaultThreadCount = 0;
+};
+
+// Large buffer (multi-MB/GB) mapped directly from the system (mmap/VirtualAlloc) with huge pages,
+// and the NUMA placement on Linux; the memory is zero-initialized.
+class LargeBuffer
+{
+public:
+    LargeBuffer() noexcept = default;
+    ~LargeBuffer();
+    LargeBuffer(const LargeBuffer&) = delete;
+    LargeBuffer& operator=(const LargeBuffer&) = delete;
+    LargeBuffer(LargeBuffer&& other) noexcept;
+    LargeBuffer& operator=(LargeBuffer&& other) noexcept;
+
+    bool Allocate(std::size_t size, const LargeBufferOptions& options = {});
+    void Free();
+
+    void* GetData() const noexcept { return m_data; }
+    // Size requested.
+    std::size_t GetSize() const noexcept { return m_size; }
+    // Size mapped, rounded up to the page size.
+    std::size_t GetMappedSize() const noexcept { return m_mappedSize; }
+    // The page size in effect (transparent huge pages are not guaranteed).
+    std::size_t GetPageSize() const noexcept { return m_pageSize; }
+    bool IsNumaApplied() const noexcept { return m_isNumaApplied; }
+
+private:
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_mappedSize = 0;
+    std::size_t m_pageSize = 0;
+    bool m_isNumaApplied = false;
+
+}; // class LargeBuffer
+
+// Growable byte buffer which reserves the address range up front and commits the pages on demand
+// (PROT_NONE mmap with mprotect/madvise, or VirtualAlloc MEM_RESERVE/MEM_COMMIT): growth never moves
+// the data, so the pointers into the buffer stay valid, and there is no copy on growth;
+// the bytes exposed by Resize are zero-initialized, also after a shrink, Clear or decommit.
+class VirtualBuffer
+{
+public:
+    // Pages are committed in chunks of at least this size to reduce the system calls.
+    static constexpr std::size_t CommitGranularity = 64 * 1024;
+
+    VirtualBuffer() noexcept = default;
+    ~VirtualBuffer();
+    VirtualBuffer(const VirtualBuffer&) = delete;
+    VirtualBuffer& operator=(const VirtualBuffer&) = delete;
+    VirtualBuffer(VirtualBuffer&& other) noexcept;
+    VirtualBuffer& operator=(VirtualBuffer&& other) noexcept;
+
+    // Reserve the address range of maxSize (rounded up to the page size), nothing is committed.
+    bool Reserve(std::size_t maxSize);
+    void Release();
+
+    // Commit the pages up to size, the new bytes read as zero;
+    // fail if size exceeds the reservation or out of memory.
+    bool Resize(std::size_t size);
+    // Append to the end, return the pointer to the appended bytes, or nullptr on failure.
+    void* Append(const void* data, std::size_t size);
+    void Clear() noexcept { m_size = 0; }
+    // Decommit the pages beyond the size, the address range remains reserved.
+    void ShrinkToFit();
+
+    void* GetData() const noexcept { return m_data; }
+    std::size_t GetSize() const noexcept { return m_size; }
+    std::size_t GetCommittedSize() const noexcept { return m_committedSize; }
+    std::size_t GetReservedSize() const noexcept { return m_reservedSize; }
+
+private:
+    bool Commit(std::size_t size);
+    void Decommit(std::size_t size);
+
+    uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+    // The committed bytes beyond this have never been written (still zero from the system).
+    std::size_t m_dirtySize = 0;
+    std::size_t m_committedSize = 0;
+    std::size_t m_reservedSize = 0;
+    std::size_t m_pageSize = 0;
+
+}; // class VirtualBuffer
+
+// Touch the pages of the range in parallel to take the page faults up front.
+void Prefault(void* data, std::size_t size, std::size_t pageSize, uint32_t threadCount = 0);
+
+// Size-class pool for small blocks (up to PoolMaxBlockSize, 16-byte aligned):
+// each thread caches free blocks per size class, and transfers them in batches to/from a global depot;
+// the blocks are carved from cache-line aligned slabs, which are never returned to the system.
+// Larger blocks fall back to the global operator new/delete; throw std::bad_alloc on failure.
+inline constexpr std::size_t PoolMaxBlockSize = 1024;
+inline constexpr std::size_t PoolBlockAlignment = 16;
+
+void* PoolAlloc(std::size_t size);
+// size must be the same as allocated.
+void PoolFree(void* p, std::size_t size) noexcept;
+
+struct PoolStats
+{
+    std::size_t blockSize;
+    // Bytes of the slabs.
+    std::size_t reservedSize;
+    // Blocks in use (approximate, the per-thread counters are merged on batch transfer).
+    std::size_t allocatedCount;
+    // Free blocks in the global depot.
+    std::size_t depotCount;
+};
+
+// Stats of the size class which serves size.
+PoolStats GetPoolStats(std::size_t size);
+
+// STL-compatible allocator with the size-class pool, single objects are pooled (e.g. list/map nodes).
+template<class T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template<class U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        if constexpr (alignof(T) <= PoolBlockAlignment)
+        {
+            if (n == 1)
+            {
+                return static_cast<T*>(PoolAlloc(sizeof(T)));
+            }
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        if constexpr (alignof(T) <= PoolBlockAlignment)
+        {
+            if (n == 1)
+            {
+                PoolFree(p, sizeof(T));
+                return;
+            }
+        }
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<class U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template<class U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+
+}; // class PoolAllocator
+
+// Inherit to allocate the objects of T from the size-class pool (class-specific operator new/delete).
+template<class T>
+class PoolAllocated
+{
+public:
+    static void* operator new(std::size_t size)
+    {
+        static_assert(alignof(T) <= PoolBlockAlignment);
+        return PoolAlloc(size);
+    }
+
+    static void operator delete(void* p, std::size_t size) noexcept
+    {
+        PoolFree(p, size);
+    }
+
+#if defined(RAD_COMPILER_MSVC) && defined(_DEBUG)
+    // RAD_NEW
+    static void* operator new(std::size_t size, int /*blockType*/, const char* /*fileName*/, int /*line*/)
+    {
+        return PoolAlloc(size);
+    }
+
+    static void operator delete(void* p, int /*blockType*/, const char* /*fileName*/, int /*line*/) noexcept
+    {
+        PoolFree(p, sizeof(T));
+    }
+#endif
+
+}; // class PoolAllocated
+
+// Growable bump allocator: allocations are not freed individually, but all together by Reset,
+// or rewound to a marker; the blocks are kept for reuse until Release.
+// Destructors of the objects allocated are not called.
+class Arena
+{
+public:
+    struct Marker
+    {
+        void* block;
+        std::size_t offset;
+    };
+
+    explicit Arena(std::size_t blockSize = 64 * 1024);
+    // Use the external buffer (e.g. on the stack) first.
+    Arena(void* buffer, std::size_t bufferSize, std::size_t blockSize = 64 * 1024);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Return nullptr on failure; alignment must be a power of two.
+    void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        std::uintptr_t begin = (m_ptr + alignment - 1) & ~std::uintptr_t(alignment - 1);
+        // Compare the size with the space left, begin + size can overflow.
+        if ((begin >= m_ptr) && (begin <= m_end) && (size <= m_end - begin) && (m_end != 0))
+        {
+            m_ptr = begin + size;
+            return reinterpret_cast<void*>(begin);
+        }
+        return AllocateSlow(size, alignment);
+    }
+
+    template<class T>
+    T* Allocate(std::size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template<class T, class... Args>
+    T* New(Args&&... args)
+    {
+        void* p = Allocate(sizeof(T), alignof(T));
+        return p ? ::new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    Marker GetMarker() const noexcept;
+    // Free all allocations after the marker.
+    void Rewind(const Marker& marker) noexcept;
+    // Free all allocations, keep the blocks.
+    void Reset() noexcept;
+    // Free all allocations and the blocks.
+    void Release() noexcept;
+
+    // Bytes allocated (including the alignment padding).
+    std::size_t GetUsedSize() const noexcept;
+    // Bytes of the blocks (including the external buffer).
+    std::size_t GetReservedSize() const noexcept;
+
+private:
+    struct Block;
+    void* AllocateSlow(std::size_t size, std::size_t alignment);
+    void SetCurrent(Block* block, std::size_t offset) noexcept;
+
+    std::size_t m_blockSize;
+    Block* m_first = nullptr;
+    Block* m_current = nullptr;
+    std::uintptr_t m_ptr = 0;
+    std::uintptr_t m_end = 0;
+
+}; // class Arena
+
+// Rewind the arena on destruction, for scratch allocations.
+class ArenaScope
+{
+public:
+    explicit ArenaScope(Arena& arena) :
+        m_arena(arena), m_marker(arena.GetMarker()) {}
+    ~ArenaScope() { m_arena.Rewind(m_marker); }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& m_arena;
+    Arena::Marker m_marker;
+
+}; // class ArenaScope
+
+// Adapt Arena to std::pmr containers, e.g. std::pmr::vector, std::pmr::string.
+class ArenaResource : public std::pmr::memory_resource
+{
+public:
+    explicit ArenaResource(Arena& arena) : m_arena(arena) {}
+    Arena& GetArena() { return m_arena; }
+
+protected:
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* /*p*/, std::size_t /*size*/, std::size_t /*alignment*/) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return (this == &other);
+    }
+
+private:
+    Arena& m_arena;
+
+}; // class ArenaResource
+
+// Adapt Arena to boost::container::pmr containers
+// and boost::json storage (boost::json::memory_resource).
+class ArenaBoostResource : public boost::container::pmr::memory_resource
+{
+public:
+    explicit ArenaBoostResource(Arena& arena) : m_arena(arena) {}
+    Arena& GetArena() { return m_arena; }
+
+protected:
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void do_deallocate(void* /*p*/, std::size_t /*size*/, std::size_t /*alignment*/) override {}
+    bool do_is_equal(const boost::container::pmr::memory_resource& other) const noexcept override
+    {
+        return (this == &other);
+    }
+
+private:
+    Arena& m_arena;
+
+}; // class ArenaBoostResource
+
 } // namespace rad
+
+RAD_TRIVIALLY_RELOCATABLE(rad::LargeBuffer);
+RAD_TRIVIALLY_RELOCATABLE(rad::VirtualBuffer);
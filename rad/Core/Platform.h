@@ -209,11 +209,11 @@
 #endif  // defined(RAD_ARCH_X86)
 
 #if defined(RAD_ARCH_ANY_ARM)
-#if defined(__ARM_NEON__)
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
 #define RAD_COMPILED_ANY_ARM_NEON 1
 #else
 #define RAD_COMPILED_ANY_ARM_NEON 0
-#endif  //  defined(__ARM_NEON__)
+#endif  //  defined(__ARM_NEON__) || defined(__ARM_NEON)
 #endif  //  defined(RAD_ARCH_ANY_ARM)
 
 #if defined(RAD_ARCH_MIPS)
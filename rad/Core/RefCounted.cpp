@@ -0,0 +1,222 @@
+#include <rad/Core/RefCounted.h>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rad
+{
+
+struct RefCountedRelease
+{
+    RefCounterThreadBiased* counter;
+    const void* object;
+    RefCountedDestroyFunc destroy;
+};
+
+// Releases queued to the alive owner threads, indexed by thread serial numbers.
+struct RefCountedReleaseQueues
+{
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::vector<RefCountedRelease>> queues;
+};
+
+static RefCountedReleaseQueues& GetReleaseQueues()
+{
+    // Never destroyed: threads may exit after the static destruction.
+    static RefCountedReleaseQueues* queues = new RefCountedReleaseQueues();
+    return *queues;
+}
+
+static std::atomic<uint64_t> g_threadSerialCounter = 0;
+static constexpr uint64_t ThreadSerialExited = std::numeric_limits<uint64_t>::max();
+static thread_local uint64_t t_threadSerial = 0;
+
+struct RefCountedThreadRecord
+{
+    uint64_t serial;
+
+    RefCountedThreadRecord()
+    {
+        serial = g_threadSerialCounter.fetch_add(1, std::memory_order_relaxed) + 1;
+        RefCountedReleaseQueues& queues = GetReleaseQueues();
+        std::lock_guard lock(queues.mutex);
+        queues.queues[serial];
+    }
+
+    ~RefCountedThreadRecord()
+    {
+        // Apply the queued releases until there is none, then unregister;
+        // the releases are applied by the other threads afterwards.
+        while (true)
+        {
+            RefCountedReleaseQueues& queues = GetReleaseQueues();
+            std::vector<RefCountedRelease> releases;
+            {
+                std::lock_guard lock(queues.mutex);
+                auto iter = queues.queues.find(serial);
+                if (iter->second.empty())
+                {
+                    queues.queues.erase(iter);
+                    break;
+                }
+                releases.swap(iter->second);
+            }
+            Apply(releases);
+        }
+        // The biased counters of this thread must not be touched anymore.
+        t_threadSerial = ThreadSerialExited;
+    }
+
+    static void Apply(std::vector<RefCountedRelease>& releases)
+    {
+        for (RefCountedRelease& release : releases)
+        {
+            if (release.counter->MergeBiased())
+            {
+                release.destroy(release.object);
+            }
+        }
+    }
+};
+
+uint64_t RefCounterThreadBiased::GetThreadSerial() noexcept
+{
+    if (t_threadSerial == 0)
+    {
+        static thread_local RefCountedThreadRecord record;
+        t_threadSerial = record.serial;
+    }
+    return t_threadSerial;
+}
+
+void RefCounterThreadBiased::MergeQueued()
+{
+    const uint64_t serial = GetThreadSerial();
+    if (serial == ThreadSerialExited)
+    {
+        return;
+    }
+    std::vector<RefCountedRelease> releases;
+    {
+        RefCountedReleaseQueues& queues = GetReleaseQueues();
+        std::lock_guard lock(queues.mutex);
+        releases.swap(queues.queues[serial]);
+    }
+    RefCountedThreadRecord::Apply(releases);
+}
+
+bool RefCounterThreadBiased::DecrementShared(const void* object, RefCountedDestroyFunc destroy) noexcept
+{
+    int64_t shared = m_shared.load(std::memory_order_relaxed);
+    while (true)
+    {
+        if (shared == 0)
+        {
+            // The shared counter would go negative for the first time: hand the reference to the owner thread.
+            if (m_shared.compare_exchange_weak(shared, Queued,
+                std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return QueueRelease(object, destroy);
+            }
+        }
+        else if (m_shared.compare_exchange_weak(shared, shared - SharedOne,
+            std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            // The shared counter is the total count once merged.
+            return ((shared & Merged) && ((shared >> SharedShift) == 1));
+        }
+    }
+}
+
+bool RefCounterThreadBiased::QueueRelease(const void* object, RefCountedDestroyFunc destroy) noexcept
+{
+    RefCountedReleaseQueues& queues = GetReleaseQueues();
+    std::lock_guard lock(queues.mutex);
+    auto iter = queues.queues.find(m_owner);
+    if (iter != queues.queues.end())
+    {
+        iter->second.push_back({ this, object, destroy });
+        return false;
+    }
+    // The owner exited (its writes to the biased counter are visible through the mutex),
+    // merge in the mutual exclusion.
+    return MergeBiased();
+}
+
+bool RefCounterThreadBiased::MergeBiased() noexcept
+{
+    const int64_t biased = int64_t(m_biased.load(std::memory_order_relaxed));
+    m_biased.store(0, std::memory_order_relaxed);
+    m_isMerged = true;
+    int64_t shared = m_shared.load(std::memory_order_relaxed);
+    int64_t merged = 0;
+    do
+    {
+        // Add the biased counter, and release the reference held by the queue.
+        merged = ((shared & ~(Queued | Merged)) + (biased - 1) * SharedOne) | Merged;
+    } while (!m_shared.compare_exchange_weak(shared, merged,
+        std::memory_order_acq_rel, std::memory_order_relaxed));
+    assert((merged >> SharedShift) >= 0);
+    return ((merged >> SharedShift) == 0);
+}
+
+DeferredDestroyQueue::DeferredDestroyQueue() :
+    m_owner(std::this_thread::get_id())
+{
+}
+
+DeferredDestroyQueue::~DeferredDestroyQueue()
+{
+    Close();
+}
+
+void DeferredDestroyQueue::Push(const void* object, RefCountedDestroyFunc destroy)
+{
+    if (std::this_thread::get_id() != m_owner)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_isClosed.load(std::memory_order_relaxed))
+        {
+            m_entries.push_back({ object, destroy });
+            return;
+        }
+    }
+    destroy(object);
+}
+
+void DeferredDestroyQueue::Flush()
+{
+    assert(std::this_thread::get_id() == m_owner);
+    std::vector<Entry> entries;
+    while (true)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_entries.empty())
+            {
+                break;
+            }
+            entries.swap(m_entries);
+        }
+        // The destructors may push more.
+        for (const Entry& entry : entries)
+        {
+            entry.destroy(entry.object);
+        }
+        entries.clear();
+    }
+}
+
+void DeferredDestroyQueue::Close()
+{
+    assert(std::this_thread::get_id() == m_owner);
+    {
+        std::lock_guard lock(m_mutex);
+        m_isClosed.store(true, std::memory_order_release);
+    }
+    // The objects pushed before closed.
+    Flush();
+}
+
+} // namespace rad
@@ -1,61 +1,406 @@
 #pragma once
 
 #include <rad/Core/Platform.h>
+#include <rad/Core/AllocTracker.h>
+#include <rad/Core/Epoch.h>
+#include <rad/Core/TypeTraits.h>
 #include <cassert>
 #include <memory>
 #include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace rad
 {
 
-template<typename T>
+// Reference counter policies:
+// - RefCounterAtomic: thread-safe, the default.
+// - RefCounterNonAtomic: for objects never shared across threads, no locked RMW.
+// - RefCounterThreadBiased: biased reference counting, the owner thread (the creator) counts
+//   with plain loads/stores, and the other threads count atomically in a shared counter:
+//   https://dl.acm.org/doi/10.1145/3243176.3243195
+// A policy provides Increment, Decrement (return true if the object should be destroyed now) and Get;
+// WeakRef requires TryIncrement (increment if not zero), which RefCounterThreadBiased doesn't support.
+// The object is deleted when the count drops to zero, unless the class T declares a destroy hook:
+// static void DestroyRefCounted(const T* p); e.g. to recycle into a pool, or defer to another thread.
+
+using RefCountedDestroyFunc = void(*)(const void* object);
+
+class RefCounterAtomic
+{
+public:
+    void Increment() noexcept
+    {
+        m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Increment if not zero (the object is not being destroyed).
+    bool TryIncrement() noexcept
+    {
+        size_t count = m_count.load(std::memory_order_relaxed);
+        while (count != 0)
+        {
+            if (m_count.compare_exchange_weak(count, count + 1, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Decrement(const void* /*object*/, RefCountedDestroyFunc /*destroy*/) noexcept
+    {
+        if (m_count.fetch_sub(1, std::memory_order_release) == 1)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+        return false;
+    }
+
+    size_t Get() const noexcept
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> m_count = 0;
+};
+
+class RefCounterNonAtomic
+{
+public:
+    void Increment() noexcept
+    {
+        ++m_count;
+    }
+
+    bool TryIncrement() noexcept
+    {
+        if (m_count != 0)
+        {
+            ++m_count;
+            return true;
+        }
+        return false;
+    }
+
+    bool Decrement(const void* /*object*/, RefCountedDestroyFunc /*destroy*/) noexcept
+    {
+        return (--m_count == 0);
+    }
+
+    size_t Get() const noexcept
+    {
+        return m_count;
+    }
+
+private:
+    size_t m_count = 0;
+};
+
+// The owner thread counts in the biased counter, the other threads count in the shared counter,
+// which may go negative when they release the references counted by the owner. When the shared
+// counter would go negative for the first time, the release is queued to the owner thread instead,
+// which merges the biased counter into the shared counter (and decides the destruction) when applying it;
+// the owner thread should call MergeQueued periodically (e.g. once per frame) to apply them.
+// The biased counter is also merged when it drops to zero, after that, all threads count in the shared counter.
+// The queue is processed when the owner thread exits, after that, the queued releases are merged immediately.
+class RefCounterThreadBiased
+{
+public:
+    RefCounterThreadBiased() noexcept :
+        m_owner(GetThreadSerial()) {}
+
+    void Increment() noexcept
+    {
+        if (IsBiased())
+        {
+            m_biased.store(m_biased.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_shared.fetch_add(SharedOne, std::memory_order_relaxed);
+        }
+    }
+
+    bool Decrement(const void* object, RefCountedDestroyFunc destroy) noexcept
+    {
+        if (IsBiased())
+        {
+            return DecrementBiased();
+        }
+        return DecrementShared(object, destroy);
+    }
+
+    // Approximate if modified concurrently.
+    size_t Get() const noexcept
+    {
+        const int64_t shared = m_shared.load(std::memory_order_relaxed);
+        // The release queued is not counted.
+        const int64_t queued = ((shared & (Queued | Merged)) == Queued) ? 1 : 0;
+        return size_t(int64_t(m_biased.load(std::memory_order_relaxed)) + (shared >> SharedShift) - queued);
+    }
+
+    // Apply the releases queued to the current thread.
+    static void MergeQueued();
+
+private:
+    static uint64_t GetThreadSerial() noexcept;
+
+    bool IsBiased() const noexcept
+    {
+        // m_isMerged is only accessed by the owner thread.
+        return (m_owner == GetThreadSerial()) && !m_isMerged;
+    }
+
+    // Only called by the owner thread before merged.
+    bool DecrementBiased() noexcept
+    {
+        const size_t biased = m_biased.load(std::memory_order_relaxed) - 1;
+        m_biased.store(biased, std::memory_order_relaxed);
+        if (biased > 0)
+        {
+            return false;
+        }
+        // The biased references are all released, the shared counter decides from now on;
+        // a queued release still holds its reference, the object is destroyed when it is applied.
+        m_isMerged = true;
+        const int64_t shared = m_shared.fetch_or(Merged, std::memory_order_acq_rel);
+        return ((shared >> SharedShift) == 0) && !(shared & Queued);
+    }
+
+    bool DecrementShared(const void* object, RefCountedDestroyFunc destroy) noexcept;
+    // Queue the release to the owner thread, or merge immediately if the owner exited.
+    bool QueueRelease(const void* object, RefCountedDestroyFunc destroy) noexcept;
+    // Apply the queued release: add the biased counter to the shared counter, and mark merged;
+    // only called by the owner thread, or other threads in mutual exclusion after the owner exited.
+    bool MergeBiased() noexcept;
+
+    friend struct RefCountedThreadRecord;
+
+    // m_shared: the shared counter (signed) << SharedShift | Queued | Merged.
+    static constexpr int64_t Merged = 1;
+    static constexpr int64_t Queued = 2;
+    static constexpr int SharedShift = 2;
+    static constexpr int64_t SharedOne = int64_t(1) << SharedShift;
+    // The serial number of the owner thread (never reused).
+    const uint64_t m_owner;
+    std::atomic<size_t> m_biased = 0;
+    bool m_isMerged = false;
+    std::atomic<int64_t> m_shared = 0;
+};
+
+// Shared by an object and its weak references, allocated when the first weak reference is created.
+class WeakRefControl
+{
+public:
+    WeakRefControl() noexcept {}
+    WeakRefControl(const WeakRefControl&) = delete;
+    WeakRefControl& operator=(const WeakRefControl&) = delete;
+
+    void AddRef() noexcept
+    {
+        m_refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void DecRef() noexcept
+    {
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    void Lock() noexcept
+    {
+        while (m_locked.exchange(true, std::memory_order_acquire))
+        {
+            while (m_locked.load(std::memory_order_relaxed));
+        }
+    }
+
+    void Unlock() noexcept
+    {
+        m_locked.store(false, std::memory_order_release);
+    }
+
+    bool IsExpired() const noexcept
+    {
+        return m_expired.load(std::memory_order_acquire);
+    }
+
+    // Called before the object is destroyed, releases the reference of the object.
+    void Expire() noexcept
+    {
+        Lock();
+        m_expired.store(true, std::memory_order_release);
+        Unlock();
+        DecRef();
+    }
+
+private:
+    // Weak references + the object itself (until destroyed).
+    std::atomic<size_t> m_refCount = 1;
+    std::atomic<bool> m_locked = false;
+    std::atomic<bool> m_expired = false;
+
+}; // class WeakRefControl
+
+// Destroy objects on the thread which creates the queue (e.g. the render thread);
+// objects pushed on the other threads are destroyed in the next Flush.
+class DeferredDestroyQueue
+{
+public:
+    DeferredDestroyQueue();
+    ~DeferredDestroyQueue();
+    DeferredDestroyQueue(const DeferredDestroyQueue&) = delete;
+    DeferredDestroyQueue& operator=(const DeferredDestroyQueue&) = delete;
+
+    template<class T>
+    void Push(const T* p)
+    {
+        Push(p, [](const void* p) { delete static_cast<const T*>(p); });
+    }
+
+    void Push(const void* object, RefCountedDestroyFunc destroy);
+    // Destroy the objects queued, must be called on the owner thread.
+    void Flush();
+    // Flush, and stop queueing: the objects pushed later are destroyed immediately on the pushing thread;
+    // call before the resources the objects depend on are shut down, must be called on the owner thread.
+    void Close();
+    // Any thread can check, e.g. to skip releasing the resources shut down after closed.
+    bool IsClosed() const { return m_isClosed.load(std::memory_order_acquire); }
+
+private:
+    struct Entry
+    {
+        const void* object;
+        RefCountedDestroyFunc destroy;
+    };
+    std::thread::id m_owner;
+    std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    std::atomic<bool> m_isClosed = false;
+
+}; // class DeferredDestroyQueue
+
+template<class T, class Counter = RefCounterAtomic>
 class RefCounted;
 
-template<typename T>
-void AddRef(const RefCounted<T>* p);
-template<typename T>
-void DecRef(const RefCounted<T>* p);
+template<class T, class Counter>
+void AddRef(const RefCounted<T, Counter>* p);
+template<class T, class Counter>
+void DecRef(const RefCounted<T, Counter>* p);
+template<class T, class Counter>
+bool TryAddRef(const RefCounted<T, Counter>* p);
+template<class T, class Counter>
+WeakRefControl* GetWeakRefControl(const RefCounted<T, Counter>* p);
 
-template<class T>
+template<class T, class Counter>
 class RefCounted
 {
 public:
-    RefCounted() noexcept :
-        m_refCount(0) {}
-    RefCounted(RefCounted const&) noexcept :
-        m_refCount(0) {}
+    using CounterType = Counter;
+
+    RefCounted() noexcept
+    {
+        TrackAlloc(AllocTag::RefCounted, this, sizeof(T));
+    }
+
+    RefCounted(RefCounted const&) noexcept
+    {
+        TrackAlloc(AllocTag::RefCounted, this, sizeof(T));
+    }
+
+    ~RefCounted()
+    {
+        TrackFree(AllocTag::RefCounted, this, sizeof(T));
+    }
+
     // The reference count should not be modified after the assignment.
     RefCounted& operator=(RefCounted const&) noexcept { return *this; }
 
     size_t GetRefCount() const noexcept
     {
-        return m_refCount;
+        return m_refCount.Get();
     }
 
 private:
-    mutable std::atomic<size_t> m_refCount;
+    static void Destroy(const void* p)
+    {
+        const RefCounted* base = static_cast<const RefCounted*>(p);
+        if (WeakRefControl* weakControl = base->m_weakControl.load(std::memory_order_acquire))
+        {
+            weakControl->Expire();
+        }
+        if constexpr (requires(const T* object) { T::DestroyRefCounted(object); })
+        {
+            T::DestroyRefCounted(static_cast<const T*>(base));
+        }
+        else
+        {
+            delete static_cast<const T*>(base);
+        }
+    }
 
-    friend void AddRef<T>(const RefCounted<T>* p);
-    friend void DecRef<T>(const RefCounted<T>* p);
+    mutable Counter m_refCount;
+    // Allocated on demand, the strong-only objects pay nothing but the pointer.
+    mutable std::atomic<WeakRefControl*> m_weakControl = nullptr;
+
+    friend void AddRef<T, Counter>(const RefCounted<T, Counter>* p);
+    friend void DecRef<T, Counter>(const RefCounted<T, Counter>* p);
+    friend bool TryAddRef<T, Counter>(const RefCounted<T, Counter>* p);
+    friend WeakRefControl* GetWeakRefControl<T, Counter>(const RefCounted<T, Counter>* p);
 
 }; // class RefCounted
 
-template<class T>
-inline void AddRef(const RefCounted<T>* p)
+template<class T, class Counter>
+inline void AddRef(const RefCounted<T, Counter>* p)
 {
-    p->m_refCount.fetch_add(1, std::memory_order_relaxed);
+    p->m_refCount.Increment();
 }
 
-template<class T>
-inline void DecRef(const RefCounted<T>* p)
+template<class T, class Counter>
+inline void DecRef(const RefCounted<T, Counter>* p)
 {
-    if (p->m_refCount.fetch_sub(1, std::memory_order_release) == 1)
+    if (p->m_refCount.Decrement(p, &RefCounted<T, Counter>::Destroy))
     {
-        std::atomic_thread_fence(std::memory_order_acquire);
-        delete static_cast<const T*>(p);
+        RefCounted<T, Counter>::Destroy(p);
     }
 }
 
+template<class T, class Counter>
+inline bool TryAddRef(const RefCounted<T, Counter>* p)
+{
+    static_assert(requires(Counter& counter) { counter.TryIncrement(); },
+        "The counter policy doesn't support weak references!");
+    return p->m_refCount.TryIncrement();
+}
+
+// The caller must hold a strong reference.
+template<class T, class Counter>
+inline WeakRefControl* GetWeakRefControl(const RefCounted<T, Counter>* p)
+{
+    WeakRefControl* weakControl = p->m_weakControl.load(std::memory_order_acquire);
+    if (weakControl == nullptr)
+    {
+        WeakRefControl* newControl = new WeakRefControl();
+        if (p->m_weakControl.compare_exchange_strong(weakControl, newControl,
+            std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            weakControl = newControl;
+        }
+        else
+        {
+            delete newControl;
+        }
+    }
+    return weakControl;
+}
+
 template<class T>
 class Ref
 {
@@ -208,6 +553,12 @@ private:
 
 }; // class Ref<T>
 
+// Holds a plain pointer, relocating it doesn't change the reference count.
+template<class T>
+struct IsTriviallyRelocatable<Ref<T>> : std::true_type
+{
+};
+
 template<class T, class U> inline bool operator==(Ref<T> const& lhs, Ref<U> const& rhs) noexcept
 {
     return lhs.get() == rhs.get();
@@ -313,6 +664,262 @@ template<class T, class U> Ref<T> dynamic_pointer_cast(Ref<U>&& p) noexcept
     return r;
 }
 
+// Ref<T> which can be loaded and exchanged atomically, with epoch-based reclamation (Epoch.h):
+// readers pin the epoch and load the pointer with a plain acquire load (wait-free, no shared writes);
+// writers swap the pointer and release the reference held after all readers pinned at the time have unpinned.
+// read() borrows the object for the guard lifetime without touching any reference count;
+// load() also takes a reference on the object (an atomic increment on its count).
+template<class T>
+class AtomicRef
+{
+public:
+    AtomicRef() noexcept = default;
+
+    AtomicRef(Ref<T> p) noexcept :
+        m_ptr(p.detach()) {}
+
+    // No reader can be accessing.
+    ~AtomicRef()
+    {
+        if (T* p = m_ptr.load(std::memory_order_acquire))
+        {
+            DecRef(p);
+        }
+    }
+
+    AtomicRef(const AtomicRef&) = delete;
+    AtomicRef& operator=(const AtomicRef&) = delete;
+
+    AtomicRef& operator=(Ref<T> p)
+    {
+        store(std::move(p));
+        return *this;
+    }
+
+    operator Ref<T>() const
+    {
+        return load();
+    }
+
+    static constexpr bool is_always_lock_free = std::atomic<T*>::is_always_lock_free;
+
+    bool is_lock_free() const noexcept
+    {
+        return m_ptr.is_lock_free();
+    }
+
+    // Keeps the current thread pinned, the object loaded is alive until the guard is destroyed.
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const AtomicRef& ref) :
+            m_ptr(ref.m_ptr.load(std::memory_order_acquire)) {}
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        T* get() const noexcept { return m_ptr; }
+        T& operator*() const noexcept { return *m_ptr; }
+        T* operator->() const noexcept { return m_ptr; }
+        explicit operator bool() const noexcept { return (m_ptr != nullptr); }
+
+    private:
+        // Pinned before the pointer is loaded.
+        EpochGuard m_guard;
+        T* m_ptr;
+
+    }; // class ReadGuard
+
+    ReadGuard read() const
+    {
+        return ReadGuard(*this);
+    }
+
+    Ref<T> load() const
+    {
+        EpochGuard guard;
+        return Ref<T>(m_ptr.load(std::memory_order_acquire));
+    }
+
+    void store(Ref<T> p)
+    {
+        Retire(m_ptr.exchange(p.detach(), std::memory_order_acq_rel));
+    }
+
+    Ref<T> exchange(Ref<T> p)
+    {
+        T* old = m_ptr.exchange(p.detach(), std::memory_order_acq_rel);
+        // The reference held is still alive.
+        Ref<T> ref(old);
+        Retire(old);
+        return ref;
+    }
+
+    // Compare the pointers, on failure, expected is updated with the current value.
+    bool compare_exchange_strong(Ref<T>& expected, Ref<T> desired)
+    {
+        T* current = expected.get();
+        if (m_ptr.compare_exchange_strong(current, desired.get(),
+            std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            desired.detach();
+            Retire(current);
+            return true;
+        }
+        expected = load();
+        return false;
+    }
+
+    bool compare_exchange_weak(Ref<T>& expected, Ref<T> desired)
+    {
+        return compare_exchange_strong(expected, std::move(desired));
+    }
+
+private:
+    // Release the reference held when no reader can be accessing the object.
+    static void Retire(T* p)
+    {
+        if (p)
+        {
+            EpochRetire(const_cast<void*>(static_cast<const void*>(p)),
+                [](void* object) { DecRef(static_cast<T*>(object)); });
+        }
+    }
+
+    std::atomic<T*> m_ptr = nullptr;
+
+}; // class AtomicRef<T>
+
+// Doesn't keep the object alive; lock() returns a strong reference if the object is still alive.
+template<class T>
+class WeakRef
+{
+public:
+    using element_type = T;
+
+    constexpr WeakRef() noexcept :
+        m_ptr(nullptr), m_control(nullptr) {}
+
+    // p must be kept alive by a strong reference.
+    WeakRef(T* p) :
+        m_ptr(p), m_control(nullptr)
+    {
+        if (m_ptr)
+        {
+            m_control = GetWeakRefControl(m_ptr);
+            m_control->AddRef();
+        }
+    }
+
+    template<class U>
+        requires std::is_convertible_v<U*, T*>
+    WeakRef(Ref<U> const& rhs) :
+        WeakRef(rhs.get()) {}
+
+    WeakRef(WeakRef const& rhs) noexcept :
+        m_ptr(rhs.m_ptr), m_control(rhs.m_control)
+    {
+        if (m_control)
+        {
+            m_control->AddRef();
+        }
+    }
+
+    template<class U>
+    WeakRef(WeakRef<U> const& rhs) noexcept :
+        m_ptr(rhs.m_ptr), m_control(rhs.m_control)
+    {
+        if (m_control)
+        {
+            m_control->AddRef();
+        }
+    }
+
+    WeakRef(WeakRef&& rhs) noexcept :
+        m_ptr(rhs.m_ptr), m_control(rhs.m_control)
+    {
+        rhs.m_ptr = nullptr;
+        rhs.m_control = nullptr;
+    }
+
+    ~WeakRef()
+    {
+        if (m_control)
+        {
+            m_control->DecRef();
+        }
+    }
+
+    WeakRef& operator=(WeakRef const& rhs) noexcept
+    {
+        WeakRef(rhs).swap(*this);
+        return *this;
+    }
+
+    WeakRef& operator=(WeakRef&& rhs) noexcept
+    {
+        WeakRef(static_cast<WeakRef&&>(rhs)).swap(*this);
+        return *this;
+    }
+
+    template<class U>
+        requires std::is_convertible_v<U*, T*>
+    WeakRef& operator=(Ref<U> const& rhs)
+    {
+        WeakRef(rhs).swap(*this);
+        return *this;
+    }
+
+    template<class U> friend class WeakRef;
+
+    // Promote to a strong reference, return null if the object has been destroyed (or is being destroyed).
+    Ref<T> lock() const
+    {
+        Ref<T> ref;
+        if (m_control)
+        {
+            m_control->Lock();
+            // The object can't be deleted before Expire acquires the lock.
+            if (!m_control->IsExpired() && TryAddRef(m_ptr))
+            {
+                ref.reset(m_ptr, false);
+            }
+            m_control->Unlock();
+        }
+        return ref;
+    }
+
+    bool expired() const noexcept
+    {
+        return (m_control == nullptr) || m_control->IsExpired();
+    }
+
+    void reset() noexcept
+    {
+        WeakRef().swap(*this);
+    }
+
+    void swap(WeakRef& rhs) noexcept
+    {
+        std::swap(m_ptr, rhs.m_ptr);
+        std::swap(m_control, rhs.m_control);
+    }
+
+private:
+    T* m_ptr = nullptr;
+    WeakRefControl* m_control = nullptr;
+
+}; // class WeakRef<T>
+
+template<class T>
+struct IsTriviallyRelocatable<WeakRef<T>> : std::true_type
+{
+};
+
+template<class T> void swap(WeakRef<T>& lhs, WeakRef<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
 } // namespace rad
 
 namespace std
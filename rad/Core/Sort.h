@@ -2,7 +2,12 @@
 
 #include <rad/Core/Platform.h>
 #include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
 #include <ranges>
+#include <type_traits>
 #include <vector>
 #include <numeric>
 
@@ -19,4 +24,176 @@ std::vector<size_t> SortIndices(const Range& r, Compare comp = {})
     return indices;
 }
 
+template<typename T>
+concept RadixSortable = (std::integral<T> && !std::same_as<T, bool>) || std::is_enum_v<T> ||
+    std::same_as<T, float> || std::same_as<T, double>;
+
+// Map to an unsigned integer of the same size, in the same order as operator<
+// (-0.0 and +0.0 compare equal and map to the same key; NaNs are at the ends).
+template<RadixSortable T>
+constexpr auto ToRadixKey(T value)
+{
+    if constexpr (std::is_enum_v<T>)
+    {
+        return ToRadixKey(static_cast<std::underlying_type_t<T>>(value));
+    }
+    else if constexpr (std::floating_point<T>)
+    {
+        using U = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        constexpr U signBit = U(1) << (sizeof(U) * 8 - 1);
+        // Equal keys keep the input order, so deduplication keeps the first of the zeros.
+        const U bits = std::bit_cast<U>((value == T(0)) ? T(0) : value);
+        // Negative: reverse the order of the magnitudes.
+        return static_cast<U>((bits & signBit) ? ~bits : (bits | signBit));
+    }
+    else if constexpr (std::is_signed_v<T>)
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<U>(static_cast<U>(value) ^ (U(1) << (sizeof(U) * 8 - 1)));
+    }
+    else
+    {
+        return value;
+    }
+}
+
+// Below this count, comparison sorts are faster than the radix passes.
+inline constexpr size_t RadixSortMinCount = 256;
+
+// Stable LSD radix sort of the indices by keys, 8 bits per pass;
+// the passes where all keys have the same digit are skipped.
+template<RadixSortable T>
+std::vector<size_t> RadixSortIndices(const T* keys, size_t count)
+{
+    std::vector<size_t> indices(count);
+    std::iota(indices.begin(), indices.end(), 0);
+    if (count < RadixSortMinCount)
+    {
+        std::stable_sort(indices.begin(), indices.end(),
+            [&](size_t i, size_t j) { return ToRadixKey(keys[i]) < ToRadixKey(keys[j]); });
+        return indices;
+    }
+
+    using Key = decltype(ToRadixKey(keys[0]));
+    constexpr size_t PassCount = sizeof(Key);
+    std::vector<Key> radixKeys(count);
+    size_t histograms[PassCount][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Key key = ToRadixKey(keys[i]);
+        radixKeys[i] = key;
+        for (size_t pass = 0; pass < PassCount; ++pass)
+        {
+            ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    std::vector<Key> tempKeys(count);
+    std::vector<size_t> tempIndices(count);
+    for (size_t pass = 0; pass < PassCount; ++pass)
+    {
+        size_t* histogram = histograms[pass];
+        const size_t shift = pass * 8;
+        if (histogram[(radixKeys[0] >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; ++digit)
+        {
+            const size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t dst = histogram[(radixKeys[i] >> shift) & 0xFF]++;
+            tempKeys[dst] = radixKeys[i];
+            tempIndices[dst] = indices[i];
+        }
+        radixKeys.swap(tempKeys);
+        indices.swap(tempIndices);
+    }
+    return indices;
+}
+
+// Stable LSD radix sort in ascending order, see RadixSortIndices.
+template<RadixSortable T>
+void RadixSort(T* data, size_t count)
+{
+    if (count < RadixSortMinCount)
+    {
+        std::stable_sort(data, data + count,
+            [](T a, T b) { return ToRadixKey(a) < ToRadixKey(b); });
+        return;
+    }
+
+    using Key = decltype(ToRadixKey(data[0]));
+    constexpr size_t PassCount = sizeof(Key);
+    size_t histograms[PassCount][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Key key = ToRadixKey(data[i]);
+        for (size_t pass = 0; pass < PassCount; ++pass)
+        {
+            ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+        }
+    }
+
+    std::vector<T> temp(count);
+    T* src = data;
+    T* dst = temp.data();
+    for (size_t pass = 0; pass < PassCount; ++pass)
+    {
+        size_t* histogram = histograms[pass];
+        const size_t shift = pass * 8;
+        if (histogram[(ToRadixKey(src[0]) >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t digit = 0; digit < 256; ++digit)
+        {
+            const size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[histogram[(ToRadixKey(src[i]) >> shift) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != data)
+    {
+        std::copy(src, src + count, data);
+    }
+}
+
+template<std::ranges::contiguous_range Range>
+    requires RadixSortable<std::ranges::range_value_t<Range>>
+void RadixSort(Range&& r)
+{
+    RadixSort(std::ranges::data(r), std::ranges::size(r));
+}
+
+// Binary search without unpredictable branches (the comparison result selects the next base
+// with a conditional move); return the index of the first element not less than value.
+template<typename T, typename U, typename Compare = std::less<>>
+size_t BranchlessLowerBound(const T* data, size_t count, const U& value, Compare comp = {})
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    const T* base = data;
+    while (count > 1)
+    {
+        const size_t half = count / 2;
+        base = comp(base[half], value) ? base + half : base;
+        count -= half;
+    }
+    return static_cast<size_t>(base - data) + (comp(*base, value) ? 1 : 0);
+}
+
 } // namespace rad
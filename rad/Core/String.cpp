@@ -1,13 +1,36 @@
 #include <rad/Core/String.h>
+#include <rad/Core/Hash.h>
+#include <bit>
+#include <cassert>
+#include <charconv>
 #include <cstdarg>
+#include <limits>
+#include <type_traits>
 
-#if defined(RAD_OS_WINDOWS)
-#include <Windows.h>
+#if defined(RAD_ARCH_X86) && RAD_COMPILED_X86_AVX2
+#define RAD_STRING_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(RAD_ARCH_X86) && RAD_COMPILED_X86_SSE2
+#define RAD_STRING_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(RAD_ARCH_AARCH64) && RAD_COMPILED_ANY_ARM_NEON
+#define RAD_STRING_NEON 1
+#include <arm_neon.h>
 #endif
 
 namespace rad
 {
 
+#if defined(RAD_STRING_NEON)
+// Narrow the 0x00/0xFF comparison result to a 64-bit mask, 4 bits for each byte.
+static uint64_t NeonMovemask4(uint8x16_t cmp)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+}
+#endif
+
 std::vector<std::string> StrSplit(
     std::string_view str, std::string_view delimiters, bool skipEmptySubStr)
 {
@@ -47,39 +70,59 @@ int StrPrintInPlace(std::string& buffer, const char* format, ...)
 {
     va_list args;
     va_start(args, format);
-    int charsPrinted = vsnprintf(buffer.data(), buffer.size(), format, args);
+    int charsPrinted = StrPrintInPlaceArgList(buffer, format, args);
     va_end(args);
-
-    if ((charsPrinted > 0) && (size_t(charsPrinted) + 1 > buffer.size()))
-    {
-        buffer.resize(size_t(charsPrinted) + 1);
-        va_start(args, format);
-        charsPrinted = vsnprintf(buffer.data(), buffer.size(), format, args);
-        va_end(args);
-    }
-    buffer.pop_back();
-
     return charsPrinted;
 }
 
 int StrPrintInPlaceArgList(std::string& buffer, const char* format, va_list args)
 {
-    va_list args1;
-    va_copy(args1, args);
-    int charsPrinted = vsnprintf(buffer.data(), buffer.size(), format, args1);
-    va_end(args1);
-
-    if ((charsPrinted > 0) && (size_t(charsPrinted) + 1 > buffer.size()))
+    int charsPrinted = 0;
+    // Print into data[0, size], return the length of the content, 0 if size is not enough.
+    auto print = [&](char* data, size_t size) -> size_t
     {
-        buffer.resize(size_t(charsPrinted) + 1);
+        va_list args1;
         va_copy(args1, args);
-        charsPrinted = vsnprintf(buffer.data(), buffer.size(), format, args1);
+        charsPrinted = vsnprintf(data, size + 1, format, args1);
         va_end(args1);
+        return ((charsPrinted >= 0) && (size_t(charsPrinted) <= size)) ? size_t(charsPrinted) : 0;
+    };
+
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    // Print into the existing capacity without initializing it (the null terminator is always writable),
+    // print again only if the capacity is not enough.
+    buffer.resize_and_overwrite(buffer.capacity(), print);
+    if ((charsPrinted >= 0) && (size_t(charsPrinted) > buffer.size()))
+    {
+        buffer.resize_and_overwrite(size_t(charsPrinted), print);
+    }
+#else
+    // Print short strings on the stack, resize would initialize the whole capacity.
+    char stackBuffer[1024];
+    const size_t length = print(stackBuffer, sizeof(stackBuffer) - 1);
+    if ((charsPrinted >= 0) && (size_t(charsPrinted) == length))
+    {
+        buffer.assign(stackBuffer, length);
+    }
+    else if (charsPrinted >= 0)
+    {
+        buffer.resize(size_t(charsPrinted));
+        print(buffer.data(), buffer.size());
+    }
+#endif
+    if (charsPrinted < 0)
+    {
+        buffer.clear();
     }
-    buffer.pop_back();
     return charsPrinted;
 }
 
+FormatBuffer<>& GetThreadFormatBuffer()
+{
+    thread_local FormatBuffer<> buffer;
+    return buffer;
+}
+
 bool StrEqual(std::string_view str1, std::string_view str2)
 {
     return (str1 == str2);
@@ -87,57 +130,162 @@ bool StrEqual(std::string_view str1, std::string_view str2)
 
 bool StrCaseEqual(std::string_view str1, std::string_view str2)
 {
-#if defined(RAD_COMPILER_MSVC)
-    return (_stricmp(str1.data(), str2.data()) == 0);
-#else
-    return (strcasecmp(str1.data(), str2.data()) == 0);
-#endif
+    return (str1.size() == str2.size()) && (StrCaseMismatch(str1, str2) == str1.size());
 }
 
 int StrCompare(std::string_view left, std::string_view right)
 {
-    return strcmp(left.data(), right.data());
+    return left.compare(right);
 }
 
 int StrCaseCompare(std::string_view left, std::string_view right)
 {
-    return strcasecmp(left.data(), right.data());
+    const size_t index = StrCaseMismatch(left, right);
+    if (index < left.size() && index < right.size())
+    {
+        return int(uint8_t(ToLowerAscii(left[index]))) - int(uint8_t(ToLowerAscii(right[index])));
+    }
+    return (left.size() < right.size()) ? -1 : ((left.size() > right.size()) ? 1 : 0);
+}
+
+#if defined(RAD_STRING_AVX2)
+static __m256i ToLowerAscii(__m256i v)
+{
+    __m256i isUpper = _mm256_and_si256(
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
 }
+#endif
 
-std::string StrWideToU8(std::wstring_view wstr)
+#if defined(RAD_STRING_SSE2)
+static __m128i ToLowerAscii(__m128i v)
 {
-#if defined(RAD_OS_WINDOWS)
-    std::string str;
-    int charCount = ::WideCharToMultiByte(CP_UTF8,
-        0, wstr.data(), static_cast<int>(wstr.length()), NULL, 0, NULL, NULL);
-    if (charCount > 0)
+    // Bytes >= 0x80 are negative, which are not in the range.
+    __m128i isUpper = _mm_and_si128(
+        _mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+    return _mm_or_si128(v, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+}
+#elif defined(RAD_STRING_NEON)
+static uint8x16_t ToLowerAscii(uint8x16_t v)
+{
+    uint8x16_t isUpper = vcltq_u8(vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(26));
+    return vorrq_u8(v, vandq_u8(isUpper, vdupq_n_u8(0x20)));
+}
+#endif
+
+template<bool CaseInsensitive>
+static size_t StrMismatchImpl(std::string_view str1, std::string_view str2)
+{
+    const size_t size = (std::min)(str1.size(), str2.size());
+    const char* p1 = str1.data();
+    const char* p2 = str2.data();
+    size_t i = 0;
+#if defined(RAD_STRING_AVX2)
+    for (; i + 32 <= size; i += 32)
     {
-        str.resize(charCount, 0);
-        ::WideCharToMultiByte(CP_UTF8,
-            0, wstr.data(), static_cast<int>(wstr.length()), &str[0], charCount, NULL, NULL);
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p1 + i));
+        __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p2 + i));
+        if constexpr (CaseInsensitive)
+        {
+            v1 = ToLowerAscii(v1);
+            v2 = ToLowerAscii(v2);
+        }
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, v2)));
+        if (mask != 0)
+        {
+            return i + std::countr_zero(mask);
+        }
+    }
+#endif
+#if defined(RAD_STRING_SSE2)
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1 + i));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p2 + i));
+        if constexpr (CaseInsensitive)
+        {
+            v1 = ToLowerAscii(v1);
+            v2 = ToLowerAscii(v2);
+        }
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v1, v2))) ^ 0xFFFF;
+        if (mask != 0)
+        {
+            return i + std::countr_zero(mask);
+        }
+    }
+#elif defined(RAD_STRING_NEON)
+    for (; i + 16 <= size; i += 16)
+    {
+        uint8x16_t v1 = vld1q_u8(reinterpret_cast<const uint8_t*>(p1 + i));
+        uint8x16_t v2 = vld1q_u8(reinterpret_cast<const uint8_t*>(p2 + i));
+        if constexpr (CaseInsensitive)
+        {
+            v1 = ToLowerAscii(v1);
+            v2 = ToLowerAscii(v2);
+        }
+        uint64_t mask = ~NeonMovemask4(vceqq_u8(v1, v2));
+        if (mask != 0)
+        {
+            return i + std::countr_zero(mask) / 4;
+        }
     }
-    return str;
-#else
-    return utf_to_utf<char>(wstr.data());
 #endif
+    for (; i < size; ++i)
+    {
+        if constexpr (CaseInsensitive)
+        {
+            if (ToLowerAscii(p1[i]) != ToLowerAscii(p2[i]))
+            {
+                break;
+            }
+        }
+        else
+        {
+            if (p1[i] != p2[i])
+            {
+                break;
+            }
+        }
+    }
+    return i;
+}
+
+size_t StrMismatch(std::string_view str1, std::string_view str2)
+{
+    return StrMismatchImpl<false>(str1, str2);
 }
 
-std::wstring StrU8ToWide(std::string_view str)
+size_t StrCaseMismatch(std::string_view str1, std::string_view str2)
 {
-#if defined(RAD_OS_WINDOWS)
-    std::wstring wstr;
-    int charCount = ::MultiByteToWideChar(CP_UTF8,
-        0, str.data(), static_cast<int>(str.length()), NULL, 0);
-    if (charCount > 0)
+    return StrMismatchImpl<true>(str1, str2);
+}
+
+char ToLowerAscii(char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? char(c | 0x20) : c;
+}
+
+size_t StrHash(std::string_view str)
+{
+    return static_cast<size_t>(WyHash(str));
+}
+
+size_t StrCaseHash(std::string_view str)
+{
+    // Hash the folded string in blocks, chained by the seed.
+    char buffer[256];
+    uint64_t hash = str.size();
+    while (!str.empty())
     {
-        wstr.resize(charCount, 0);
-        ::MultiByteToWideChar(CP_UTF8,
-            0, str.data(), static_cast<int>(str.length()), &wstr[0], charCount);
+        const size_t count = (std::min)(str.size(), sizeof(buffer));
+        for (size_t i = 0; i < count; ++i)
+        {
+            buffer[i] = ToLowerAscii(str[i]);
+        }
+        hash = WyHash(buffer, count, hash);
+        str.remove_prefix(count);
     }
-    return wstr;
-#else
-    return utf_to_utf<wchar_t>(str.data());
-#endif
+    return static_cast<size_t>(hash);
 }
 
 std::string StrUpper(std::string_view s)
@@ -170,6 +318,85 @@ void StrLowerInplace(std::string& s)
     }
 }
 
+// SWAR (SIMD within a register) digit parsing, 8 chars at a time:
+// https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+static constexpr bool g_enableSWAR = (std::endian::native == std::endian::little);
+
+static uint64_t LoadU64(const char* p)
+{
+    uint64_t chunk = 0;
+    std::memcpy(&chunk, p, sizeof(chunk));
+    return chunk;
+}
+
+static bool IsEightDigits(uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+        (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+static uint32_t ParseEightDigits(uint64_t chunk)
+{
+    const uint64_t mask = 0x000000FF000000FF;
+    const uint64_t mul1 = 100 + (1000000ull << 32);
+    const uint64_t mul2 = 1 + (10000ull << 32);
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(chunk);
+}
+
+static bool IsAllDigits(const char* p, const char* end)
+{
+    if constexpr (g_enableSWAR)
+    {
+        for (; end - p >= 8; p += 8)
+        {
+            if (!IsEightDigits(LoadU64(p)))
+            {
+                return false;
+            }
+        }
+    }
+    for (; p < end; ++p)
+    {
+        if (!IsDigit(*p))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Parse at most 19 digits, which always fit in uint64_t.
+static bool ParseDecDigits(const char* p, const char* end, uint64_t& value)
+{
+    assert(end - p <= 19);
+    uint64_t result = 0;
+    if constexpr (g_enableSWAR)
+    {
+        for (; end - p >= 8; p += 8)
+        {
+            const uint64_t chunk = LoadU64(p);
+            if (!IsEightDigits(chunk))
+            {
+                return false;
+            }
+            result = result * 100000000 + ParseEightDigits(chunk);
+        }
+    }
+    for (; p < end; ++p)
+    {
+        if (!IsDigit(*p))
+        {
+            return false;
+        }
+        result = result * 10 + uint64_t(*p - '0');
+    }
+    value = result;
+    return true;
+}
+
 bool StrIsDecInteger(std::string_view str)
 {
     if (str.empty())
@@ -184,14 +411,7 @@ bool StrIsDecInteger(std::string_view str)
             i++;
         }
     }
-    for (; i < str.size(); ++i)
-    {
-        if (!IsDigit(str[i]))
-        {
-            return false;
-        }
-    }
-    return true;
+    return IsAllDigits(str.data() + i, str.data() + str.size());
 }
 
 bool StrIsHexNumber(std::string_view str)
@@ -229,13 +449,14 @@ bool StrIsBinNumber(std::string_view str)
 bool StrIsNumeric(std::string_view str)
 {
     const char* p = str.data();
-    if ((*p == '-') || (*p == '+'))
+    const char* end = str.data() + str.size();
+    if ((p < end) && ((*p == '-') || (*p == '+')))
     {
         ++p;
     }
 
     bool hasDot = false;
-    while (*p != '\0')
+    while (p < end)
     {
         if (*p == '.')
         {
@@ -266,6 +487,503 @@ bool IsHexDigit(char c)
     return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
 }
 
+template<std::integral T>
+static bool StrToIntImpl(std::string_view str, T& value)
+{
+    const char* p = str.data();
+    const char* end = str.data() + str.size();
+    bool isNegative = false;
+    if ((p < end) && ((*p == '+') || (*p == '-')))
+    {
+        isNegative = (*p == '-');
+        ++p;
+    }
+    if (p == end)
+    {
+        return false;
+    }
+
+    if (end - p <= 19)
+    {
+        uint64_t magnitude = 0;
+        if (!ParseDecDigits(p, end, magnitude))
+        {
+            return false;
+        }
+        if constexpr (std::is_signed_v<T>)
+        {
+            const uint64_t limit = uint64_t(std::numeric_limits<T>::max()) + (isNegative ? 1 : 0);
+            if (magnitude > limit)
+            {
+                return false;
+            }
+            value = isNegative ? static_cast<T>(0 - magnitude) : static_cast<T>(magnitude);
+        }
+        else
+        {
+            if ((isNegative && (magnitude != 0)) || (magnitude > std::numeric_limits<T>::max()))
+            {
+                return false;
+            }
+            value = static_cast<T>(magnitude);
+        }
+        return true;
+    }
+
+    // Long digit sequences (leading zeros or overflow): fallback to std::from_chars.
+    if ((isNegative && std::is_unsigned_v<T>) || !IsAllDigits(p, end))
+    {
+        return false;
+    }
+    std::from_chars_result result = std::from_chars(isNegative ? p - 1 : p, end, value);
+    return (result.ec == std::errc());
+}
+
+bool StrToInt(std::string_view str, int32_t& value)
+{
+    return StrToIntImpl(str, value);
+}
+
+bool StrToInt(std::string_view str, int64_t& value)
+{
+    return StrToIntImpl(str, value);
+}
+
+bool StrToInt(std::string_view str, uint32_t& value)
+{
+    return StrToIntImpl(str, value);
+}
+
+bool StrToInt(std::string_view str, uint64_t& value)
+{
+    return StrToIntImpl(str, value);
+}
+
+template<std::unsigned_integral T>
+static bool StrToHexImpl(std::string_view str, T& value)
+{
+    if (str.starts_with("0x") || str.starts_with("0X"))
+    {
+        str.remove_prefix(2);
+    }
+    if (str.empty())
+    {
+        return false;
+    }
+    const char* end = str.data() + str.size();
+    T result = 0;
+    std::from_chars_result status = std::from_chars(str.data(), end, result, 16);
+    if ((status.ec == std::errc()) && (status.ptr == end))
+    {
+        value = result;
+        return true;
+    }
+    return false;
+}
+
+bool StrToHex(std::string_view str, uint32_t& value)
+{
+    return StrToHexImpl(str, value);
+}
+
+bool StrToHex(std::string_view str, uint64_t& value)
+{
+    return StrToHexImpl(str, value);
+}
+
+template<std::floating_point T>
+static bool StrToFloatImpl(std::string_view str, T& value)
+{
+    // std::from_chars doesn't accept the leading plus sign.
+    if (str.starts_with('+'))
+    {
+        str.remove_prefix(1);
+        if (str.starts_with('-'))
+        {
+            return false;
+        }
+    }
+    if (str.empty())
+    {
+        return false;
+    }
+    const char* end = str.data() + str.size();
+    T result = 0;
+    std::from_chars_result status = std::from_chars(str.data(), end, result);
+    if ((status.ec == std::errc()) && (status.ptr == end))
+    {
+        value = result;
+        return true;
+    }
+    return false;
+}
+
+bool StrToFloat(std::string_view str, float& value)
+{
+    return StrToFloatImpl(str, value);
+}
+
+bool StrToFloat(std::string_view str, double& value)
+{
+    return StrToFloatImpl(str, value);
+}
+
+template<typename T>
+static size_t StrFromNumberImpl(T value, char* buffer, size_t bufferSize)
+{
+    std::to_chars_result result = std::to_chars(buffer, buffer + bufferSize, value);
+    if (result.ec == std::errc())
+    {
+        return size_t(result.ptr - buffer);
+    }
+    return 0;
+}
+
+size_t StrFromInt(int64_t value, char* buffer, size_t bufferSize)
+{
+    return StrFromNumberImpl(value, buffer, bufferSize);
+}
+
+size_t StrFromInt(uint64_t value, char* buffer, size_t bufferSize)
+{
+    return StrFromNumberImpl(value, buffer, bufferSize);
+}
+
+size_t StrFromFloat(float value, char* buffer, size_t bufferSize)
+{
+    return StrFromNumberImpl(value, buffer, bufferSize);
+}
+
+size_t StrFromFloat(double value, char* buffer, size_t bufferSize)
+{
+    return StrFromNumberImpl(value, buffer, bufferSize);
+}
+
+size_t StrFind(std::string_view str, std::string_view needle, size_t offset)
+{
+    const size_t size = str.size();
+    const size_t k = needle.size();
+    if ((offset > size) || (k > size - offset))
+    {
+        return std::string_view::npos;
+    }
+    if (k == 0)
+    {
+        return offset;
+    }
+    const char* s = str.data();
+    if (k == 1)
+    {
+        const void* p = std::memchr(s + offset, needle[0], size - offset);
+        return p ? size_t(static_cast<const char*>(p) - s) : std::string_view::npos;
+    }
+
+    const char* middle = needle.data() + 1;
+    const size_t middleSize = k - 2;
+    // The last position to start a match.
+    const size_t last = size - k;
+    size_t i = offset;
+#if defined(RAD_STRING_AVX2)
+    const __m256i first32 = _mm256_set1_epi8(needle[0]);
+    const __m256i last32 = _mm256_set1_epi8(needle[k - 1]);
+    for (; i + 32 <= last + 1; i += 32)
+    {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + k - 1));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(blockFirst, first32), _mm256_cmpeq_epi8(blockLast, last32))));
+        while (mask != 0)
+        {
+            const size_t pos = i + std::countr_zero(mask);
+            if (std::memcmp(s + pos + 1, middle, middleSize) == 0)
+            {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+#if defined(RAD_STRING_SSE2)
+    const __m128i first16 = _mm_set1_epi8(needle[0]);
+    const __m128i last16 = _mm_set1_epi8(needle[k - 1]);
+    for (; i + 16 <= last + 1; i += 16)
+    {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + k - 1));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(blockFirst, first16), _mm_cmpeq_epi8(blockLast, last16))));
+        while (mask != 0)
+        {
+            const size_t pos = i + std::countr_zero(mask);
+            if (std::memcmp(s + pos + 1, middle, middleSize) == 0)
+            {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+#elif defined(RAD_STRING_NEON)
+    const uint8x16_t first16 = vdupq_n_u8(uint8_t(needle[0]));
+    const uint8x16_t last16 = vdupq_n_u8(uint8_t(needle[k - 1]));
+    for (; i + 16 <= last + 1; i += 16)
+    {
+        uint8x16_t blockFirst = vld1q_u8(reinterpret_cast<const uint8_t*>(s + i));
+        uint8x16_t blockLast = vld1q_u8(reinterpret_cast<const uint8_t*>(s + i + k - 1));
+        uint64_t mask = NeonMovemask4(vandq_u8(vceqq_u8(blockFirst, first16), vceqq_u8(blockLast, last16)));
+        while (mask != 0)
+        {
+            const size_t pos = i + std::countr_zero(mask) / 4;
+            if (std::memcmp(s + pos + 1, middle, middleSize) == 0)
+            {
+                return pos;
+            }
+            mask &= ~(uint64_t(0xF) << (std::countr_zero(mask) & ~3));
+        }
+    }
+#endif
+    for (; i <= last; ++i)
+    {
+        if ((s[i] == needle[0]) && (s[i + k - 1] == needle[k - 1]) &&
+            (std::memcmp(s + i + 1, middle, middleSize) == 0))
+        {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+bool StrContains(std::string_view str, std::string_view needle)
+{
+    return (StrFind(str, needle) != std::string_view::npos);
+}
+
+StrMultiFinder::StrMultiFinder()
+{
+}
+
+StrMultiFinder::StrMultiFinder(std::initializer_list<std::string_view> needles)
+{
+    for (std::string_view needle : needles)
+    {
+        Add(needle);
+    }
+}
+
+StrMultiFinder::~StrMultiFinder()
+{
+}
+
+size_t StrMultiFinder::Add(std::string_view needle)
+{
+    // One bit per needle in the masks.
+    if (needle.empty() || (m_needles.size() >= MaxNeedleCount))
+    {
+        return std::string_view::npos;
+    }
+    const size_t index = m_needles.size();
+    const uint64_t bit = uint64_t(1) << index;
+    m_needles.emplace_back(needle);
+    const uint8_t firstByte = uint8_t(needle[0]);
+    if (m_firstByteMasks[firstByte] == 0)
+    {
+        m_firstBytes.push_back(char(firstByte));
+    }
+    m_firstByteMasks[firstByte] |= bit;
+    if (needle.size() >= 2)
+    {
+        m_secondByteMasks[uint8_t(needle[1])] |= bit;
+    }
+    else
+    {
+        m_shortNeedleMask |= bit;
+        for (uint64_t& mask : m_secondByteMasks)
+        {
+            mask |= bit;
+        }
+    }
+    return index;
+}
+
+// Verify the candidates at pos, return the mask of the needles matched.
+uint64_t StrMultiFinder::MatchAt(std::string_view str, size_t pos, uint64_t candidates) const
+{
+    uint64_t matches = 0;
+    while (candidates != 0)
+    {
+        const size_t index = std::countr_zero(candidates);
+        const std::string& needle = m_needles[index];
+        if ((needle.size() <= str.size() - pos) &&
+            (std::memcmp(str.data() + pos, needle.data(), needle.size()) == 0))
+        {
+            matches |= uint64_t(1) << index;
+        }
+        candidates &= candidates - 1;
+    }
+    return matches;
+}
+
+size_t StrMultiFinder::Find(std::string_view str, size_t offset, size_t* pNeedleIndex) const
+{
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(str.data());
+    const size_t size = str.size();
+    size_t i = offset;
+    while (i < size)
+    {
+#if defined(RAD_STRING_SSE2)
+        // Skip the blocks without any first byte.
+        if (m_firstBytes.size() <= 4)
+        {
+            for (; i + 16 <= size; i += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+                __m128i cmp = _mm_setzero_si128();
+                for (char c : m_firstBytes)
+                {
+                    cmp = _mm_or_si128(cmp, _mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+                }
+                if (uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(cmp)))
+                {
+                    i += std::countr_zero(mask);
+                    break;
+                }
+            }
+            if (i >= size)
+            {
+                break;
+            }
+        }
+#elif defined(RAD_STRING_NEON)
+        if (m_firstBytes.size() <= 4)
+        {
+            for (; i + 16 <= size; i += 16)
+            {
+                uint8x16_t block = vld1q_u8(s + i);
+                uint8x16_t cmp = vdupq_n_u8(0);
+                for (char c : m_firstBytes)
+                {
+                    cmp = vorrq_u8(cmp, vceqq_u8(block, vdupq_n_u8(uint8_t(c))));
+                }
+                if (uint64_t mask = NeonMovemask4(cmp))
+                {
+                    i += std::countr_zero(mask) / 4;
+                    break;
+                }
+            }
+            if (i >= size)
+            {
+                break;
+            }
+        }
+#endif
+        uint64_t candidates = m_firstByteMasks[s[i]];
+        if (candidates != 0)
+        {
+            candidates &= (i + 1 < size) ? m_secondByteMasks[s[i + 1]] : m_shortNeedleMask;
+            if (candidates != 0)
+            {
+                if (uint64_t matches = MatchAt(str, i, candidates))
+                {
+                    if (pNeedleIndex)
+                    {
+                        *pNeedleIndex = std::countr_zero(matches);
+                    }
+                    return i;
+                }
+            }
+        }
+        ++i;
+    }
+    return std::string_view::npos;
+}
+
+bool StrMultiFinder::ContainsAny(std::string_view str) const
+{
+    return (Find(str) != std::string_view::npos);
+}
+
+StringBuilder::StringBuilder(size_t chunkSize) :
+    m_chunkSize(chunkSize)
+{
+    assert(chunkSize > 0);
+}
+
+StringBuilder::~StringBuilder()
+{
+}
+
+StringBuilder::StringBuilder(StringBuilder&& other) noexcept :
+    m_chunks(std::move(other.m_chunks)),
+    m_buffers(std::move(other.m_buffers)),
+    m_chunkSize(other.m_chunkSize),
+    m_size(other.m_size)
+{
+    other.m_chunks.clear();
+    other.m_buffers.clear();
+    other.m_size = 0;
+}
+
+StringBuilder& StringBuilder::operator=(StringBuilder&& other) noexcept
+{
+    m_chunks = std::move(other.m_chunks);
+    m_buffers = std::move(other.m_buffers);
+    m_chunkSize = other.m_chunkSize;
+    m_size = other.m_size;
+    other.m_chunks.clear();
+    other.m_buffers.clear();
+    other.m_size = 0;
+    return *this;
+}
+
+void StringBuilder::Append(std::string_view str)
+{
+    while (!str.empty())
+    {
+        if (m_chunks.empty() || (m_chunks.back().size == m_buffers.back().capacity))
+        {
+            AddChunk(str.size());
+        }
+        StrChunk& chunk = m_chunks.back();
+        const size_t count = (std::min)(str.size(), m_buffers.back().capacity - chunk.size);
+        std::memcpy(m_buffers.back().data.get() + chunk.size, str.data(), count);
+        chunk.size += count;
+        m_size += count;
+        str.remove_prefix(count);
+    }
+}
+
+void StringBuilder::AddChunk(size_t minCapacity)
+{
+    // Large strings are appended in one chunk.
+    const size_t capacity = (std::max)(minCapacity, m_chunkSize);
+    m_buffers.push_back(Buffer{ std::make_unique_for_overwrite<char[]>(capacity), capacity });
+    m_chunks.push_back(StrChunk{ m_buffers.back().data.get(), 0 });
+}
+
+void StringBuilder::Clear()
+{
+    if (m_chunks.size() > 1)
+    {
+        m_chunks.resize(1);
+        m_buffers.resize(1);
+    }
+    if (!m_chunks.empty())
+    {
+        m_chunks.front().size = 0;
+    }
+    m_size = 0;
+}
+
+std::string StringBuilder::ToString() const
+{
+    std::string str;
+    str.reserve(m_size);
+    for (const StrChunk& chunk : m_chunks)
+    {
+        str.append(chunk.data, chunk.size);
+    }
+    return str;
+}
+
 std::string StrTrim(std::string_view str, std::string_view charlist)
 {
     size_t beg = str.find_first_not_of(charlist);
@@ -281,11 +999,15 @@ void StrTrimInPlace(std::string& str, std::string_view charlist)
 
 std::string StrReplace(std::string_view str, std::string_view subOld, std::string_view subNew)
 {
+    if (subOld.empty())
+    {
+        return std::string(str);
+    }
     std::string newStr;
     newStr.reserve(str.size());
     std::string::size_type offset = 0u;
     std::string::size_type pos = 0u;
-    while ((pos = str.find(subOld, offset)) != std::string::npos)
+    while ((pos = StrFind(str, subOld, offset)) != std::string::npos)
     {
         newStr.append(str, offset, pos - offset);
         newStr.append(subNew);
@@ -301,12 +1023,241 @@ std::string StrReplace(std::string_view str, std::string_view subOld, std::strin
 
 void StrReplaceInPlace(std::string& str, std::string_view subOld, std::string_view subNew)
 {
+    if (subOld.empty())
+    {
+        return;
+    }
+    if (subOld.size() != subNew.size())
+    {
+        // Replace in place is quadratic if the length changes.
+        str = StrReplace(str, subOld, subNew);
+        return;
+    }
     std::string::size_type pos = 0u;
-    while ((pos = str.find(subOld, pos)) != std::string::npos)
+    while ((pos = StrFind(str, subOld, pos)) != std::string::npos)
     {
         str.replace(pos, subOld.length(), subNew);
         pos += subNew.length();
     }
 }
 
+StrReplacer::StrReplacer()
+{
+}
+
+StrReplacer::StrReplacer(std::initializer_list<std::pair<std::string_view, std::string_view>> pairs)
+{
+    for (const auto& [from, to] : pairs)
+    {
+        Add(from, to);
+    }
+    Compile();
+}
+
+StrReplacer::~StrReplacer()
+{
+}
+
+bool StrReplacer::Add(std::string_view from, std::string_view to)
+{
+    // The pattern indices are 32-bit, and UINT32_MAX is invalid.
+    if (from.empty() || IsCompiled() || (m_patterns.size() >= MaxPatternCount))
+    {
+        return false;
+    }
+    m_patterns.emplace_back(from, to);
+    return true;
+}
+
+void StrReplacer::Compile()
+{
+    // Build the trie of the reversed patterns, state 0 is the root.
+    m_next.assign(256, 0);
+    m_output.assign(1, InvalidPattern);
+    m_maxPatternLength = 0;
+    for (uint32_t patternIndex = 0; patternIndex < m_patterns.size(); ++patternIndex)
+    {
+        const std::string& from = m_patterns[patternIndex].first;
+        uint32_t state = 0;
+        for (auto iter = from.rbegin(); iter != from.rend(); ++iter)
+        {
+            const size_t edge = size_t(state) * 256 + uint8_t(*iter);
+            if (m_next[edge] == 0)
+            {
+                m_next[edge] = static_cast<uint32_t>(m_output.size());
+                m_next.resize(m_next.size() + 256, 0);
+                m_output.push_back(InvalidPattern);
+            }
+            state = m_next[edge];
+        }
+        if (m_output[state] == InvalidPattern)
+        {
+            m_output[state] = patternIndex;
+        }
+        m_maxPatternLength = (std::max)(m_maxPatternLength, from.size());
+    }
+
+    // Compute failure links in BFS order, and fill the missing transitions to build the DFA.
+    std::vector<uint32_t> fail(m_output.size(), 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(m_output.size());
+    for (uint32_t c = 0; c < 256; ++c)
+    {
+        if (uint32_t child = m_next[c])
+        {
+            queue.push_back(child);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        const uint32_t state = queue[head];
+        const uint32_t stateFail = fail[state];
+        if (m_output[state] == InvalidPattern)
+        {
+            m_output[state] = m_output[stateFail];
+        }
+        for (uint32_t c = 0; c < 256; ++c)
+        {
+            uint32_t& next = m_next[size_t(state) * 256 + c];
+            const uint32_t failNext = m_next[size_t(stateFail) * 256 + c];
+            // Trie children, the other transitions are still 0 before filled.
+            if (next != 0)
+            {
+                fail[next] = failNext;
+                queue.push_back(next);
+            }
+            else
+            {
+                next = failNext;
+            }
+        }
+    }
+}
+
+std::string StrReplacer::Replace(std::string_view str) const
+{
+    std::string output;
+    output.reserve(str.size());
+    Replace(str, output);
+    return output;
+}
+
+void StrReplacer::Replace(std::string_view str, std::string& output) const
+{
+    Stream stream(*this);
+    stream.Write(str, output);
+    stream.Finish(output);
+}
+
+StrReplacer::Stream::Stream(const StrReplacer& replacer) :
+    m_replacer(replacer)
+{
+    assert(replacer.IsCompiled());
+}
+
+StrReplacer::Stream::~Stream()
+{
+}
+
+// Append text in absolute positions [begin, end), which is in m_pending or the current chunk.
+void StrReplacer::Stream::AppendText(std::string_view chunk, size_t begin, size_t end, std::string& output) const
+{
+    const size_t chunkBegin = m_pos - chunk.size();
+    if (begin < chunkBegin)
+    {
+        const size_t pendingEnd = (std::min)(end, chunkBegin);
+        output.append(m_pending, begin - m_pendingBegin, pendingEnd - begin);
+        begin = pendingEnd;
+    }
+    if (begin < end)
+    {
+        output.append(chunk.substr(begin - chunkBegin, end - begin));
+    }
+}
+
+void StrReplacer::Stream::Parse(std::string_view chunk, size_t parseEnd, std::string& output)
+{
+    const StrReplacer& r = m_replacer;
+    const size_t chunkBegin = m_pos - chunk.size();
+    auto getByte = [&](size_t pos) -> uint8_t
+    {
+        return uint8_t((pos >= chunkBegin) ? chunk[pos - chunkBegin] : m_pending[pos - m_pendingBegin]);
+    };
+    // The state at a position depends only on the text of the longest pattern from there,
+    // so the scan of a block starts from the root at the end of its lookahead.
+    const size_t lookahead = (std::max)(r.m_maxPatternLength, size_t(1)) - 1;
+    const size_t blockSize = (std::max)(MinBlockSize, 4 * r.m_maxPatternLength);
+    size_t pos = m_emitted;
+    while (pos < parseEnd)
+    {
+        const size_t blockBegin = pos;
+        const size_t blockEnd = (std::min)(blockBegin + blockSize, parseEnd);
+        const size_t scanEnd = (std::min)(blockEnd + lookahead, m_pos);
+        uint32_t state = 0;
+        for (size_t i = scanEnd; i > blockEnd; --i)
+        {
+            state = r.m_next[size_t(state) * 256 + getByte(i - 1)];
+        }
+        m_matches.resize(blockEnd - blockBegin);
+        for (size_t i = blockEnd; i > blockBegin; --i)
+        {
+            state = r.m_next[size_t(state) * 256 + getByte(i - 1)];
+            m_matches[i - 1 - blockBegin] = r.m_output[state];
+        }
+
+        // Take the leftmost match, and skip the text it covers.
+        while (pos < blockEnd)
+        {
+            const uint32_t patternIndex = m_matches[pos - blockBegin];
+            if (patternIndex == InvalidPattern)
+            {
+                ++pos;
+                continue;
+            }
+            const auto& pattern = r.m_patterns[patternIndex];
+            AppendText(chunk, m_emitted, pos, output);
+            output.append(pattern.second);
+            pos += pattern.first.size();
+            m_emitted = pos;
+        }
+    }
+    if (pos > m_emitted)
+    {
+        AppendText(chunk, m_emitted, pos, output);
+        m_emitted = pos;
+    }
+}
+
+void StrReplacer::Stream::Write(std::string_view chunk, std::string& output)
+{
+    const size_t chunkBegin = m_pos;
+    m_pos += chunk.size();
+    // Hold back the text a match may start from, until its lookahead is fed.
+    const size_t lookahead = (std::max)(m_replacer.m_maxPatternLength, size_t(1)) - 1;
+    if (m_pos > lookahead)
+    {
+        Parse(chunk, m_pos - lookahead, output);
+    }
+    if (m_emitted <= chunkBegin)
+    {
+        m_pending.erase(0, m_emitted - m_pendingBegin);
+        m_pending.append(chunk);
+    }
+    else
+    {
+        m_pending.assign(chunk.substr(m_emitted - chunkBegin));
+    }
+    m_pendingBegin = m_emitted;
+}
+
+void StrReplacer::Stream::Finish(std::string& output)
+{
+    std::string_view chunk;
+    Parse(chunk, m_pos, output);
+    m_pos = 0;
+    m_emitted = 0;
+    m_pending.clear();
+    m_pendingBegin = 0;
+}
+
 } // namespace rad
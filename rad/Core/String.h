@@ -1,13 +1,19 @@
 #pragma once
 
 #include <rad/Core/Platform.h>
+#include <rad/Core/Unicode.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <format>
-
-#include <boost/locale.hpp>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
 
 #if defined(RAD_COMPILER_MSVC)
 #define strcasecmp _stricmp
@@ -16,15 +22,11 @@
 
 namespace rad
 {
+
 // Use std::string by default (treat std::string as UTF-8 encoded).
 // https://utf8everywhere.org/
 using String = std::string;
 
-// Character Set Conversions
-using boost::locale::conv::to_utf;
-using boost::locale::conv::from_utf;
-using boost::locale::conv::utf_to_utf;
-
 std::vector<std::string> StrSplit(
     std::string_view str, std::string_view delimiters, bool skipEmptySubStr = true);
 
@@ -38,13 +40,141 @@ std::string StrFormat(std::string_view format, Args&&... args)
     return std::vformat(format, std::make_format_args(args...));
 }
 
+// A growable char buffer with inline storage, to format short strings without heap allocations;
+// reuse the buffer (clear) to amortize the growth.
+template<size_t InlineCapacity = 256>
+class FormatBuffer
+{
+public:
+    using value_type = char;
+
+    FormatBuffer() noexcept {}
+    ~FormatBuffer()
+    {
+        if (m_data != m_inline)
+        {
+            delete[] m_data;
+        }
+    }
+    FormatBuffer(const FormatBuffer&) = delete;
+    FormatBuffer& operator=(const FormatBuffer&) = delete;
+
+    char* data() noexcept { return m_data; }
+    const char* data() const noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+    size_t capacity() const noexcept { return m_capacity; }
+    bool empty() const noexcept { return (m_size == 0); }
+    void clear() noexcept { m_size = 0; }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_capacity)
+        {
+            Grow(capacity);
+        }
+    }
+
+    void push_back(char c)
+    {
+        if (m_size == m_capacity)
+        {
+            Grow(m_size + 1);
+        }
+        m_data[m_size++] = c;
+    }
+
+    void append(std::string_view str)
+    {
+        reserve(m_size + str.size());
+        std::memcpy(m_data + m_size, str.data(), str.size());
+        m_size += str.size();
+    }
+
+    // Format into the free capacity directly, grow and format again only if it is not enough.
+    template<typename... Args>
+    void format(std::format_string<Args...> format, Args&&... args)
+    {
+        const size_t available = m_capacity - m_size;
+        const auto result = std::format_to_n(m_data + m_size, available, format, std::forward<Args>(args)...);
+        const size_t length = static_cast<size_t>(result.size);
+        if (length > available)
+        {
+            reserve(m_size + length);
+            // std::format only references the arguments (never moves), they can be forwarded again.
+            std::format_to(m_data + m_size, format, std::forward<Args>(args)...);
+        }
+        m_size += length;
+    }
+
+    std::string_view view() const noexcept { return std::string_view(m_data, m_size); }
+    operator std::string_view() const noexcept { return view(); }
+    std::string str() const { return std::string(m_data, m_size); }
+    // Null-terminated.
+    const char* c_str()
+    {
+        reserve(m_size + 1);
+        m_data[m_size] = '\0';
+        return m_data;
+    }
+
+private:
+    void Grow(size_t capacity)
+    {
+        capacity = (std::max)(capacity, m_capacity * 2);
+        char* data = new char[capacity];
+        std::memcpy(data, m_data, m_size);
+        if (m_data != m_inline)
+        {
+            delete[] m_data;
+        }
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    char* m_data = m_inline;
+    size_t m_size = 0;
+    size_t m_capacity = InlineCapacity;
+    char m_inline[InlineCapacity];
+
+}; // class FormatBuffer
+
+// Format and append to buffer (FormatBuffer, std::string, or any container of char supports push_back),
+// the format string is checked at compile time.
+template<typename Buffer, typename... Args>
+void StrFormatTo(Buffer& buffer, std::format_string<Args...> format, Args&&... args)
+{
+    std::format_to(std::back_inserter(buffer), format, std::forward<Args>(args)...);
+}
+
+template<size_t InlineCapacity, typename... Args>
+void StrFormatTo(FormatBuffer<InlineCapacity>& buffer, std::format_string<Args...> format, Args&&... args)
+{
+    buffer.format(format, std::forward<Args>(args)...);
+}
+
+// The buffer owned by the current thread, for temporary strings.
+FormatBuffer<>& GetThreadFormatBuffer();
+
+// Format into the thread-local buffer, the view returned is valid until the next call on the same thread.
+template<typename... Args>
+std::string_view StrFormatThreadLocal(std::format_string<Args...> format, Args&&... args)
+{
+    FormatBuffer<>& buffer = GetThreadFormatBuffer();
+    buffer.clear();
+    buffer.format(format, std::forward<Args>(args)...);
+    return buffer.view();
+}
+
+// Comparisons are length-aware (the views don't need to be null-terminated),
+// case-insensitive comparisons fold ASCII letters only.
 bool StrEqual(std::string_view str1, std::string_view str2);
 bool StrCaseEqual(std::string_view str1, std::string_view str2);
 int StrCompare(std::string_view left, std::string_view right);
 int StrCaseCompare(std::string_view left, std::string_view right);
-
-std::string StrWideToU8(std::wstring_view wstr);
-std::wstring StrU8ToWide(std::string_view str);
+// Return the index of the first mismatch, or the size of the shorter string if one is the prefix of the other.
+size_t StrMismatch(std::string_view str1, std::string_view str2);
+size_t StrCaseMismatch(std::string_view str1, std::string_view str2);
+char ToLowerAscii(char c);
 
 std::string StrUpper(std::string_view s);
 std::string StrLower(std::string_view s);
@@ -59,18 +189,215 @@ bool StrIsNumeric(std::string_view str);
 bool IsDigit(char c);
 bool IsHexDigit(char c);
 
+// Parse the whole string as a number in a single pass, return false if the string is not
+// a valid number or the value is out of range (value is left unmodified on failure).
+// Decimal integers accept an optional leading sign; hex numbers accept an optional 0x/0X prefix.
+bool StrToInt(std::string_view str, int32_t& value);
+bool StrToInt(std::string_view str, int64_t& value);
+bool StrToInt(std::string_view str, uint32_t& value);
+bool StrToInt(std::string_view str, uint64_t& value);
+bool StrToHex(std::string_view str, uint32_t& value);
+bool StrToHex(std::string_view str, uint64_t& value);
+bool StrToFloat(std::string_view str, float& value);
+bool StrToFloat(std::string_view str, double& value);
+
+// Format numbers into the caller buffer (not null-terminated), return the number of chars written,
+// or 0 if the buffer is too small; 32 chars is always enough.
+// Floats are formatted to the shortest representation that round-trips (Ryu-based std::to_chars).
+size_t StrFromInt(int64_t value, char* buffer, size_t bufferSize);
+size_t StrFromInt(uint64_t value, char* buffer, size_t bufferSize);
+size_t StrFromFloat(float value, char* buffer, size_t bufferSize);
+size_t StrFromFloat(double value, char* buffer, size_t bufferSize);
+
+// Find the first occurrence of needle at or after offset, return std::string_view::npos if not found.
+// Filter candidates by the first and last bytes of needle with SIMD (the generic SIMD approach):
+// http://0x80.pl/articles/simd-strfind.html
+size_t StrFind(std::string_view str, std::string_view needle, size_t offset = 0);
+bool StrContains(std::string_view str, std::string_view needle);
+
+// Find the leftmost occurrence of any of the needles (up to 64).
+class StrMultiFinder
+{
+public:
+    static constexpr size_t MaxNeedleCount = 64;
+
+    StrMultiFinder();
+    StrMultiFinder(std::initializer_list<std::string_view> needles);
+    ~StrMultiFinder();
+
+    // Return the index of the needle added, or std::string_view::npos if the needle is empty
+    // or there are MaxNeedleCount needles already.
+    size_t Add(std::string_view needle);
+    size_t GetNeedleCount() const { return m_needles.size(); }
+    const std::string& GetNeedle(size_t index) const { return m_needles[index]; }
+
+    // Return the position of the leftmost match or std::string_view::npos if not found;
+    // if more than one needle match at the position, the needle added first wins.
+    size_t Find(std::string_view str, size_t offset = 0, size_t* pNeedleIndex = nullptr) const;
+    bool ContainsAny(std::string_view str) const;
+
+private:
+    uint64_t MatchAt(std::string_view str, size_t pos, uint64_t candidates) const;
+
+    std::vector<std::string> m_needles;
+    // Bit masks of the needles which have the byte at the first/second position.
+    uint64_t m_firstByteMasks[256] = {};
+    uint64_t m_secondByteMasks[256] = {};
+    // The needles of one byte.
+    uint64_t m_shortNeedleMask = 0;
+    // The distinct first bytes, to skip blocks with SIMD if there are only a few.
+    std::string m_firstBytes;
+
+}; // class StrMultiFinder
+
 std::string StrTrim(std::string_view str, std::string_view charlist = " \t\n\v\f\r");
 void StrTrimInPlace(std::string& str, std::string_view charlist = " \t\n\v\f\r");
 
 std::string StrReplace(std::string_view str, std::string_view subOld, std::string_view subNew);
 void StrReplaceInPlace(std::string& str, std::string_view subOld, std::string_view subNew);
 
+// Replace multiple patterns in a single pass, with an Aho-Corasick automaton compiled once:
+// https://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_algorithm
+// Matches are leftmost-longest and non-overlapping, the replaced text is not scanned again.
+// The automaton is built on the reversed patterns: scanning a block of text backward gives
+// the longest pattern starting at each position, then the matches are taken from the left.
+// Each byte is scanned once, plus the lookahead (the longest pattern) at the end of each block,
+// which is at least 4x longer, so it is O(n) for any patterns.
+class StrReplacer
+{
+public:
+    static constexpr size_t MaxPatternCount = UINT32_MAX;
+
+    StrReplacer();
+    StrReplacer(std::initializer_list<std::pair<std::string_view, std::string_view>> pairs);
+    ~StrReplacer();
+
+    // Add patterns before Compile; if the same pattern is added more than once, the first one wins.
+    // Return false if from is empty, the replacer is compiled, or there are MaxPatternCount patterns.
+    bool Add(std::string_view from, std::string_view to);
+    void Compile();
+    bool IsCompiled() const { return !m_next.empty(); }
+
+    std::string Replace(std::string_view str) const;
+    // Append the replaced text to output; use Stream for the input read chunk by chunk.
+    void Replace(std::string_view str, std::string& output) const;
+
+    // Replace text fed chunk by chunk, matches can span chunks.
+    class Stream
+    {
+    public:
+        Stream(const StrReplacer& replacer);
+        ~Stream();
+        // Append the replaced text to output, the text that can still be part of a match is held back.
+        void Write(std::string_view chunk, std::string& output);
+        // Append all the remaining text to output, and reset for the next input.
+        void Finish(std::string& output);
+
+    private:
+        void AppendText(std::string_view chunk, size_t begin, size_t end, std::string& output) const;
+        // Replace the matches starting before parseEnd, the text after it is the lookahead.
+        void Parse(std::string_view chunk, size_t parseEnd, std::string& output);
+
+        const StrReplacer& m_replacer;
+        // Absolute positions: the end of text fed, and emitted (where the next match can start).
+        size_t m_pos = 0;
+        size_t m_emitted = 0;
+        // Text held back from previous chunks.
+        std::string m_pending;
+        size_t m_pendingBegin = 0;
+        // The longest pattern starting at each position of the block parsed.
+        std::vector<uint32_t> m_matches;
+    }; // class Stream
+
+private:
+    static constexpr uint32_t InvalidPattern = UINT32_MAX;
+    static constexpr size_t MinBlockSize = 4096;
+
+    std::vector<std::pair<std::string, std::string>> m_patterns;
+    size_t m_maxPatternLength = 0;
+    // Dense DFA transitions of the reversed patterns: m_next[state * 256 + byte].
+    std::vector<uint32_t> m_next;
+    // The longest reversed pattern that is a suffix of the state,
+    // i.e. the longest pattern starting at the position scanned.
+    std::vector<uint32_t> m_output;
+
+}; // class StrReplacer
+
+// A chunk of text, layout-compatible with iovec to be written gathered (writev on POSIX).
+struct StrChunk
+{
+    const char* data;
+    size_t size;
+};
+
+// Build large text in a chain of chunks, without reallocating and copying the whole text on growth;
+// the chunks can be written to file directly (File::WriteChunks), so the text never needs to be contiguous.
+class StringBuilder
+{
+public:
+    using value_type = char;
+
+    explicit StringBuilder(size_t chunkSize = 64 * 1024);
+    ~StringBuilder();
+    StringBuilder(StringBuilder&& other) noexcept;
+    StringBuilder& operator=(StringBuilder&& other) noexcept;
+    StringBuilder(const StringBuilder&) = delete;
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    void Append(std::string_view str);
+    void Append(char c)
+    {
+        if (m_chunks.empty() || (m_chunks.back().size == m_buffers.back().capacity))
+        {
+            AddChunk(1);
+        }
+        StrChunk& chunk = m_chunks.back();
+        m_buffers.back().data[chunk.size++] = c;
+        ++m_size;
+    }
+    // For std::back_inserter (StrFormatTo).
+    void push_back(char c) { Append(c); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return (m_size == 0); }
+    // Release all chunks but the first one.
+    void Clear();
+
+    size_t GetChunkCount() const { return m_chunks.size(); }
+    // The array of GetChunkCount() chunks, valid until the next append.
+    const StrChunk* GetChunks() const { return m_chunks.data(); }
+    std::string_view GetChunk(size_t index) const
+    {
+        return std::string_view(m_chunks[index].data, m_chunks[index].size);
+    }
+
+    // Copy to a contiguous string.
+    std::string ToString() const;
+
+private:
+    void AddChunk(size_t minCapacity);
+
+    struct Buffer
+    {
+        std::unique_ptr<char[]> data;
+        size_t capacity;
+    };
+    // The views of the buffers owned, in the same order.
+    std::vector<StrChunk> m_chunks;
+    std::vector<Buffer> m_buffers;
+    size_t m_chunkSize;
+    size_t m_size = 0;
+
+}; // class StringBuilder
+
+// Transparent comparators and hashers: containers keyed by std::string can be probed with
+// std::string_view or const char* without temporaries (heterogeneous lookup).
 struct StringLess
 {
     using is_transparent = void;
     bool operator()(std::string_view left, std::string_view right) const
     {
-        return (strcmp(left.data(), right.data()) < 0);
+        return (left.compare(right) < 0);
     }
 };
 
@@ -80,7 +407,48 @@ struct StringLessCaseInsensitive
     using is_transparent = void;
     bool operator()(std::string_view left, std::string_view right) const
     {
-        return (strcasecmp(left.data(), right.data()) < 0);
+        return (StrCaseCompare(left, right) < 0);
+    }
+};
+
+struct StringEqual
+{
+    using is_transparent = void;
+    bool operator()(std::string_view left, std::string_view right) const
+    {
+        return (left == right);
+    }
+};
+
+struct StringEqualCaseInsensitive
+{
+    using is_transparent = void;
+    bool operator()(std::string_view left, std::string_view right) const
+    {
+        return StrCaseEqual(left, right);
+    }
+};
+
+size_t StrHash(std::string_view str);
+size_t StrCaseHash(std::string_view str);
+
+// Use with StringEqual for std::unordered_set/map.
+struct StringHash
+{
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const
+    {
+        return StrHash(str);
+    }
+};
+
+// Use with StringEqualCaseInsensitive for std::unordered_set/map.
+struct StringHashCaseInsensitive
+{
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const
+    {
+        return StrCaseHash(str);
     }
 };
 
@@ -2,6 +2,9 @@
 
 #include <rad/Core/Platform.h>
 #include <concepts>
+#include <memory>
+#include <string>
+#include <type_traits>
 
 namespace rad
 {
@@ -46,4 +49,45 @@ constexpr auto ToUnderlying(T t) noexcept
     return static_cast<std::underlying_type_t<T>>(t);
 }
 
+// Whether an object can be moved to another address with memcpy, and the source memory
+// is then released without running the destructor (moving + destroying is equivalent to memcpy);
+// trivially copyable types by default, specialize it for the other types known to be safe.
+template <typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Opt in a non-template type, must be used in the global namespace;
+// class templates should specialize IsTriviallyRelocatable partially.
+#define RAD_TRIVIALLY_RELOCATABLE(...) \
+    template <> struct rad::IsTriviallyRelocatable<__VA_ARGS__> : std::true_type {}
+
+// Smart pointers hold no pointers into themselves in the major implementations.
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type
+{
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::shared_ptr<T>> : std::true_type
+{
+};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::weak_ptr<T>> : std::true_type
+{
+};
+
+// libstdc++ strings point to their inline buffers (SSO), and the MSVC debug strings are registered
+// with their iterators (_ITERATOR_DEBUG_LEVEL); libc++ and the MSVC release strings are safe.
+#if defined(_LIBCPP_VERSION) || (defined(_MSVC_STL_VERSION) && (_ITERATOR_DEBUG_LEVEL == 0))
+template <>
+struct IsTriviallyRelocatable<std::string> : std::true_type
+{
+};
+#endif
+
 } // namespace rad
@@ -0,0 +1,608 @@
+#include <rad/Core/Unicode.h>
+#include <bit>
+#include <cstdint>
+
+#if defined(RAD_ARCH_X86) && RAD_COMPILED_X86_AVX2
+#define RAD_UNICODE_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(RAD_ARCH_X86) && RAD_COMPILED_X86_SSE2
+#define RAD_UNICODE_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(RAD_ARCH_AARCH64) && RAD_COMPILED_ANY_ARM_NEON
+#define RAD_UNICODE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace rad
+{
+
+// Return the length of the leading ASCII run.
+static size_t Utf8AsciiPrefix(const uint8_t* src, size_t size)
+{
+    size_t i = 0;
+#if defined(RAD_UNICODE_AVX2)
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(v));
+        if (mask != 0)
+        {
+            return i + std::countr_zero(mask);
+        }
+    }
+#endif
+#if defined(RAD_UNICODE_SSE2)
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(v));
+        if (mask != 0)
+        {
+            return i + std::countr_zero(mask);
+        }
+    }
+#elif defined(RAD_UNICODE_NEON)
+    for (; i + 16 <= size; i += 16)
+    {
+        if (vmaxvq_u8(vld1q_u8(src + i)) >= 0x80)
+        {
+            break;
+        }
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        if (src[i] >= 0x80)
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+template<typename Char16>
+static size_t Utf16AsciiPrefix(const Char16* src, size_t size)
+{
+    size_t i = 0;
+#if defined(RAD_UNICODE_SSE2)
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= size; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), zero)) != 0xFFFF)
+        {
+            break;
+        }
+    }
+#elif defined(RAD_UNICODE_NEON)
+    for (; i + 8 <= size; i += 8)
+    {
+        if (vmaxvq_u16(vld1q_u16(reinterpret_cast<const uint16_t*>(src + i))) >= 0x80)
+        {
+            break;
+        }
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        if (uint32_t(src[i]) >= 0x80)
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+// Decode one multi-byte sequence, return its length or 0 if invalid.
+static size_t DecodeUtf8(const uint8_t* p, const uint8_t* end, char32_t& codePoint)
+{
+    const uint32_t c0 = p[0];
+    const size_t remain = size_t(end - p);
+    auto isCont = [](uint32_t c) { return (c & 0xC0) == 0x80; };
+    if (c0 < 0x80)
+    {
+        codePoint = c0;
+        return 1;
+    }
+    else if ((c0 >= 0xC2) && (c0 <= 0xDF))
+    {
+        if ((remain >= 2) && isCont(p[1]))
+        {
+            codePoint = ((c0 & 0x1F) << 6) | (p[1] & 0x3F);
+            return 2;
+        }
+    }
+    else if ((c0 >= 0xE0) && (c0 <= 0xEF))
+    {
+        if ((remain >= 3) && isCont(p[1]) && isCont(p[2]))
+        {
+            const uint32_t c1 = p[1];
+            if (((c0 == 0xE0) && (c1 < 0xA0)) || // overlong
+                ((c0 == 0xED) && (c1 > 0x9F)))   // surrogate
+            {
+                return 0;
+            }
+            codePoint = ((c0 & 0x0F) << 12) | ((c1 & 0x3F) << 6) | (p[2] & 0x3F);
+            return 3;
+        }
+    }
+    else if ((c0 >= 0xF0) && (c0 <= 0xF4))
+    {
+        if ((remain >= 4) && isCont(p[1]) && isCont(p[2]) && isCont(p[3]))
+        {
+            const uint32_t c1 = p[1];
+            if (((c0 == 0xF0) && (c1 < 0x90)) || // overlong
+                ((c0 == 0xF4) && (c1 > 0x8F)))   // > U+10FFFF
+            {
+                return 0;
+            }
+            codePoint = ((c0 & 0x07) << 18) | ((c1 & 0x3F) << 12) |
+                ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+            return 4;
+        }
+    }
+    return 0;
+}
+
+template<typename Char16>
+static size_t DecodeUtf16(const Char16* p, const Char16* end, char32_t& codePoint)
+{
+    const uint32_t c0 = uint32_t(p[0]) & 0xFFFF;
+    if ((c0 < 0xD800) || (c0 > 0xDFFF))
+    {
+        codePoint = c0;
+        return 1;
+    }
+    if ((c0 <= 0xDBFF) && (end - p >= 2))
+    {
+        const uint32_t c1 = uint32_t(p[1]) & 0xFFFF;
+        if ((c1 >= 0xDC00) && (c1 <= 0xDFFF))
+        {
+            codePoint = 0x10000 + ((c0 - 0xD800) << 10) + (c1 - 0xDC00);
+            return 2;
+        }
+    }
+    return 0;
+}
+
+static bool IsValidCodePoint(uint32_t c)
+{
+    return (c <= 0x10FFFF) && ((c < 0xD800) || (c > 0xDFFF));
+}
+
+static size_t EncodeUtf8(char32_t codePoint, char* dst)
+{
+    const uint32_t c = codePoint;
+    if (c < 0x80)
+    {
+        dst[0] = char(c);
+        return 1;
+    }
+    else if (c < 0x800)
+    {
+        dst[0] = char(0xC0 | (c >> 6));
+        dst[1] = char(0x80 | (c & 0x3F));
+        return 2;
+    }
+    else if (c < 0x10000)
+    {
+        dst[0] = char(0xE0 | (c >> 12));
+        dst[1] = char(0x80 | ((c >> 6) & 0x3F));
+        dst[2] = char(0x80 | (c & 0x3F));
+        return 3;
+    }
+    else
+    {
+        dst[0] = char(0xF0 | (c >> 18));
+        dst[1] = char(0x80 | ((c >> 12) & 0x3F));
+        dst[2] = char(0x80 | ((c >> 6) & 0x3F));
+        dst[3] = char(0x80 | (c & 0x3F));
+        return 4;
+    }
+}
+
+template<typename Char16>
+static size_t EncodeUtf16(char32_t codePoint, Char16* dst)
+{
+    const uint32_t c = codePoint;
+    if (c < 0x10000)
+    {
+        dst[0] = Char16(c);
+        return 1;
+    }
+    dst[0] = Char16(0xD800 + ((c - 0x10000) >> 10));
+    dst[1] = Char16(0xDC00 + ((c - 0x10000) & 0x3FF));
+    return 2;
+}
+
+// Transcode from UTF-8 to UTF-16 or UTF-32 (by the size of CharT);
+// return 0 on invalid input, or skip invalid bytes if lenient.
+template<typename CharT>
+static size_t Utf8ToUtfImpl(std::string_view src, CharT* dst, bool lenient)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(src.data());
+    const uint8_t* end = p + src.size();
+    CharT* out = dst;
+    while (p < end)
+    {
+        const size_t asciiCount = Utf8AsciiPrefix(p, size_t(end - p));
+        for (size_t i = 0; i < asciiCount; ++i)
+        {
+            out[i] = CharT(p[i]);
+        }
+        out += asciiCount;
+        p += asciiCount;
+        while ((p < end) && (*p >= 0x80))
+        {
+            char32_t codePoint = 0;
+            size_t length = DecodeUtf8(p, end, codePoint);
+            if (length == 0)
+            {
+                if (!lenient)
+                {
+                    return 0;
+                }
+                ++p;
+                continue;
+            }
+            p += length;
+            if constexpr (sizeof(CharT) == 2)
+            {
+                out += EncodeUtf16(codePoint, out);
+            }
+            else
+            {
+                *out++ = CharT(codePoint);
+            }
+        }
+    }
+    return size_t(out - dst);
+}
+
+template<typename Char16>
+static size_t Utf16ToUtf8Impl(const Char16* src, size_t size, char* dst, bool lenient)
+{
+    const Char16* p = src;
+    const Char16* end = src + size;
+    char* out = dst;
+    while (p < end)
+    {
+        const size_t asciiCount = Utf16AsciiPrefix(p, size_t(end - p));
+        for (size_t i = 0; i < asciiCount; ++i)
+        {
+            out[i] = char(p[i]);
+        }
+        out += asciiCount;
+        p += asciiCount;
+        while ((p < end) && (uint32_t(*p) >= 0x80))
+        {
+            char32_t codePoint = 0;
+            size_t length = DecodeUtf16(p, end, codePoint);
+            if (length == 0)
+            {
+                if (!lenient)
+                {
+                    return 0;
+                }
+                ++p;
+                continue;
+            }
+            p += length;
+            out += EncodeUtf8(codePoint, out);
+        }
+    }
+    return size_t(out - dst);
+}
+
+template<typename Char32>
+static size_t Utf32ToUtf8Impl(const Char32* src, size_t size, char* dst, bool lenient)
+{
+    char* out = dst;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const uint32_t c = uint32_t(src[i]);
+        if (c < 0x80)
+        {
+            *out++ = char(c);
+        }
+        else if (IsValidCodePoint(c))
+        {
+            out += EncodeUtf8(c, out);
+        }
+        else if (!lenient)
+        {
+            return 0;
+        }
+    }
+    return size_t(out - dst);
+}
+
+bool Utf8Validate(std::string_view src)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(src.data());
+    const uint8_t* end = p + src.size();
+    while (p < end)
+    {
+        p += Utf8AsciiPrefix(p, size_t(end - p));
+        while ((p < end) && (*p >= 0x80))
+        {
+            char32_t codePoint = 0;
+            size_t length = DecodeUtf8(p, end, codePoint);
+            if (length == 0)
+            {
+                return false;
+            }
+            p += length;
+        }
+    }
+    return true;
+}
+
+bool Utf16Validate(std::u16string_view src)
+{
+    const char16_t* p = src.data();
+    const char16_t* end = p + src.size();
+    while (p < end)
+    {
+        p += Utf16AsciiPrefix(p, size_t(end - p));
+        while ((p < end) && (*p >= 0x80))
+        {
+            char32_t codePoint = 0;
+            size_t length = DecodeUtf16(p, end, codePoint);
+            if (length == 0)
+            {
+                return false;
+            }
+            p += length;
+        }
+    }
+    return true;
+}
+
+bool Utf32Validate(std::u32string_view src)
+{
+    bool isValid = true;
+    for (char32_t c : src)
+    {
+        isValid &= IsValidCodePoint(c);
+    }
+    return isValid;
+}
+
+// Count the bytes that are not continuation bytes (the number of code points),
+// and the leading bytes of 4-byte sequences (which need surrogate pairs in UTF-16).
+static void Utf8CountLeadingBytes(std::string_view src, size_t& leadCount, size_t& fourByteLeadCount)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(src.data());
+    const size_t size = src.size();
+    size_t i = 0;
+    size_t leads = 0;
+    size_t fourByteLeads = 0;
+#if defined(RAD_UNICODE_SSE2)
+    const __m128i contMax = _mm_set1_epi8(static_cast<char>(0xBF));
+    const __m128i fourByteMin = _mm_set1_epi8(static_cast<char>(0xF0));
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        // Continuation bytes are 0x80~0xBF, which are the smallest as signed bytes.
+        __m128i isLead = _mm_cmpgt_epi8(v, contMax);
+        __m128i isFourByteLead = _mm_cmpeq_epi8(_mm_max_epu8(v, fourByteMin), v);
+        leads += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(isLead)));
+        fourByteLeads += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(isFourByteLead)));
+    }
+#elif defined(RAD_UNICODE_NEON)
+    for (; i + 16 <= size; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(p + i);
+        uint8x16_t isLead = vcgtq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(-65));
+        uint8x16_t isFourByteLead = vcgeq_u8(v, vdupq_n_u8(0xF0));
+        leads += vaddvq_u8(vshrq_n_u8(isLead, 7));
+        fourByteLeads += vaddvq_u8(vshrq_n_u8(isFourByteLead, 7));
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        leads += ((p[i] & 0xC0) != 0x80) ? 1 : 0;
+        fourByteLeads += (p[i] >= 0xF0) ? 1 : 0;
+    }
+    leadCount = leads;
+    fourByteLeadCount = fourByteLeads;
+}
+
+size_t Utf8CountCodePoints(std::string_view src)
+{
+    size_t leadCount = 0;
+    size_t fourByteLeadCount = 0;
+    Utf8CountLeadingBytes(src, leadCount, fourByteLeadCount);
+    return leadCount;
+}
+
+size_t Utf16LengthFromUtf8(std::string_view src)
+{
+    size_t leadCount = 0;
+    size_t fourByteLeadCount = 0;
+    Utf8CountLeadingBytes(src, leadCount, fourByteLeadCount);
+    return leadCount + fourByteLeadCount;
+}
+
+size_t Utf32LengthFromUtf8(std::string_view src)
+{
+    return Utf8CountCodePoints(src);
+}
+
+template<typename Char16>
+static size_t Utf8LengthFromUtf16Impl(const Char16* src, size_t size)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        // Each surrogate of a pair counts 2 bytes.
+        const uint32_t c = uint32_t(src[i]) & 0xFFFF;
+        length += 1 + (c >= 0x80) + ((c >= 0x800) && ((c < 0xD800) || (c > 0xDFFF)));
+    }
+    return length;
+}
+
+size_t Utf8LengthFromUtf16(std::u16string_view src)
+{
+    return Utf8LengthFromUtf16Impl(src.data(), src.size());
+}
+
+size_t Utf32LengthFromUtf16(std::u16string_view src)
+{
+    size_t length = 0;
+    for (char16_t c : src)
+    {
+        // Count all but the trailing surrogates.
+        length += ((c < 0xDC00) || (c > 0xDFFF));
+    }
+    return length;
+}
+
+template<typename Char32>
+static size_t Utf8LengthFromUtf32Impl(const Char32* src, size_t size)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const uint32_t c = uint32_t(src[i]);
+        length += 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+    }
+    return length;
+}
+
+size_t Utf8LengthFromUtf32(std::u32string_view src)
+{
+    return Utf8LengthFromUtf32Impl(src.data(), src.size());
+}
+
+size_t Utf16LengthFromUtf32(std::u32string_view src)
+{
+    size_t length = 0;
+    for (char32_t c : src)
+    {
+        length += 1 + (c >= 0x10000);
+    }
+    return length;
+}
+
+size_t Utf8ToUtf16(std::string_view src, char16_t* dst)
+{
+    return Utf8ToUtfImpl(src, dst, false);
+}
+
+size_t Utf8ToUtf32(std::string_view src, char32_t* dst)
+{
+    return Utf8ToUtfImpl(src, dst, false);
+}
+
+size_t Utf16ToUtf8(std::u16string_view src, char* dst)
+{
+    return Utf16ToUtf8Impl(src.data(), src.size(), dst, false);
+}
+
+size_t Utf16ToUtf32(std::u16string_view src, char32_t* dst)
+{
+    const char16_t* p = src.data();
+    const char16_t* end = p + src.size();
+    char32_t* out = dst;
+    while (p < end)
+    {
+        char32_t codePoint = 0;
+        size_t length = DecodeUtf16(p, end, codePoint);
+        if (length == 0)
+        {
+            return 0;
+        }
+        p += length;
+        *out++ = codePoint;
+    }
+    return size_t(out - dst);
+}
+
+size_t Utf32ToUtf8(std::u32string_view src, char* dst)
+{
+    return Utf32ToUtf8Impl(src.data(), src.size(), dst, false);
+}
+
+size_t Utf32ToUtf16(std::u32string_view src, char16_t* dst)
+{
+    char16_t* out = dst;
+    for (char32_t c : src)
+    {
+        if (!IsValidCodePoint(c))
+        {
+            return 0;
+        }
+        out += EncodeUtf16(c, out);
+    }
+    return size_t(out - dst);
+}
+
+std::u16string StrU8ToU16(std::string_view src)
+{
+    std::u16string dst;
+    dst.resize(Utf16LengthFromUtf8(src));
+    dst.resize(Utf8ToUtfImpl(src, dst.data(), true));
+    return dst;
+}
+
+std::u32string StrU8ToU32(std::string_view src)
+{
+    std::u32string dst;
+    dst.resize(Utf32LengthFromUtf8(src));
+    dst.resize(Utf8ToUtfImpl(src, dst.data(), true));
+    return dst;
+}
+
+std::string StrU16ToU8(std::u16string_view src)
+{
+    std::string dst;
+    dst.resize(Utf8LengthFromUtf16Impl(src.data(), src.size()));
+    dst.resize(Utf16ToUtf8Impl(src.data(), src.size(), dst.data(), true));
+    return dst;
+}
+
+std::string StrU32ToU8(std::u32string_view src)
+{
+    std::string dst;
+    dst.resize(Utf8LengthFromUtf32Impl(src.data(), src.size()));
+    dst.resize(Utf32ToUtf8Impl(src.data(), src.size(), dst.data(), true));
+    return dst;
+}
+
+std::string StrWideToU8(std::wstring_view wstr)
+{
+    std::string str;
+    if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+    {
+        str.resize(Utf8LengthFromUtf16Impl(wstr.data(), wstr.size()));
+        str.resize(Utf16ToUtf8Impl(wstr.data(), wstr.size(), str.data(), true));
+    }
+    else
+    {
+        str.resize(Utf8LengthFromUtf32Impl(wstr.data(), wstr.size()));
+        str.resize(Utf32ToUtf8Impl(wstr.data(), wstr.size(), str.data(), true));
+    }
+    return str;
+}
+
+std::wstring StrU8ToWide(std::string_view str)
+{
+    std::wstring wstr;
+    if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+    {
+        wstr.resize(Utf16LengthFromUtf8(str));
+    }
+    else
+    {
+        wstr.resize(Utf32LengthFromUtf8(str));
+    }
+    wstr.resize(Utf8ToUtfImpl(str, wstr.data(), true));
+    return wstr;
+}
+
+} // namespace rad
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace rad
+{
+
+// Native UTF-8/UTF-16/UTF-32 validation and transcoding, inspired by simdutf:
+// https://github.com/simdutf/simdutf
+// Runs of ASCII are processed with SIMD (AVX2/SSE2/NEON), the rest is decoded one code point at a time.
+// Overlong forms, surrogate code points and values above U+10FFFF are invalid.
+
+bool Utf8Validate(std::string_view src);
+bool Utf16Validate(std::u16string_view src);
+bool Utf32Validate(std::u32string_view src);
+
+// Length-only counting passes (in code units of the destination encoding):
+// exact for valid input; for invalid input, never less than what the transcoders below write.
+size_t Utf8CountCodePoints(std::string_view src);
+size_t Utf16LengthFromUtf8(std::string_view src);
+size_t Utf32LengthFromUtf8(std::string_view src);
+size_t Utf8LengthFromUtf16(std::u16string_view src);
+size_t Utf32LengthFromUtf16(std::u16string_view src);
+size_t Utf8LengthFromUtf32(std::u32string_view src);
+size_t Utf16LengthFromUtf32(std::u32string_view src);
+
+// Transcode with validation into dst, which must be large enough (see the counting passes above).
+// Return the number of code units written, or 0 if the input is invalid.
+size_t Utf8ToUtf16(std::string_view src, char16_t* dst);
+size_t Utf8ToUtf32(std::string_view src, char32_t* dst);
+size_t Utf16ToUtf8(std::u16string_view src, char* dst);
+size_t Utf16ToUtf32(std::u16string_view src, char32_t* dst);
+size_t Utf32ToUtf8(std::u32string_view src, char* dst);
+size_t Utf32ToUtf16(std::u32string_view src, char16_t* dst);
+
+// Convenient conversions, invalid sequences are skipped.
+std::u16string StrU8ToU16(std::string_view src);
+std::u32string StrU8ToU32(std::string_view src);
+std::string StrU16ToU8(std::u16string_view src);
+std::string StrU32ToU8(std::u32string_view src);
+// wchar_t is UTF-16 on Windows, and UTF-32 on other platforms.
+std::string StrWideToU8(std::wstring_view wstr);
+std::wstring StrU8ToWide(std::string_view str);
+
+} // namespace rad
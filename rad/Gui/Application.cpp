@@ -9,17 +9,18 @@ spdlog::logger* GetGuiLogger()
     return logger.get();
 }
 
-static Application* g_app = nullptr;
+// Read by the threads releasing the textures.
+static std::atomic<Application*> g_app = nullptr;
 
 Application* GetApp()
 {
-    return g_app;
+    return g_app.load(std::memory_order_acquire);
 }
 
 Application::Application()
 {
-    assert(g_app == nullptr);
-    g_app = this;
+    [[maybe_unused]] Application* prev = g_app.exchange(this, std::memory_order_acq_rel);
+    assert(prev == nullptr);
 }
 
 Application::~Application()
@@ -66,11 +67,14 @@ bool Application::Init(int argc, char** argv)
 
 void Application::Destroy()
 {
-    if (g_app)
+    if (g_app.load(std::memory_order_acquire) == this)
     {
+        // The textures released from now on are deleted on the releasing thread,
+        // without SDL calls: SDL frees them with the renderers.
+        m_destroyQueue.Close();
         SDL_Quit();
         RAD_LOG(GetGuiLogger(), info, "SDL quited.");
-        g_app = nullptr;
+        g_app.store(nullptr, std::memory_order_release);
     }
 }
 
@@ -179,6 +183,8 @@ void Application::OnEvent(const SDL_Event& event)
 
 void Application::OnIdle()
 {
+    m_destroyQueue.Flush();
+
     for (EventHandler* handler : m_eventHandlers)
     {
         handler->OnIdle();
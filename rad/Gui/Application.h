@@ -3,6 +3,7 @@
 #include <rad/Core/Platform.h>
 #include <rad/Core/Integer.h>
 #include <rad/Core/Memory.h>
+#include <rad/Core/RefCounted.h>
 #include <rad/System/Program.h>
 #include <rad/IO/Logging.h>
 #include <rad/Gui/EventHandler.h>
@@ -67,6 +68,9 @@ public:
     void OnEvent(const SDL_Event& event);
     void OnIdle();
 
+    // Objects which must be destroyed on the main (render) thread, flushed on idle.
+    DeferredDestroyQueue& GetDestroyQueue() { return m_destroyQueue; }
+
     void SetExit(bool exit) { m_exit = exit; }
     bool GetExit() { return m_exit; }
 
@@ -99,6 +103,7 @@ private:
     std::vector<DisplayInfo> m_displays;
     std::mutex m_eventMutex;
     std::vector<EventHandler*> m_eventHandlers;
+    DeferredDestroyQueue m_destroyQueue;
 
     std::atomic_bool m_exit = false;
 
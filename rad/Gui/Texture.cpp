@@ -46,6 +46,13 @@ Texture::Texture(rad::Ref<Renderer> renderer, SDL_Texture* handle) :
 
 Texture::~Texture()
 {
+    // Once the destroy queue is closed, SDL is shutting down (or has quit) and frees the handle
+    // with the renderer, and the texture may be released on any thread.
+    Application* app = GetApp();
+    if (app && !app->GetDestroyQueue().IsClosed())
+    {
+        Destroy();
+    }
 }
 
 void Texture::Destroy()
@@ -57,6 +64,18 @@ void Texture::Destroy()
     }
 }
 
+void Texture::DestroyRefCounted(const Texture* texture)
+{
+    if (Application* app = GetApp())
+    {
+        app->GetDestroyQueue().Push(texture);
+    }
+    else
+    {
+        delete texture;
+    }
+}
+
 const char* Texture::GetError()
 {
     return SDL_GetError();
@@ -19,6 +19,8 @@ public:
     Texture(rad::Ref<Renderer> renderer, SDL_Texture* handle);
     ~Texture();
     void Destroy();
+    // Textures are destroyed on the main (render) thread.
+    static void DestroyRefCounted(const Texture* texture);
 
     SDL_Texture* GetHandle() { return m_handle; }
     const char* GetError();
@@ -6,6 +6,13 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#if !defined(RAD_OS_WINDOWS)
+#include <climits>
+#include <cstddef>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 namespace rad
 {
 
@@ -108,6 +115,57 @@ size_t File::Write(const void* buffer, size_t elementSize, size_t elementCount)
     return fwrite(buffer, elementSize, elementCount, m_handle);
 }
 
+size_t File::WriteChunks(const StrChunk* chunks, size_t count)
+{
+    size_t bytesWritten = 0;
+#if defined(RAD_OS_WINDOWS)
+    for (size_t i = 0; i < count; ++i)
+    {
+        bytesWritten += Write(chunks[i].data, 1, chunks[i].size);
+    }
+#else
+    static_assert((sizeof(StrChunk) == sizeof(iovec)) &&
+        (offsetof(StrChunk, data) == offsetof(iovec, iov_base)) &&
+        (offsetof(StrChunk, size) == offsetof(iovec, iov_len)));
+    // Flush the stream buffer before writing to the file descriptor.
+    Flush();
+    const int fd = fileno(m_handle);
+    size_t index = 0;
+    while (index < count)
+    {
+        const int iovCount = static_cast<int>((std::min<size_t>)(count - index, IOV_MAX));
+        const ssize_t result = ::writev(fd, reinterpret_cast<const iovec*>(chunks + index), iovCount);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        if ((result == 0) && (chunks[index].size > 0))
+        {
+            break;
+        }
+        bytesWritten += size_t(result);
+        // Skip the chunks written, and handle partial writes by writing the rest of the chunk.
+        size_t remain = size_t(result);
+        while ((index < count) && (remain >= chunks[index].size))
+        {
+            remain -= chunks[index].size;
+            ++index;
+        }
+        if (remain > 0)
+        {
+            bytesWritten += Write(chunks[index].data + remain, 1, chunks[index].size - remain);
+            Flush();
+            ++index;
+        }
+    }
+#endif
+    return bytesWritten;
+}
+
 int File::Print(const char* format, ...)
 {
     int ret = 0;
@@ -230,4 +288,24 @@ std::vector<std::string> File::ReadLines(std::string_view path)
     return lines;
 }
 
+size_t StrReplace(const StrReplacer& replacer, File& input, File& output, size_t chunkSize)
+{
+    assert(chunkSize > 0);
+    StrReplacer::Stream stream(replacer);
+    std::string chunk;
+    std::string replaced;
+    size_t bytesWritten = 0;
+    chunk.resize(chunkSize);
+    while (size_t bytesRead = input.Read(chunk.data(), 1, chunk.size()))
+    {
+        replaced.clear();
+        stream.Write(std::string_view(chunk.data(), bytesRead), replaced);
+        bytesWritten += output.Write(replaced.data(), 1, replaced.size());
+    }
+    replaced.clear();
+    stream.Finish(replaced);
+    bytesWritten += output.Write(replaced.data(), 1, replaced.size());
+    return bytesWritten;
+}
+
 } // namespace rad
@@ -39,6 +39,8 @@ public:
     size_t ReadLine(void* buffer, size_t bufferSize);
     size_t ReadLine(std::string& buffer);
     size_t Write(const void* buffer, size_t elementSize, size_t elementCount = 1);
+    // Write the chunks gathered (writev on POSIX), e.g. of StringBuilder; return the number of bytes written.
+    size_t WriteChunks(const StrChunk* chunks, size_t count);
 
     int Print(const char* format, ...);
 
@@ -65,4 +67,8 @@ private:
 
 }; // class File
 
+// Replace the remaining content of input and write to output chunk by chunk,
+// return the number of bytes written.
+size_t StrReplace(const StrReplacer& replacer, File& input, File& output, size_t chunkSize = 64 * 1024);
+
 } // namespace rad
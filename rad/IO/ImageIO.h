@@ -2,6 +2,7 @@
 
 #include <rad/Core/Platform.h>
 #include <rad/Core/String.h>
+#include <rad/Container/StridedSpan.h>
 
 #if defined(RAD_OS_WINDOWS)
 #define STBI_WINDOWS_UTF8
@@ -40,9 +41,24 @@ public:
     // i in rows; j in colums.
     unsigned char* GetPixel(int i, int j)
     {
-        size_t offset = (size_t(i) * size_t(m_width) + size_t(j)) *
-            size_t(m_channelCount);
-        return (m_data + offset);
+        return &GetView()(i, j, 0);
+    }
+
+    // (height, width, channelCount) view of the pixels.
+    SpanND<unsigned char, 3> GetView()
+    {
+        return SpanND<unsigned char, 3>(m_data, { size_t(m_height), size_t(m_width), size_t(m_channelCount) });
+    }
+
+    SpanND<const unsigned char, 3> GetView() const
+    {
+        return SpanND<const unsigned char, 3>(m_data, { size_t(m_height), size_t(m_width), size_t(m_channelCount) });
+    }
+
+    // A channel of all pixels, rows with the pitch width * channelCount.
+    Span2D<unsigned char> GetChannel(int channel)
+    {
+        return GetView().slice(2, channel);
     }
 
     void SetPixelR(int i, int j, unsigned r)
@@ -111,9 +127,24 @@ public:
 
     float* GetPixel(int i, int j)
     {
-        size_t offset = (size_t(i) * size_t(m_width) + size_t(j)) *
-            size_t(m_channelCount);
-        return (m_data + offset);
+        return &GetView()(i, j, 0);
+    }
+
+    // (height, width, channelCount) view of the pixels.
+    SpanND<float, 3> GetView()
+    {
+        return SpanND<float, 3>(m_data, { size_t(m_height), size_t(m_width), size_t(m_channelCount) });
+    }
+
+    SpanND<const float, 3> GetView() const
+    {
+        return SpanND<const float, 3>(m_data, { size_t(m_height), size_t(m_width), size_t(m_channelCount) });
+    }
+
+    // A channel of all pixels, rows with the pitch width * channelCount.
+    Span2D<float> GetChannel(int channel)
+    {
+        return GetView().slice(2, channel);
     }
 
     void SetPixelR(int i, int j, float r)
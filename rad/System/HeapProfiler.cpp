@@ -0,0 +1,185 @@
+#include <rad/System/HeapProfiler.h>
+#include <rad/IO/File.h>
+#include <rad/IO/Json.h>
+#include <backward.hpp>
+#include <format>
+
+namespace rad
+{
+
+struct HeapSample
+{
+    AllocTag tag;
+    std::size_t size;
+    backward::StackTrace stackTrace;
+};
+
+HeapProfiler::HeapProfiler() :
+    m_shards(std::make_unique<Shard[]>(ShardCount)),
+    m_sampleFilter(std::make_unique<std::atomic<uint32_t>[]>(FilterSize))
+{
+}
+
+HeapProfiler::~HeapProfiler()
+{
+    Stop();
+}
+
+void HeapProfiler::Start(uint32_t sampleInterval, int stackDepth)
+{
+    std::lock_guard lock(m_mutex);
+    m_sampleInterval = sampleInterval;
+    m_stackDepth = stackDepth;
+    m_isStarted = true;
+    SetAllocSampler(this, sampleInterval);
+    EnableAllocTracking(true);
+}
+
+void HeapProfiler::Stop()
+{
+    std::lock_guard lock(m_mutex);
+    if (m_isStarted)
+    {
+        // The counters are still useful, keep the tracking enabled.
+        SetAllocSampler(nullptr, 0);
+        m_isStarted = false;
+    }
+}
+
+size_t HeapProfiler::Hash(void* p, AllocTag tag)
+{
+    uint64_t h = uint64_t(reinterpret_cast<std::uintptr_t>(p)) ^ (uint64_t(tag) << 56);
+    // The finalizer of MurmurHash3, the low bits of the addresses are mostly zero.
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return size_t(h);
+}
+
+size_t HeapProfiler::GetLiveSampleCount()
+{
+    size_t count = 0;
+    for (size_t i = 0; i < ShardCount; ++i)
+    {
+        std::lock_guard lock(m_shards[i].mutex);
+        count += m_shards[i].samples.size();
+    }
+    return count;
+}
+
+void HeapProfiler::OnAlloc(AllocTag tag, void* p, std::size_t size)
+{
+    std::unique_ptr<HeapSample> sample = std::make_unique<HeapSample>();
+    sample->tag = tag;
+    sample->size = size;
+    sample->stackTrace.load_here(m_stackDepth);
+    // Skip load_here, OnAlloc and TrackAllocSlow.
+    sample->stackTrace.skip_n_firsts(3);
+    const size_t hash = Hash(p, tag);
+    // Counted before the address is returned to the caller, so visible to the thread that frees it.
+    m_sampleFilter[hash % FilterSize].fetch_add(1, std::memory_order_relaxed);
+    // Destroy the replaced sample (if any) out of the lock.
+    std::unique_ptr<HeapSample> replaced;
+    Shard& shard = m_shards[(hash / FilterSize) % ShardCount];
+    std::lock_guard lock(shard.mutex);
+    std::unique_ptr<HeapSample>& slot = shard.samples[{ p, tag }];
+    if (slot)
+    {
+        m_sampleFilter[hash % FilterSize].fetch_sub(1, std::memory_order_relaxed);
+    }
+    replaced = std::exchange(slot, std::move(sample));
+}
+
+void HeapProfiler::OnFree(AllocTag tag, void* p, std::size_t /*size*/)
+{
+    const size_t hash = Hash(p, tag);
+    if (m_sampleFilter[hash % FilterSize].load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+    // Destroy the sample out of the lock.
+    std::unique_ptr<HeapSample> sample;
+    {
+        Shard& shard = m_shards[(hash / FilterSize) % ShardCount];
+        std::lock_guard lock(shard.mutex);
+        auto iter = shard.samples.find({ p, tag });
+        if (iter == shard.samples.end())
+        {
+            return;
+        }
+        sample = std::move(iter->second);
+        shard.samples.erase(iter);
+        m_sampleFilter[hash % FilterSize].fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+std::string HeapProfiler::DumpJson(bool resolveSymbols)
+{
+    boost::json::object root;
+    boost::json::array tags;
+    for (const AllocTagStats& stats : GetAllocStats())
+    {
+        boost::json::object tag;
+        tag["name"] = stats.name;
+        tag["allocCount"] = stats.allocCount;
+        tag["freeCount"] = stats.freeCount;
+        tag["allocBytes"] = stats.allocBytes;
+        tag["freeBytes"] = stats.freeBytes;
+        tags.push_back(std::move(tag));
+    }
+    root["tags"] = std::move(tags);
+
+    boost::json::array samples;
+    {
+        std::lock_guard lock(m_mutex);
+        root["sampleInterval"] = m_sampleInterval;
+    }
+    for (size_t shardIndex = 0; shardIndex < ShardCount; ++shardIndex)
+    {
+        std::lock_guard lock(m_shards[shardIndex].mutex);
+        for (const auto& [key, sample] : m_shards[shardIndex].samples)
+        {
+            boost::json::object sampleObject;
+            sampleObject["tag"] = GetAllocTagName(sample->tag);
+            sampleObject["size"] = sample->size;
+            sampleObject["address"] = std::format("{}", static_cast<const void*>(key.first));
+            boost::json::array frames;
+            backward::TraceResolver resolver;
+            if (resolveSymbols)
+            {
+                resolver.load_stacktrace(sample->stackTrace);
+            }
+            for (size_t i = 0; i < sample->stackTrace.size(); ++i)
+            {
+                boost::json::object frame;
+                backward::Trace trace = sample->stackTrace[i];
+                frame["address"] = std::format("{}", static_cast<const void*>(trace.addr));
+                if (resolveSymbols)
+                {
+                    backward::ResolvedTrace resolved = resolver.resolve(backward::ResolvedTrace(trace));
+                    frame["function"] = resolved.object_function;
+                    frame["file"] = resolved.source.filename;
+                    frame["line"] = resolved.source.line;
+                }
+                frames.push_back(std::move(frame));
+            }
+            sampleObject["stack"] = std::move(frames);
+            samples.push_back(std::move(sampleObject));
+        }
+    }
+    root["samples"] = std::move(samples);
+    return boost::json::serialize(root);
+}
+
+bool HeapProfiler::DumpJsonToFile(std::string_view fileName, bool resolveSymbols)
+{
+    std::string json = DumpJson(resolveSymbols);
+    File file;
+    if (!file.Open(fileName, "w"))
+    {
+        return false;
+    }
+    return (file.Write(json.data(), 1, json.size()) == json.size());
+}
+
+} // namespace rad
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <rad/Core/Platform.h>
+#include <rad/Core/AllocTracker.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <map>
+
+namespace rad
+{
+
+struct HeapSample;
+
+// Sampling heap profiler: records the stack of every Nth tracked allocation (rad/Core/AllocTracker.h)
+// until it is freed, and dumps the per-tag counters with the live samples as JSON;
+// must outlive the tracking calls on the other threads after Stop.
+class HeapProfiler : public AllocSampler
+{
+public:
+    HeapProfiler();
+    ~HeapProfiler();
+
+    // Enable the allocation tracking and install the profiler as the sampler.
+    void Start(uint32_t sampleInterval = 1024, int stackDepth = 32);
+    void Stop();
+
+    size_t GetLiveSampleCount();
+    // Resolving the symbols may be slow.
+    std::string DumpJson(bool resolveSymbols = true);
+    bool DumpJsonToFile(std::string_view fileName, bool resolveSymbols = true);
+
+    void OnAlloc(AllocTag tag, void* p, std::size_t size) override;
+    void OnFree(AllocTag tag, void* p, std::size_t size) override;
+
+private:
+    static constexpr size_t ShardCount = 64;
+    static constexpr size_t FilterSize = 16 * 1024;
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        // The same address may be tracked by multiple tags (e.g. a RefCounted object in a pool block).
+        std::map<std::pair<void*, AllocTag>, std::unique_ptr<HeapSample>> samples;
+    };
+
+    static size_t Hash(void* p, AllocTag tag);
+
+    std::mutex m_mutex;
+    std::unique_ptr<Shard[]> m_shards;
+    // Counts the live samples per hash: most of the frees are not sampled, and return without a lock
+    // if the count is zero.
+    std::unique_ptr<std::atomic<uint32_t>[]> m_sampleFilter;
+    uint32_t m_sampleInterval = 0;
+    int m_stackDepth = 32;
+    bool m_isStarted = false;
+
+}; // class HeapProfiler
+
+} // namespace rad
@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+#include <rad/Container/ConcurrentQueue.h>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+template<class Queue>
+static void TestQueueSingleThread()
+{
+    Queue queue(5);
+    EXPECT_EQ(queue.GetCapacity(), 8);
+    EXPECT_TRUE(queue.IsEmpty());
+    std::unique_ptr<int> value;
+    EXPECT_FALSE(queue.TryPop(value));
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.TryPush(std::make_unique<int>(i)));
+    }
+    value = std::make_unique<int>(8);
+    EXPECT_FALSE(queue.TryPush(std::move(value)));
+    // Not moved if full.
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(queue.GetSize(), 8);
+    EXPECT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(*value, 0);
+
+    std::unique_ptr<int> values[8];
+    // Empty batches return at once, with both a ready and a free cell.
+    EXPECT_EQ(queue.TryPopBatch(values, 0), 0);
+    EXPECT_EQ(queue.TryPushBatch(values, 0), 0);
+    EXPECT_EQ(queue.GetSize(), 7);
+    EXPECT_EQ(queue.TryPopBatch(values, 3), 3);
+    EXPECT_EQ(*values[2], 3);
+    for (int i = 0; i < 8; ++i)
+    {
+        values[i] = std::make_unique<int>(100 + i);
+    }
+    EXPECT_EQ(queue.TryPushBatch(values, 8), 4);
+    EXPECT_EQ(values[3], nullptr);
+    EXPECT_NE(values[4], nullptr);
+    EXPECT_EQ(queue.TryPopBatch(values, 8), 8);
+    EXPECT_EQ(*values[0], 4);
+    EXPECT_EQ(*values[7], 103);
+    EXPECT_EQ(queue.TryPopBatch(values, 8), 0);
+
+    // The remaining values are destroyed with the queue.
+    EXPECT_TRUE(queue.TryPush(std::make_unique<int>(0)));
+}
+
+TEST(Container, SpscQueue)
+{
+    TestQueueSingleThread<rad::SpscQueue<std::unique_ptr<int>>>();
+
+    // The consumer sees the values in order.
+    constexpr uint64_t Count = 200000;
+    rad::SpscQueue<uint64_t> queue(64);
+    std::thread producer([&]()
+    {
+        uint64_t batch[16];
+        uint64_t next = 0;
+        while (next < Count)
+        {
+            if (next % 3 == 0)
+            {
+                const size_t count = (std::min)(uint64_t(16), Count - next);
+                std::iota(batch, batch + count, next);
+                const size_t pushed = queue.TryPushBatch(batch, count);
+                next += pushed;
+                if (pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            else if (queue.TryPush(next))
+            {
+                ++next;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t expected = 0;
+    uint64_t batch[16];
+    bool isOrdered = true;
+    while (expected < Count)
+    {
+        const size_t count = queue.TryPopBatch(batch, 16);
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            isOrdered &= (batch[i] == expected++);
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(isOrdered);
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(Container, MpmcQueue)
+{
+    TestQueueSingleThread<rad::MpmcQueue<std::unique_ptr<int>>>();
+
+    // Each value is popped exactly once.
+    constexpr int ThreadCount = 4;
+    constexpr uint64_t CountPerThread = 50000;
+    rad::MpmcQueue<uint64_t> queue(256);
+    std::vector<std::vector<uint32_t>> popCounts(ThreadCount,
+        std::vector<uint32_t>(ThreadCount * CountPerThread));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            const uint64_t begin = t * CountPerThread;
+            for (uint64_t i = 0; i < CountPerThread;)
+            {
+                if (i % 2 == 0)
+                {
+                    uint64_t batch[8];
+                    const size_t count = (std::min)(uint64_t(8), CountPerThread - i);
+                    std::iota(batch, batch + count, begin + i);
+                    const size_t pushed = queue.TryPushBatch(batch, count);
+                    i += pushed;
+                    if (pushed == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                else if (queue.TryPush(begin + i))
+                {
+                    ++i;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::atomic<uint64_t> poppedCount = 0;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            uint64_t batch[8];
+            while (poppedCount.load() < ThreadCount * CountPerThread)
+            {
+                size_t count = 0;
+                if (t % 2 == 0)
+                {
+                    count = queue.TryPopBatch(batch, 8);
+                }
+                else
+                {
+                    count = queue.TryPop(batch[0]) ? 1 : 0;
+                }
+                if (count == 0)
+                {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < count; ++i)
+                {
+                    ++popCounts[t][batch[i]];
+                }
+                poppedCount += count;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    bool isExactlyOnce = true;
+    for (size_t i = 0; i < ThreadCount * CountPerThread; ++i)
+    {
+        uint32_t count = 0;
+        for (int t = 0; t < ThreadCount; ++t)
+        {
+            count += popCounts[t][i];
+        }
+        isExactlyOnce &= (count == 1);
+    }
+    EXPECT_TRUE(isExactlyOnce);
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(Container, BlockingQueue)
+{
+    // Small capacity to block both sides.
+    constexpr int ThreadCount = 3;
+    constexpr uint64_t CountPerThread = 100000;
+    rad::BlockingMpmcQueue<uint64_t> queue(4);
+    // Empty batches don't wait.
+    uint64_t empty[1] = {};
+    queue.PushBatch(empty, 0);
+    EXPECT_EQ(queue.PopBatch(empty, 0), 0);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        producers.emplace_back([&, t]()
+        {
+            for (uint64_t i = 0; i < CountPerThread; i += 4)
+            {
+                uint64_t batch[4] = { i + 1, i + 2, i + 3, i + 4 };
+                if (t == 0)
+                {
+                    queue.PushBatch(batch, 4);
+                }
+                else
+                {
+                    for (uint64_t value : batch)
+                    {
+                        queue.Push(value);
+                    }
+                }
+            }
+        });
+    }
+    uint64_t sum = 0;
+    for (uint64_t popped = 0; popped < ThreadCount * CountPerThread;)
+    {
+        if (popped % 2 == 0)
+        {
+            sum += queue.Pop();
+            ++popped;
+        }
+        else
+        {
+            uint64_t batch[3];
+            const size_t count = queue.PopBatch(batch, 3);
+            sum += std::accumulate(batch, batch + count, uint64_t(0));
+            popped += count;
+        }
+    }
+    for (std::thread& thread : producers)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(sum, ThreadCount * CountPerThread * (CountPerThread + 1) / 2);
+
+    rad::BlockingSpscQueue<int> spsc(2);
+    std::thread consumer([&]()
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            EXPECT_EQ(spsc.Pop(), i);
+        }
+    });
+    for (int i = 0; i < 1000; ++i)
+    {
+        spsc.Push(i);
+    }
+    consumer.join();
+}
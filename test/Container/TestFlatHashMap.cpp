@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <rad/Container/FlatHashMap.h>
+#include <rad/Core/String.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+TEST(Container, WyHash)
+{
+    // The reference vectors of wyhash final 4 (test_vector.cpp, seed = index, default secret),
+    // covering the 0, 1-3, 4-16, 17-48 and > 48 byte paths.
+    const std::pair<std::string_view, uint64_t> vectors[] =
+    {
+        { "", 0x93228A4DE0EEC5A2ull },
+        { "a", 0xC5BAC3DB178713C4ull },
+        { "abc", 0xA97F2F7B1D9B3314ull },
+        { "message digest", 0x786D1F1DF3801DF4ull },
+        { "abcdefghijklmnopqrstuvwxyz", 0xDCA5A8138AD37C87ull },
+        { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 0xB9E734F117CFAF70ull },
+        { "12345678901234567890123456789012345678901234567890123456789012345678901234567890", 0x6CC5EAB49A92D617ull },
+    };
+    for (size_t i = 0; i < std::size(vectors); ++i)
+    {
+        EXPECT_EQ(rad::WyHash(vectors[i].first, i), vectors[i].second) << "\"" << vectors[i].first << "\"";
+    }
+
+    const std::string text(100, 'x');
+    for (size_t size = 0; size <= text.size(); ++size)
+    {
+        EXPECT_EQ(rad::WyHash(text.data(), size), rad::WyHash(std::string_view(text.data(), size)));
+        if (size > 0)
+        {
+            EXPECT_NE(rad::WyHash(text.data(), size), rad::WyHash(text.data(), size - 1));
+        }
+    }
+    EXPECT_NE(rad::WyHash("abc", 3, 0), rad::WyHash("abc", 3, 1));
+    EXPECT_EQ(rad::StrCaseHash("Hello"), rad::StrCaseHash("hELLO"));
+}
+
+TEST(Container, FlatHashMap)
+{
+    rad::FlatHashMap<int, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+    EXPECT_EQ(map.begin(), map.end());
+
+    // Compare with std::unordered_map on random operations.
+    std::unordered_map<int, int> expected;
+    std::mt19937 random(42);
+    for (int i = 0; i < 100000; ++i)
+    {
+        const int key = static_cast<int>(random() % 5000);
+        switch (random() % 4)
+        {
+        case 0:
+        case 1:
+            map[key] = i;
+            expected[key] = i;
+            break;
+        case 2:
+            EXPECT_EQ(map.erase(key), expected.erase(key));
+            break;
+        case 3:
+            EXPECT_EQ(map.contains(key), expected.contains(key));
+            break;
+        }
+    }
+    ASSERT_EQ(map.size(), expected.size());
+    size_t count = 0;
+    for (const auto& [key, value] : map)
+    {
+        EXPECT_EQ(expected.at(key), value);
+        ++count;
+    }
+    EXPECT_EQ(count, expected.size());
+    EXPECT_LE(map.load_factor(), map.max_load_factor());
+
+    // Erase while iterating.
+    for (auto iter = map.begin(); iter != map.end();)
+    {
+        iter = (iter->first % 2) ? map.erase(iter) : std::next(iter);
+    }
+    for (const auto& [key, value] : map)
+    {
+        EXPECT_EQ(key % 2, 0);
+    }
+
+    rad::FlatHashMap<int, int> copied = map;
+    EXPECT_EQ(copied, map);
+    rad::FlatHashMap<int, int> moved = std::move(copied);
+    EXPECT_TRUE(copied.empty());
+    EXPECT_EQ(moved, map);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_NE(moved, map);
+    EXPECT_THROW(map.at(0), std::out_of_range);
+
+    map.rehash(0);
+    EXPECT_EQ(map.capacity(), 0);
+    map.reserve(1000);
+    const size_t capacity = map.capacity();
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.try_emplace(i, i);
+    }
+    EXPECT_EQ(map.capacity(), capacity);
+    // Insert an element constructed from another one on growth.
+    for (int i = 1000; i < 5000; ++i)
+    {
+        map.try_emplace(i, map.at(i - 1000));
+    }
+    EXPECT_EQ(map.at(4999), 999);
+
+    // The same with the values owning heap memory, which is freed by the rehash.
+    rad::FlatHashMap<int, std::string> strings;
+    strings.try_emplace(0, std::string(100, 'x'));
+    for (int i = 1; i < 5000; ++i)
+    {
+        strings.try_emplace(i, strings.at(i - 1));
+    }
+    EXPECT_EQ(strings.at(4999), std::string(100, 'x'));
+}
+
+TEST(Container, FlatHashMapString)
+{
+    rad::FlatHashMap<std::string, std::unique_ptr<int>> map;
+    for (int i = 0; i < 1000; ++i)
+    {
+        map.try_emplace(std::to_string(i), std::make_unique<int>(i));
+    }
+    // Heterogeneous lookup without temporary strings.
+    std::string_view key = "123";
+    ASSERT_NE(map.find(key), map.end());
+    EXPECT_EQ(*map.find(key)->second, 123);
+    EXPECT_EQ(*map.at("999"), 999);
+    EXPECT_TRUE(map.contains("0"));
+    EXPECT_FALSE(map.contains("1000"));
+    EXPECT_FALSE(map.try_emplace(key, nullptr).second);
+    EXPECT_TRUE(map.try_emplace(std::string_view("abc"), nullptr).second);
+    EXPECT_EQ(map.erase("abc"), 1);
+    EXPECT_EQ(map.size(), 1000);
+
+    auto [iter, inserted] = map.insert_or_assign("123", std::make_unique<int>(-1));
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(*iter->second, -1);
+
+    rad::FlatHashMap<std::string, int, rad::StringHashCaseInsensitive, rad::StringEqualCaseInsensitive> caseMap;
+    caseMap["Hello"] = 1;
+    EXPECT_EQ(caseMap.at("HELLO"), 1);
+}
+
+TEST(Container, FlatHashSet)
+{
+    rad::FlatHashSet<std::string> set = { "a", "b", "c" };
+    EXPECT_EQ(set.size(), 3);
+    EXPECT_FALSE(set.insert("a").second);
+    EXPECT_TRUE(set.insert(std::string_view("d")).second);
+    EXPECT_TRUE(set.emplace(3, 'e').second);
+    EXPECT_TRUE(set.contains("eee"));
+    EXPECT_EQ(set.erase(std::string_view("b")), 1);
+    EXPECT_EQ(set.count("b"), 0);
+    EXPECT_EQ(set.size(), 4);
+
+    rad::FlatHashSet<const void*> pointers;
+    int values[64] = {};
+    for (int& value : values)
+    {
+        pointers.insert(&value);
+    }
+    EXPECT_EQ(pointers.size(), 64);
+    EXPECT_TRUE(pointers.contains(&values[63]));
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <rad/Container/FlatMap.h>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+
+TEST(Container, RadixSort)
+{
+    std::mt19937 random(42);
+    for (size_t count : { size_t(0), size_t(10), size_t(1000), size_t(10000) })
+    {
+        std::vector<int> ints(count);
+        std::vector<double> doubles(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            ints[i] = static_cast<int>(random() % 2000) - 1000;
+            doubles[i] = (static_cast<double>(random()) - 2e9) * 1e-3;
+        }
+
+        std::vector<size_t> indices = rad::RadixSortIndices(ints.data(), ints.size());
+        EXPECT_EQ(indices, rad::SortIndices(ints));
+
+        std::vector<int> sortedInts = ints;
+        rad::RadixSort(sortedInts);
+        std::vector<double> sortedDoubles = doubles;
+        rad::RadixSort(sortedDoubles);
+        std::sort(ints.begin(), ints.end());
+        std::sort(doubles.begin(), doubles.end());
+        EXPECT_EQ(sortedInts, ints);
+        EXPECT_EQ(sortedDoubles, doubles);
+
+        for (int value : { -2000, -1000, -1, 0, 1, 500, 999, 2000 })
+        {
+            EXPECT_EQ(rad::BranchlessLowerBound(ints.data(), ints.size(), value),
+                size_t(std::lower_bound(ints.begin(), ints.end(), value) - ints.begin()));
+        }
+    }
+}
+
+TEST(Container, RadixSortSignedZero)
+{
+    // The zeros compare equal: stable in both the comparison and the radix paths.
+    for (size_t count : { size_t(10), size_t(1000) })
+    {
+        std::vector<double> keys(count);
+        std::vector<int> values(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            keys[i] = (i % 2 == 0) ? 0.0 : -0.0;
+            values[i] = static_cast<int>(i);
+        }
+        keys[count - 1] = -1.0;
+        std::vector<size_t> indices = rad::RadixSortIndices(keys.data(), keys.size());
+        EXPECT_EQ(indices, rad::SortIndices(keys));
+
+        // Keeps the first of the duplicate keys, +0.0 here.
+        rad::FlatMap<double, int> map(keys, values);
+        ASSERT_EQ(map.size(), 2);
+        EXPECT_FALSE(std::signbit(map.keys()[1]));
+        EXPECT_EQ(map.at(-0.0), 0);
+    }
+}
+
+TEST(Container, FlatMap)
+{
+    // Bulk construction keeps the first of the duplicate keys.
+    rad::FlatMap<int, std::string> map({ 3, 1, 2, 1, 3 }, { "c", "a", "b", "x", "y" });
+    ASSERT_EQ(map.size(), 3);
+    EXPECT_EQ(map.keys()[0], 1);
+    EXPECT_EQ(map.keys()[2], 3);
+    EXPECT_EQ(map.at(1), "a");
+    EXPECT_EQ(map.at(3), "c");
+    EXPECT_THROW(map.at(4), std::out_of_range);
+    EXPECT_EQ(map.find(4), map.end());
+    EXPECT_EQ(map.find(2)->second, "b");
+
+    EXPECT_TRUE(map.try_emplace(0, "z").second);
+    EXPECT_FALSE(map.try_emplace(0, "w").second);
+    map.insert_or_assign(2, "B");
+    map[5] = "e";
+    EXPECT_EQ(map.erase(1), 1);
+    EXPECT_EQ(map.erase(1), 0);
+    std::string joined;
+    for (const auto& [key, value] : map)
+    {
+        joined += std::to_string(key) + value;
+    }
+    EXPECT_EQ(joined, "0z2B3c5e");
+    for (auto iter = map.begin(); iter != map.end(); ++iter)
+    {
+        iter->second += "!";
+    }
+    EXPECT_EQ(map.values()[0], "z!");
+
+    // Compare with std::map, with the binary search and with the Eytzinger layout.
+    std::mt19937 random(42);
+    std::vector<uint32_t> keys(50000);
+    std::vector<uint32_t> values(keys.size());
+    std::map<uint32_t, uint32_t> expected;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] = static_cast<uint32_t>(random() % 100000);
+        values[i] = static_cast<uint32_t>(i);
+        expected.emplace(keys[i], values[i]);
+    }
+    rad::FlatMap<uint32_t, uint32_t> numbers(keys, values);
+    ASSERT_EQ(numbers.size(), expected.size());
+    EXPECT_TRUE(std::equal(numbers.begin(), numbers.end(), expected.begin(), expected.end(),
+        [](const auto& a, const auto& b) { return (a.first == b.first) && (a.second == b.second); }));
+    for (bool eytzinger : { false, true })
+    {
+        numbers.SetEytzingerSearch(eytzinger);
+        for (uint32_t key = 0; key <= 100001; key += 7)
+        {
+            auto iter = numbers.lower_bound(key);
+            auto expectedIter = expected.lower_bound(key);
+            if (expectedIter == expected.end())
+            {
+                EXPECT_EQ(iter, numbers.end());
+            }
+            else
+            {
+                ASSERT_NE(iter, numbers.end());
+                EXPECT_EQ(iter->first, expectedIter->first);
+                EXPECT_EQ(iter->second, expectedIter->second);
+            }
+        }
+    }
+    numbers.erase(numbers.begin());
+    expected.erase(expected.begin());
+    EXPECT_EQ(numbers.find(expected.begin()->first)->second, expected.begin()->second);
+    numbers.SetEytzingerSearch(false);
+    EXPECT_EQ(numbers.find(expected.rbegin()->first)->second, expected.rbegin()->second);
+
+    // Comparison sort with the transparent comparator.
+    rad::FlatMap<std::string, int> names = { { "b", 2 }, { "a", 1 }, { "c", 3 } };
+    EXPECT_EQ(names.at(std::string_view("b")), 2);
+    EXPECT_TRUE(names.contains("c"));
+    EXPECT_FALSE(names.contains("d"));
+}
+
+TEST(Container, FlatSet)
+{
+    rad::FlatSet<std::string> names = { "b", "a", "c", "a" };
+    ASSERT_EQ(names.size(), 3);
+    EXPECT_EQ(*names.begin(), "a");
+    EXPECT_TRUE(names.contains(std::string_view("b")));
+    EXPECT_TRUE(names.insert("d").second);
+    EXPECT_FALSE(names.insert("d").second);
+    EXPECT_EQ(names.erase("a"), 1);
+    EXPECT_EQ(*names.begin(), "b");
+
+    std::mt19937 random(42);
+    std::vector<int64_t> keys(10000);
+    for (int64_t& key : keys)
+    {
+        key = static_cast<int64_t>(random() % 20000) - 10000;
+    }
+    rad::FlatSet<int64_t> numbers(keys);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    EXPECT_TRUE(std::equal(numbers.begin(), numbers.end(), keys.begin(), keys.end()));
+    numbers.SetEytzingerSearch(true);
+    for (int64_t key = -10001; key <= 10001; ++key)
+    {
+        EXPECT_EQ(numbers.lower_bound(key) - numbers.begin(),
+            std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+        EXPECT_EQ(numbers.contains(key), std::binary_search(keys.begin(), keys.end(), key));
+    }
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <rad/Container/SegmentedVector.h>
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(Container, SegmentedVector)
+{
+    using Vector = rad::SegmentedVector<int, 4>;
+    for (size_t index = 0; index < 1000; ++index)
+    {
+        const Vector::Location location = Vector::Locate(index);
+        EXPECT_LT(location.offset, Vector::GetSegmentSize(location.segment));
+        EXPECT_EQ(Vector::GetSegmentFirstIndex(location.segment) + location.offset, index);
+    }
+    EXPECT_EQ(Vector::Locate(3).segment, 0);
+    EXPECT_EQ(Vector::Locate(4).segment, 1);
+    EXPECT_EQ(Vector::Locate(11).segment, 1);
+    EXPECT_EQ(Vector::Locate(12).segment, 2);
+
+    // The segment table is allocated with the first segment.
+    Vector values;
+    EXPECT_EQ(values.begin(), values.end());
+    EXPECT_EQ(Vector::max_size(), Vector::GetSegmentFirstIndex(Vector::MaxSegmentCount));
+    EXPECT_THROW(values.reserve(Vector::max_size() + 1), std::length_error);
+
+    // The addresses are stable during growth.
+    std::vector<int*> addresses;
+    for (int i = 0; i < 1000; ++i)
+    {
+        addresses.push_back(&values.emplace_back(i));
+    }
+    EXPECT_EQ(values.size(), 1000);
+    EXPECT_GE(values.capacity(), 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(&values[i], addresses[i]);
+        EXPECT_EQ(*addresses[i], i);
+    }
+    EXPECT_EQ(values.front(), 0);
+    EXPECT_EQ(values.back(), 999);
+    EXPECT_THROW(values.at(1000), std::out_of_range);
+
+    std::vector<int> expected(1000);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), expected.begin(), expected.end()));
+    EXPECT_EQ(values.end() - values.begin(), 1000);
+    EXPECT_EQ(*(values.begin() + 500), 500);
+    EXPECT_EQ(*(values.end() - 1), 999);
+    EXPECT_EQ(std::lower_bound(values.begin(), values.end(), 321) - values.begin(), 321);
+
+    // The segments cover the elements in order.
+    size_t visited = 0;
+    values.ForEachSegment([&](rad::MutableSpan<int> segment, size_t firstIndex)
+        {
+            EXPECT_EQ(firstIndex, visited);
+            EXPECT_EQ(segment[0], int(firstIndex));
+            for (int& value : segment)
+            {
+                value *= 2;
+            }
+            visited += segment.size();
+        });
+    EXPECT_EQ(visited, values.size());
+    EXPECT_EQ(values[999], 1998);
+
+    values.resize(10);
+    EXPECT_EQ(values.size(), 10);
+    EXPECT_EQ(values.GetSegmentCount(), 2);
+    EXPECT_EQ(&values[9], addresses[9]);
+    values.shrink_to_fit();
+    EXPECT_EQ(values.capacity(), 12);
+    values.pop_back();
+    EXPECT_EQ(values.back(), 16);
+    values.clear();
+    EXPECT_TRUE(values.empty());
+    EXPECT_EQ(values.begin(), values.end());
+
+    // Full to the capacity: end() is past the last allocated segment.
+    Vector full(12);
+    EXPECT_EQ(full.capacity(), 12);
+    EXPECT_EQ(std::distance(full.begin(), full.end()), 12);
+}
+
+TEST(Container, SegmentedVectorNonTrivial)
+{
+    rad::SegmentedVector<std::string> strings = { "a", "b", "c" };
+    for (int i = 0; i < 100; ++i)
+    {
+        strings.push_back(std::to_string(i) + " long enough to be allocated on the heap");
+    }
+    const std::string* pFirst = &strings[3];
+
+    rad::SegmentedVector<std::string> copy = strings;
+    EXPECT_EQ(copy, strings);
+    EXPECT_NE(&copy[3], pFirst);
+
+    rad::SegmentedVector<std::string> moved = std::move(strings);
+    EXPECT_EQ(&moved[3], pFirst);
+    EXPECT_TRUE(strings.empty());
+    EXPECT_EQ(moved, copy);
+
+    copy = moved;
+    copy.resize(50);
+    EXPECT_EQ(copy.back(), moved[49]);
+    copy = std::move(moved);
+    EXPECT_EQ(copy.size(), 103);
+    EXPECT_EQ(&copy[3], pFirst);
+
+    rad::SegmentedVector<std::unique_ptr<int>> pointers;
+    for (int i = 0; i < 100; ++i)
+    {
+        pointers.emplace_back(std::make_unique<int>(i));
+    }
+    const rad::SegmentedVector<std::unique_ptr<int>>& readOnly = pointers;
+    int sum = 0;
+    readOnly.ForEachSegment([&](rad::Span<std::unique_ptr<int>> segment, size_t)
+        {
+            for (const std::unique_ptr<int>& p : segment)
+            {
+                sum += *p;
+            }
+        });
+    EXPECT_EQ(sum, 4950);
+}
+
+namespace
+{
+
+// Throws on the constructions after the budget is spent.
+struct ThrowingElement
+{
+    static inline int s_liveCount = 0;
+    static inline int s_constructBudget = 0;
+
+    ThrowingElement() { Construct(); }
+    ThrowingElement(const ThrowingElement&) { Construct(); }
+    ~ThrowingElement() { --s_liveCount; }
+
+    void Construct()
+    {
+        if (s_constructBudget-- <= 0)
+        {
+            throw std::runtime_error("ThrowingElement");
+        }
+        ++s_liveCount;
+    }
+};
+
+} // namespace
+
+TEST(Container, SegmentedVectorExceptionSafety)
+{
+    using Vector = rad::SegmentedVector<ThrowingElement, 4>;
+    // The segments are leak checked by the sanitizers.
+    ThrowingElement::s_constructBudget = 10;
+    EXPECT_THROW(Vector(20), std::runtime_error);
+    EXPECT_EQ(ThrowingElement::s_liveCount, 0);
+
+    ThrowingElement::s_constructBudget = 3;
+    Vector values(3);
+    // 3 copies into the list, 2 of them into the vector.
+    ThrowingElement::s_constructBudget = 5;
+    EXPECT_THROW(Vector({ values[0], values[1], values[2] }), std::runtime_error);
+    EXPECT_EQ(ThrowingElement::s_liveCount, 3);
+
+    ThrowingElement::s_constructBudget = 2;
+    EXPECT_THROW(Vector copy(values), std::runtime_error);
+    EXPECT_EQ(ThrowingElement::s_liveCount, 3);
+    ThrowingElement::s_constructBudget = 3;
+    Vector copy(values);
+    EXPECT_EQ(ThrowingElement::s_liveCount, 6);
+}
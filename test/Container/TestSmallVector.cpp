@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <rad/Container/SmallVector.h>
+#include <rad/Container/Span.h>
+#include <memory>
+#include <string>
+
+TEST(Container, SmallVector)
+{
+    rad::SmallVector<int, 4> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v.capacity(), 4);
+    EXPECT_LT(sizeof(v), sizeof(int*) + 2 * sizeof(std::size_t) + 4 * sizeof(int));
+    for (int i = 0; i < 4; ++i)
+    {
+        v.push_back(i);
+    }
+    EXPECT_TRUE(v.is_inline());
+    for (int i = 4; i < 100; ++i)
+    {
+        v.push_back(i);
+    }
+    EXPECT_FALSE(v.is_inline());
+    ASSERT_EQ(v.size(), 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(v[i], i);
+    }
+    // Push an element of itself on growth.
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 100);
+    v.push_back(v[50]);
+    EXPECT_EQ(v.back(), 50);
+
+    v.erase(v.begin() + 10, v.begin() + 90);
+    EXPECT_EQ(v.size(), 21);
+    EXPECT_EQ(v[10], 90);
+    v.insert(v.begin() + 1, 3, -1);
+    EXPECT_EQ(v[3], -1);
+    EXPECT_EQ(v[4], 1);
+    v.insert(v.begin(), { 7, 8 });
+    EXPECT_EQ(v[0], 7);
+    EXPECT_EQ(v[2], 0);
+    v.emplace(v.begin(), v.back());
+    EXPECT_EQ(v[0], 50);
+
+    v.resize(2);
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v, (rad::SmallVector<int, 4>{ 50, 7 }));
+    EXPECT_LT(v, (rad::SmallVector<int, 4>{ 50, 8 }));
+    EXPECT_THROW(v.at(2), std::out_of_range);
+
+    rad::Span<int> span = v;
+    EXPECT_EQ(span.size(), 2);
+    EXPECT_EQ(span.data(), v.data());
+}
+
+TEST(Container, SmallVectorNonTrivial)
+{
+    using StringVector = rad::SmallVector<std::string, 2>;
+    StringVector v = { "a", "b" };
+    StringVector copied = v;
+    v.emplace_back(64, 'c');
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_EQ(copied.size(), 2);
+    v.insert(v.begin(), v[2]);
+    EXPECT_EQ(v[0], std::string(64, 'c'));
+    v.erase(v.begin() + 1);
+    EXPECT_EQ(v[1], "b");
+
+    // Inline storage is relocated, heap storage is taken over.
+    StringVector moved = std::move(copied);
+    EXPECT_TRUE(copied.empty());
+    EXPECT_EQ(moved[1], "b");
+    const std::string* data = v.data();
+    StringVector movedHeap = std::move(v);
+    EXPECT_EQ(movedHeap.data(), data);
+    swap(moved, movedHeap);
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_EQ(movedHeap.size(), 2);
+
+    rad::SmallVector<std::unique_ptr<int>, 1> pointers;
+    for (int i = 0; i < 10; ++i)
+    {
+        pointers.push_back(std::make_unique<int>(i));
+    }
+    pointers.erase(pointers.begin());
+    EXPECT_EQ(*pointers.front(), 1);
+    pointers.resize(20);
+    EXPECT_EQ(pointers.back(), nullptr);
+}
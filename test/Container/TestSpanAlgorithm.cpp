@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <rad/Container/SpanAlgorithm.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+TEST(Container, MutableSpan)
+{
+    std::vector<int> values = { 1, 2, 3, 4, 5 };
+    rad::MutableSpan<int> span = values;
+    span[0] = 10;
+    span.back() = 50;
+    for (int& value : span.slice(1, 3))
+    {
+        value *= 2;
+    }
+    EXPECT_EQ(values, (std::vector<int>{ 10, 4, 6, 8, 50 }));
+    rad::Span<int> readOnly = span.drop_front(2);
+    EXPECT_EQ(readOnly.size(), 3);
+    EXPECT_EQ(readOnly.front(), 6);
+    EXPECT_EQ(span.take_back(1)[0], 50);
+}
+
+template<typename T>
+static void TestSpanAlgorithms()
+{
+    std::mt19937 random(42);
+    for (size_t count : { size_t(1), size_t(7), size_t(64), size_t(100), size_t(1000), size_t(4099) })
+    {
+        std::vector<T> values(count);
+        for (T& value : values)
+        {
+            value = static_cast<T>(random() % 100);
+        }
+        const T minValue = *std::min_element(values.begin(), values.end());
+        const T maxValue = *std::max_element(values.begin(), values.end());
+        EXPECT_EQ(rad::SpanMinMax(values), std::make_pair(minValue, maxValue));
+        EXPECT_EQ(rad::SpanSum(values),
+            std::accumulate(values.begin(), values.end(), rad::SpanSumType<T>(0)));
+        for (T needle : { T(0), T(50), T(99), T(100) })
+        {
+            EXPECT_EQ(rad::SpanFind(values, needle),
+                size_t(std::find(values.begin(), values.end(), needle) - values.begin()));
+            EXPECT_EQ(rad::SpanCount(values, needle),
+                size_t(std::count(values.begin(), values.end(), needle)));
+        }
+        EXPECT_EQ(rad::SpanAny(values, [](T value) { return value == T(42); }),
+            std::any_of(values.begin(), values.end(), [](T value) { return value == T(42); }));
+        EXPECT_TRUE(rad::SpanAll(values, [](T value) { return value < T(100); }));
+
+        std::vector<T> copy(count);
+        rad::SpanCopy(copy, values);
+        EXPECT_TRUE(rad::SpanEquals(copy, values));
+        copy.back() = T(100);
+        EXPECT_FALSE(rad::SpanEquals(copy, values));
+        EXPECT_FALSE(rad::SpanEquals(rad::Span<T>(copy).drop_back(), values));
+
+        copy = values;
+        rad::SpanFill(rad::MutableSpan<T>(copy).drop_front(), T(7));
+        EXPECT_EQ(copy[0], values[0]);
+        EXPECT_EQ(rad::SpanCount(copy, T(7)), count - 1 + (values[0] == T(7) ? 1 : 0));
+    }
+}
+
+TEST(Container, SpanAlgorithm)
+{
+    TestSpanAlgorithms<int8_t>();
+    TestSpanAlgorithms<uint8_t>();
+    TestSpanAlgorithms<int16_t>();
+    TestSpanAlgorithms<uint16_t>();
+    TestSpanAlgorithms<int32_t>();
+    TestSpanAlgorithms<uint32_t>();
+    TestSpanAlgorithms<long long>();
+    TestSpanAlgorithms<uint64_t>();
+    TestSpanAlgorithms<float>();
+    TestSpanAlgorithms<double>();
+    TestSpanAlgorithms<char>();
+
+    // Signed values and the wide sums.
+    std::vector<int8_t> bytes(1000, int8_t(-100));
+    bytes[777] = 127;
+    EXPECT_EQ(rad::SpanSum(bytes), -100 * 999 + 127);
+    EXPECT_EQ(rad::SpanMinMax(bytes), std::make_pair(int8_t(-100), int8_t(127)));
+
+    // The integer sums wrap around on overflow.
+    std::vector<long long> large(17, std::numeric_limits<long long>::max());
+    EXPECT_EQ(rad::SpanSum(large), std::numeric_limits<long long>::max() - 16);
+    large.assign(16, std::numeric_limits<long long>::min());
+    large.push_back(-1);
+    EXPECT_EQ(rad::SpanSum(large), -1);
+    std::vector<uint64_t> unsignedLarge(9, std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(rad::SpanSum(unsignedLarge), std::numeric_limits<uint64_t>::max() - 8);
+
+    // Floats compare with operator==.
+    std::vector<float> a = { 0.0f, 1.0f, 2.0f };
+    std::vector<float> b = { -0.0f, 1.0f, 2.0f };
+    EXPECT_TRUE(rad::SpanEquals(a, b));
+    EXPECT_EQ(rad::SpanFind(a, -0.0f), 0);
+    b[2] = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_FALSE(rad::SpanEquals(b, b));
+    EXPECT_EQ(rad::SpanMinMax(b), std::make_pair(-0.0f, 1.0f));
+
+    // Large enough for the non-temporal copy, from an unaligned destination.
+    std::vector<uint8_t> src(64 * 1024 * 1024 + 3);
+    std::iota(src.begin(), src.end(), uint8_t(0));
+    std::vector<uint8_t> dst(src.size() + 1);
+    rad::SpanCopy(rad::MutableSpan<uint8_t>(dst).drop_front(), src);
+    EXPECT_TRUE(rad::SpanEquals(rad::Span<uint8_t>(dst).drop_front(), src));
+    EXPECT_EQ(dst[0], 0);
+
+    EXPECT_NE(rad::GetSpanKernels<float>().isaName, nullptr);
+}
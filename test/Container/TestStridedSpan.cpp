@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <rad/Container/StridedSpan.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+TEST(Container, StridedSpan)
+{
+    std::vector<int> data(12);
+    std::iota(data.begin(), data.end(), 0);
+
+    rad::StridedSpan<int> every3(data.data(), 4, 3);
+    EXPECT_EQ(every3[3], 9);
+    EXPECT_EQ(every3.back(), 9);
+    EXPECT_EQ(std::distance(every3.begin(), every3.end()), 4);
+    EXPECT_EQ(std::vector<int>(every3.begin(), every3.end()), (std::vector<int>{ 0, 3, 6, 9 }));
+    EXPECT_EQ(std::vector<int>(every3.reversed().begin(), every3.reversed().end()), (std::vector<int>{ 9, 6, 3, 0 }));
+    EXPECT_EQ(every3.slice(1, 2, 2)[1], 9);
+
+    every3.ForEach([](int& value) { value = -value; });
+    EXPECT_EQ(data[3], -3);
+    EXPECT_EQ(data[4], 4);
+    std::sort(every3.begin(), every3.end());
+    EXPECT_EQ(data[0], -9);
+    EXPECT_EQ(data[9], 0);
+
+    // The iterators of a column (last row at the end of the buffer) and of a reversed view
+    // (ends before the data) don't address past the elements.
+    rad::StridedSpan<int> column(data.data() + 2, 4, 3);
+    EXPECT_EQ(column.end() - column.begin(), 4);
+    EXPECT_EQ(*(column.end() - 1), data[11]);
+    rad::StridedSpan<int> reversed = column.reversed();
+    EXPECT_EQ(std::vector<int>(reversed.begin(), reversed.end()), (std::vector<int>{ 11, 8, 5, 2 }));
+    EXPECT_LT(reversed.begin(), reversed.end());
+    EXPECT_EQ(reversed.begin()[3], 2);
+    EXPECT_TRUE(column.slice(4).empty());
+    EXPECT_EQ(column.slice(4).begin(), column.slice(4).end());
+
+    rad::Span<int> span = data;
+    rad::StridedSpan<const int> contiguous = span;
+    EXPECT_TRUE(contiguous.IsContiguous());
+    EXPECT_EQ(contiguous.size(), 12);
+    rad::StridedSpan<const int> readOnly = every3;
+    EXPECT_EQ(readOnly[0], -9);
+}
+
+TEST(Container, SpanND)
+{
+    // 3x4 RGB image.
+    std::vector<int> pixels(3 * 4 * 3);
+    std::iota(pixels.begin(), pixels.end(), 0);
+    rad::SpanND<int, 3> image(pixels.data(), { 3, 4, 3 });
+    EXPECT_TRUE(image.IsContiguous());
+    EXPECT_EQ(image.size(), pixels.size());
+    EXPECT_EQ(image(1, 2, 1), (1 * 4 + 2) * 3 + 1);
+    EXPECT_EQ(image.stride(0), 12);
+
+    rad::Span2D<int> green = image.slice(2, 1);
+    EXPECT_FALSE(green.IsContiguous());
+    EXPECT_EQ(green.rows(), 3);
+    EXPECT_EQ(green.cols(), 4);
+    EXPECT_EQ(green.colStride(), 3);
+    EXPECT_EQ(green(2, 3), (2 * 4 + 3) * 3 + 1);
+    EXPECT_EQ(green.row(1)[2], image(1, 2, 1));
+    EXPECT_EQ(green.col(2)[1], image(1, 2, 1));
+
+    rad::Span2D<int> region = green.subspan(1, 2, 1, 2);
+    EXPECT_EQ(region(0, 0), image(1, 1, 1));
+    EXPECT_EQ(region(1, 1), image(2, 2, 1));
+    region.ForEach([](int& value) { value = 0; });
+    EXPECT_EQ(image(1, 1, 1), 0);
+    EXPECT_EQ(image(2, 2, 1), 0);
+    EXPECT_NE(image(1, 1, 0), 0);
+    EXPECT_NE(image(1, 3, 1), 0);
+
+    rad::Span2D<int> transposed = green.transposed();
+    EXPECT_EQ(transposed.rows(), 4);
+    EXPECT_EQ(transposed(3, 2), green(2, 3));
+
+    // Visit in the row-major order.
+    std::vector<int> visited;
+    rad::SpanND<const int, 3> readOnly = image.subspan(0, 1, 1);
+    readOnly.ForEach([&](int value) { visited.push_back(value); });
+    EXPECT_EQ(visited.size(), 12);
+    EXPECT_EQ(visited[0], 12);
+    EXPECT_EQ(visited[11], 23);
+
+    // Row pitch in bytes with padding, as a locked texture.
+    std::vector<float> texture(3 * 8);
+    auto texels = rad::Span2D<float>::FromRowPitch(texture.data(), 3, 5, 8 * sizeof(float));
+    texels(2, 4) = 1.0f;
+    EXPECT_EQ(texture[2 * 8 + 4], 1.0f);
+    EXPECT_EQ(texels.GetRowData(1), texture.data() + 8);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <rad/Core/Epoch.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct EpochNode
+{
+    static std::atomic<int> liveCount;
+    EpochNode(int value) : m_value(value) { ++liveCount; }
+    ~EpochNode() { m_value = -1; --liveCount; }
+    int m_value;
+};
+
+std::atomic<int> EpochNode::liveCount = 0;
+
+TEST(Core, Epoch)
+{
+    EXPECT_FALSE(rad::EpochIsPinned());
+    {
+        rad::EpochGuard guard;
+        rad::EpochGuard nested;
+        EXPECT_TRUE(rad::EpochIsPinned());
+    }
+    EXPECT_FALSE(rad::EpochIsPinned());
+
+    rad::EpochRetire(new EpochNode(0));
+    rad::EpochFlush();
+    EXPECT_EQ(EpochNode::liveCount, 0);
+
+    // A thread pinned blocks the reclamation.
+    std::atomic<int> step = 0;
+    std::thread reader([&]() {
+        rad::EpochGuard guard;
+        step = 1;
+        while (step != 2)
+        {
+            std::this_thread::yield();
+        }
+    });
+    while (step != 1)
+    {
+        std::this_thread::yield();
+    }
+    rad::EpochRetire(new EpochNode(1));
+    for (int i = 0; i < 8; ++i)
+    {
+        rad::EpochCollect();
+    }
+    EXPECT_EQ(EpochNode::liveCount, 1);
+    step = 2;
+    reader.join();
+    rad::EpochFlush();
+    EXPECT_EQ(EpochNode::liveCount, 0);
+
+    // Readers dereference the shared node while the writer keeps replacing it.
+    std::atomic<EpochNode*> shared = new EpochNode(0);
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]() {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                rad::EpochGuard guard;
+                EpochNode* node = shared.load(std::memory_order_acquire);
+                EXPECT_GE(node->m_value, 0);
+            }
+        });
+    }
+    for (int i = 1; i <= 20000; ++i)
+    {
+        EpochNode* old = shared.exchange(new EpochNode(i), std::memory_order_acq_rel);
+        rad::EpochRetire(old);
+    }
+    stop = true;
+    for (auto& thread : readers)
+    {
+        thread.join();
+    }
+    rad::EpochRetire(shared.exchange(nullptr));
+    rad::EpochFlush();
+    EXPECT_EQ(EpochNode::liveCount, 0);
+}
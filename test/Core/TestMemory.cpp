@@ -0,0 +1,360 @@
+#include <gtest/gtest.h>
+#include <rad/Core/AllocTracker.h>
+#include <rad/Core/Memory.h>
+#include <boost/container/pmr/polymorphic_allocator.hpp>
+#include <boost/container/vector.hpp>
+#include <cstring>
+#include <list>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(Core, Arena)
+{
+    rad::Arena arena(1024);
+    EXPECT_EQ(arena.GetUsedSize(), 0);
+    char* a = static_cast<char*>(arena.Allocate(100, 1));
+    std::memset(a, 'a', 100);
+    double* d = arena.Allocate<double>(4);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0);
+    void* aligned = arena.Allocate(16, 256);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 256, 0);
+
+    rad::Arena::Marker marker = arena.GetMarker();
+    const size_t usedSize = arena.GetUsedSize();
+    // Larger than the block size.
+    void* large = arena.Allocate(4096);
+    EXPECT_NE(large, nullptr);
+    {
+        rad::ArenaScope scope(arena);
+        arena.Allocate(512);
+    }
+    arena.Rewind(marker);
+    EXPECT_EQ(arena.GetUsedSize(), usedSize);
+    const size_t reservedSize = arena.GetReservedSize();
+    // The blocks are reused after rewinding.
+    EXPECT_EQ(arena.Allocate(4096), large);
+    EXPECT_EQ(arena.GetReservedSize(), reservedSize);
+
+    arena.Reset();
+    EXPECT_EQ(arena.GetUsedSize(), 0);
+    EXPECT_EQ(arena.Allocate(100, 1), a);
+    arena.Release();
+    EXPECT_EQ(arena.GetReservedSize(), 0);
+
+    alignas(16) char buffer[256];
+    rad::Arena stackArena(buffer, sizeof(buffer), 1024);
+    void* p = stackArena.Allocate(64);
+    EXPECT_TRUE((p >= buffer) && (p < buffer + sizeof(buffer)));
+    stackArena.Allocate(1024);
+    stackArena.Release();
+    EXPECT_EQ(stackArena.Allocate(64), p);
+}
+
+TEST(Core, ArenaResource)
+{
+    rad::Arena arena;
+    rad::ArenaResource resource(arena);
+    std::pmr::vector<std::pmr::string> strings(&resource);
+    for (int i = 0; i < 100; ++i)
+    {
+        strings.emplace_back(std::string(64, char('a' + i % 26)));
+    }
+    EXPECT_EQ(std::string_view(strings[27]), std::string(64, 'b'));
+    EXPECT_GT(arena.GetUsedSize(), 100 * 64);
+
+    rad::ArenaBoostResource boostResource(arena);
+    boost::container::vector<int, boost::container::pmr::polymorphic_allocator<int>> vec(&boostResource);
+    for (int i = 0; i < 100; ++i)
+    {
+        vec.push_back(i);
+    }
+    EXPECT_EQ(vec[99], 99);
+
+    // The sizes that would overflow the pointer arithmetic fail.
+    EXPECT_EQ(arena.Allocate(SIZE_MAX), nullptr);
+    EXPECT_EQ(arena.Allocate(SIZE_MAX - 8, 16), nullptr);
+    std::pmr::vector<char> chars(&resource);
+    EXPECT_THROW(chars.reserve(chars.max_size()), std::bad_alloc);
+    EXPECT_NE(arena.Allocate(64), nullptr);
+}
+
+TEST(Core, PoolAllocator)
+{
+    void* p = rad::PoolAlloc(24);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % rad::PoolBlockAlignment, 0);
+    rad::PoolFree(p, 24);
+    // LIFO in the thread cache.
+    EXPECT_EQ(rad::PoolAlloc(32), p);
+    rad::PoolFree(p, 32);
+    void* large = rad::PoolAlloc(rad::PoolMaxBlockSize + 1);
+    rad::PoolFree(large, rad::PoolMaxBlockSize + 1);
+
+    std::list<int, rad::PoolAllocator<int>> list;
+    std::map<int, std::string, std::less<int>, rad::PoolAllocator<std::pair<const int, std::string>>> map;
+    std::vector<int, rad::PoolAllocator<int>> vec;
+    for (int i = 0; i < 1000; ++i)
+    {
+        list.push_back(i);
+        map[i] = std::to_string(i);
+        vec.push_back(i);
+    }
+    EXPECT_EQ(list.size(), 1000);
+    EXPECT_EQ(map[999], "999");
+
+    // Allocate on one thread and free on another.
+    std::vector<std::thread> threads;
+    std::vector<std::vector<void*>> blocks(4);
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 10000; ++i)
+            {
+                void* block = rad::PoolAlloc(64);
+                std::memset(block, t, 64);
+                blocks[t].push_back(block);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (void* block : blocks[(t + 1) % 4])
+            {
+                EXPECT_EQ(static_cast<unsigned char*>(block)[63], (t + 1) % 4);
+                rad::PoolFree(block, 64);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    rad::PoolStats stats = rad::GetPoolStats(64);
+    EXPECT_EQ(stats.blockSize, 64);
+    EXPECT_GE(stats.reservedSize, 4 * 10000 * 64);
+    EXPECT_EQ(stats.allocatedCount, 0);
+
+    // Allocate and free in the thread_local destructors, before and after the thread cache is flushed.
+    struct PoolUser
+    {
+        void* block = nullptr;
+        ~PoolUser()
+        {
+            rad::PoolFree(block, 64);
+            rad::PoolFree(rad::PoolAlloc(64), 64);
+        }
+    };
+    std::thread([]() {
+        // Constructed before the first use of the cache, destroyed after it is flushed.
+        static thread_local PoolUser destroyedLast;
+        destroyedLast.block = rad::PoolAlloc(64);
+        static thread_local PoolUser destroyedFirst;
+        destroyedFirst.block = rad::PoolAlloc(64);
+    }).join();
+    // The first use during the thread exit.
+    std::thread([]() {
+        static thread_local PoolUser user;
+        (void)user;
+    }).join();
+    EXPECT_EQ(rad::GetPoolStats(64).allocatedCount, 0);
+}
+
+TEST(Core, LargeBuffer)
+{
+    void* p = rad::AlignedAlloc(100, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+    rad::AlignedFree(p);
+
+    for (rad::LargePageMode pageMode : { rad::LargePageMode::None, rad::LargePageMode::Transparent,
+        rad::LargePageMode::Explicit2M, rad::LargePageMode::Explicit1G })
+    {
+        rad::LargeBufferOptions options;
+        options.pageMode = pageMode;
+        options.numaPolicy = rad::NumaPolicy::Interleave;
+        options.numaNodeMask = 1;
+        options.prefault = true;
+        options.prefaultThreadCount = 4;
+        rad::LargeBuffer buffer;
+        const size_t size = 5 * 1024 * 1024 + 123;
+        ASSERT_TRUE(buffer.Allocate(size, options));
+        EXPECT_EQ(buffer.GetSize(), size);
+        EXPECT_GE(buffer.GetMappedSize(), size);
+        EXPECT_EQ(buffer.GetMappedSize() % buffer.GetPageSize(), 0);
+        unsigned char* data = static_cast<unsigned char*>(buffer.GetData());
+        EXPECT_EQ(data[0], 0);
+        EXPECT_EQ(data[size - 1], 0);
+        std::memset(data, 0xFF, size);
+        rad::LargeBuffer moved = std::move(buffer);
+        EXPECT_EQ(buffer.GetData(), nullptr);
+        EXPECT_EQ(static_cast<unsigned char*>(moved.GetData())[size - 1], 0xFF);
+    }
+}
+
+TEST(Core, VirtualBuffer)
+{
+    rad::VirtualBuffer buffer;
+    EXPECT_EQ(buffer.Append("x", 1), nullptr);
+    ASSERT_TRUE(buffer.Reserve(64 * 1024 * 1024));
+    EXPECT_EQ(buffer.GetCommittedSize(), 0);
+    uint8_t* data = static_cast<uint8_t*>(buffer.GetData());
+
+    // Grow without moving.
+    std::vector<uint8_t> chunk(1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::memset(chunk.data(), (i + 1) & 0xFF, chunk.size());
+        ASSERT_EQ(buffer.Append(chunk.data(), chunk.size()), data + i * chunk.size());
+    }
+    EXPECT_EQ(buffer.GetData(), data);
+    EXPECT_EQ(buffer.GetSize(), 1000 * 1000);
+    EXPECT_GE(buffer.GetCommittedSize(), buffer.GetSize());
+    EXPECT_EQ(data[999 * 1000], 1000 & 0xFF);
+
+    EXPECT_FALSE(buffer.Resize(buffer.GetReservedSize() + 1));
+    EXPECT_EQ(buffer.GetSize(), 1000 * 1000);
+
+    // Decommitted pages are zero on the next commit.
+    ASSERT_TRUE(buffer.Resize(100));
+    buffer.ShrinkToFit();
+    EXPECT_LT(buffer.GetCommittedSize(), 1000 * 1000);
+    EXPECT_EQ(data[99], 1);
+    ASSERT_TRUE(buffer.Resize(1000 * 1000));
+    EXPECT_EQ(data[999 * 1000], 0);
+
+    // The bytes left committed by a shrink or Clear are zero when exposed again.
+    std::memset(data, 0xFF, 1000 * 1000);
+    ASSERT_TRUE(buffer.Resize(10));
+    ASSERT_TRUE(buffer.Resize(1000 * 1000));
+    EXPECT_EQ(data[9], 0xFF);
+    EXPECT_EQ(data[10], 0);
+    EXPECT_EQ(data[999 * 1000], 0);
+    std::memset(data, 0xFF, 1000 * 1000);
+    buffer.Clear();
+    EXPECT_NE(buffer.Append("x", 1), nullptr);
+    ASSERT_TRUE(buffer.Resize(4096));
+    EXPECT_EQ(data[0], 'x');
+    EXPECT_EQ(data[1], 0);
+    EXPECT_EQ(data[4095], 0);
+
+    rad::VirtualBuffer moved = std::move(buffer);
+    EXPECT_EQ(buffer.GetData(), nullptr);
+    EXPECT_EQ(moved.GetData(), data);
+    moved.Release();
+    EXPECT_EQ(moved.GetReservedSize(), 0);
+}
+
+class TestAllocSampler : public rad::AllocSampler
+{
+public:
+    void OnAlloc(rad::AllocTag tag, void* /*p*/, std::size_t /*size*/) override
+    {
+        if (tag == rad::AllocTag::Pool)
+        {
+            ++m_poolSampleCount;
+        }
+    }
+    void OnFree(rad::AllocTag /*tag*/, void* /*p*/, std::size_t /*size*/) override {}
+    int m_poolSampleCount = 0;
+};
+
+TEST(Core, AllocTracker)
+{
+    auto findStats = [](rad::AllocTag tag) {
+        for (const rad::AllocTagStats& stats : rad::GetAllocStats())
+        {
+            if (stats.tag == tag)
+            {
+                return stats;
+            }
+        }
+        return rad::AllocTagStats{};
+    };
+
+    rad::AllocTag userTag = rad::RegisterAllocTag("TestUser");
+    EXPECT_EQ(rad::RegisterAllocTag("TestUser"), userTag);
+    EXPECT_EQ(rad::GetAllocTagName(userTag), "TestUser");
+    EXPECT_EQ(rad::GetAllocTagName(rad::AllocTag::Pool), "Pool");
+
+    // Not counted while disabled.
+    rad::ResetAllocStats();
+    rad::PoolFree(rad::PoolAlloc(48), 48);
+    EXPECT_EQ(findStats(rad::AllocTag::Pool).allocCount, 0);
+
+    TestAllocSampler sampler;
+    rad::SetAllocSampler(&sampler, 10);
+    rad::EnableAllocTracking(true);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i)
+    {
+        blocks.push_back(rad::PoolAlloc(48));
+    }
+    for (void* block : blocks)
+    {
+        rad::PoolFree(block, 48);
+    }
+    rad::TrackAlloc(userTag, nullptr, 10);
+    std::thread([]() { rad::AlignedFree(rad::AlignedAlloc(256, 64)); }).join();
+    // Freed in the thread teardown, after the thread's counters are merged.
+    std::thread([]() {
+        struct Holder
+        {
+            void* p = nullptr;
+            ~Holder() { rad::AlignedFree(p); }
+        };
+        // Constructed before the thread's counters, so destroyed after them.
+        static thread_local Holder holder;
+        holder.p = rad::AlignedAlloc(512, 64);
+    }).join();
+    rad::EnableAllocTracking(false);
+    rad::SetAllocSampler(nullptr, 0);
+
+    rad::AllocTagStats poolStats = findStats(rad::AllocTag::Pool);
+    EXPECT_EQ(poolStats.allocCount, 100);
+    EXPECT_EQ(poolStats.freeCount, 100);
+    EXPECT_EQ(poolStats.allocBytes, 4800);
+    EXPECT_EQ(poolStats.freeBytes, 4800);
+    EXPECT_EQ(sampler.m_poolSampleCount, 10);
+    EXPECT_EQ(findStats(userTag).allocBytes, 10);
+    // Merged from the exited thread, the usable size is counted.
+    rad::AllocTagStats alignedStats = findStats(rad::AllocTag::Aligned);
+    EXPECT_GE(alignedStats.allocBytes, 256 + 512);
+    EXPECT_EQ(alignedStats.freeCount, alignedStats.allocCount);
+    EXPECT_EQ(alignedStats.freeBytes, alignedStats.allocBytes);
+}
+
+TEST(Core, Relocate)
+{
+    static_assert(rad::IsTriviallyRelocatableV<int>);
+    static_assert(rad::IsTriviallyRelocatableV<std::unique_ptr<int>>);
+    static_assert(rad::IsTriviallyRelocatableV<rad::VirtualBuffer>);
+    static_assert(!rad::IsTriviallyRelocatableV<std::list<int>>);
+
+    // Compact in place, overlapping.
+    alignas(std::unique_ptr<int>) unsigned char storage[4 * sizeof(std::unique_ptr<int>)];
+    std::unique_ptr<int>* pointers = reinterpret_cast<std::unique_ptr<int>*>(storage);
+    for (int i = 0; i < 4; ++i)
+    {
+        std::construct_at(pointers + i, std::make_unique<int>(i));
+    }
+    std::destroy_at(pointers);
+    EXPECT_EQ(rad::UninitializedRelocate(pointers + 1, pointers + 4, pointers), pointers + 3);
+    EXPECT_EQ(*pointers[0], 1);
+    EXPECT_EQ(*pointers[2], 3);
+
+    // Element-wise for the other types.
+    alignas(std::list<int>) unsigned char listStorage[2 * sizeof(std::list<int>)];
+    std::list<int>* lists = reinterpret_cast<std::list<int>*>(listStorage);
+    std::construct_at(lists, std::list<int>{ 1, 2, 3 });
+    std::list<int>* list = rad::RelocateAt(lists, lists + 1);
+    EXPECT_EQ(list->size(), 3);
+    EXPECT_EQ(list->back(), 3);
+    std::destroy_at(list);
+    std::destroy_n(pointers, 3);
+}
@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+#include <rad/Core/RefCounted.h>
+#include <rad/Core/Memory.h>
+#include <thread>
+#include <vector>
+
+template<class Counter>
+class Object : public rad::RefCounted<Object<Counter>, Counter>
+{
+public:
+    Object(std::atomic<int>& liveCount) : m_liveCount(liveCount) { ++m_liveCount; }
+    ~Object() { --m_liveCount; }
+    std::atomic<int>& m_liveCount;
+};
+
+template<class Counter>
+void TestRefCounter()
+{
+    std::atomic<int> liveCount = 0;
+    {
+        rad::Ref<Object<Counter>> ref1 = RAD_NEW Object<Counter>(liveCount);
+        EXPECT_EQ(ref1->GetRefCount(), 1);
+        rad::Ref<Object<Counter>> ref2 = ref1;
+        EXPECT_EQ(ref1->GetRefCount(), 2);
+        ref1.reset();
+        EXPECT_EQ(ref2->GetRefCount(), 1);
+        EXPECT_EQ(liveCount, 1);
+    }
+    EXPECT_EQ(liveCount, 0);
+}
+
+TEST(Core, RefCounted)
+{
+    TestRefCounter<rad::RefCounterAtomic>();
+    TestRefCounter<rad::RefCounterNonAtomic>();
+    TestRefCounter<rad::RefCounterThreadBiased>();
+
+    // Share thread-biased references with other threads, and release the last one on either side.
+    for (int ownerReleasesFirst = 0; ownerReleasesFirst < 2; ++ownerReleasesFirst)
+    {
+        std::atomic<int> liveCount = 0;
+        using BiasedObject = Object<rad::RefCounterThreadBiased>;
+        rad::Ref<BiasedObject> ref = RAD_NEW BiasedObject(liveCount);
+        std::vector<std::thread> threads;
+        std::vector<rad::Ref<BiasedObject>> refs(4, ref);
+        for (auto& threadRef : refs)
+        {
+            threads.emplace_back([threadRef = std::move(threadRef), ownerReleasesFirst]() mutable {
+                for (int i = 0; i < 10000; ++i)
+                {
+                    rad::Ref<BiasedObject> copy = threadRef;
+                }
+                if (!ownerReleasesFirst)
+                {
+                    threadRef.reset();
+                }
+            });
+        }
+        if (ownerReleasesFirst)
+        {
+            ref.reset();
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        ref.reset();
+        // The releases of the references counted by the owner are queued to the owner.
+        rad::RefCounterThreadBiased::MergeQueued();
+        EXPECT_EQ(liveCount, 0);
+    }
+
+    // A release queued while the shared counter is zero, then the shared counter goes up again,
+    // and the biased counter drops to zero before the queue is merged.
+    for (int ownerReleasesLast = 0; ownerReleasesLast < 2; ++ownerReleasesLast)
+    {
+        std::atomic<int> liveCount = 0;
+        using BiasedObject = Object<rad::RefCounterThreadBiased>;
+        rad::Ref<BiasedObject> r1 = RAD_NEW BiasedObject(liveCount);
+        rad::Ref<BiasedObject> r2 = r1;
+        rad::Ref<BiasedObject> r3 = r1;
+        rad::Ref<BiasedObject> r4;
+        std::thread([&]() {
+            r2.reset();
+            r4 = r3;
+        }).join();
+        EXPECT_EQ(r4->GetRefCount(), 3);
+        r1.reset();
+        r3.reset();
+        EXPECT_EQ(r4->GetRefCount(), 1);
+        if (ownerReleasesLast)
+        {
+            r4.reset();
+        }
+        else
+        {
+            std::thread([&]() { r4.reset(); }).join();
+        }
+        EXPECT_EQ(liveCount, 1);
+        rad::RefCounterThreadBiased::MergeQueued();
+        EXPECT_EQ(liveCount, 0);
+    }
+
+    // Release the last reference after the owner thread exited.
+    {
+        std::atomic<int> liveCount = 0;
+        using BiasedObject = Object<rad::RefCounterThreadBiased>;
+        rad::Ref<BiasedObject> ref;
+        std::thread owner([&]() {
+            ref = RAD_NEW BiasedObject(liveCount);
+            rad::Ref<BiasedObject> copy = ref;
+        });
+        owner.join();
+        EXPECT_EQ(ref->GetRefCount(), 1);
+        ref.reset();
+        EXPECT_EQ(liveCount, 0);
+    }
+}
+
+TEST(Core, RefRelocate)
+{
+    using AtomicObject = Object<rad::RefCounterAtomic>;
+    static_assert(rad::IsTriviallyRelocatableV<rad::Ref<AtomicObject>>);
+    std::atomic<int> liveCount = 0;
+    {
+        // Relocated by memmove, the reference counts are unchanged.
+        alignas(rad::Ref<AtomicObject>) unsigned char storage[2 * sizeof(rad::Ref<AtomicObject>)];
+        rad::Ref<AtomicObject>* refs = reinterpret_cast<rad::Ref<AtomicObject>*>(storage);
+        std::construct_at(refs, RAD_NEW AtomicObject(liveCount));
+        rad::Ref<AtomicObject>* ref = rad::RelocateAt(refs, refs + 1);
+        EXPECT_EQ((*ref)->GetRefCount(), 1);
+        EXPECT_EQ(liveCount, 1);
+        std::destroy_at(ref);
+    }
+    EXPECT_EQ(liveCount, 0);
+}
+
+TEST(Core, WeakRef)
+{
+    using AtomicObject = Object<rad::RefCounterAtomic>;
+    std::atomic<int> liveCount = 0;
+    rad::Ref<AtomicObject> ref = RAD_NEW AtomicObject(liveCount);
+    rad::WeakRef<AtomicObject> weak;
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(weak.lock(), nullptr);
+    weak = ref;
+    rad::WeakRef<AtomicObject> weakCopy = weak;
+    EXPECT_FALSE(weakCopy.expired());
+    EXPECT_EQ(ref->GetRefCount(), 1);
+    {
+        rad::Ref<AtomicObject> locked = weak.lock();
+        EXPECT_EQ(locked, ref);
+        EXPECT_EQ(ref->GetRefCount(), 2);
+    }
+    ref.reset();
+    EXPECT_EQ(liveCount, 0);
+    EXPECT_TRUE(weak.expired());
+    EXPECT_TRUE(weakCopy.expired());
+    EXPECT_EQ(weakCopy.lock(), nullptr);
+
+    // Converts from the derived classes only.
+    struct DerivedObject : AtomicObject
+    {
+        using AtomicObject::AtomicObject;
+    };
+    static_assert(std::is_convertible_v<const rad::Ref<DerivedObject>&, rad::WeakRef<AtomicObject>>);
+    static_assert(!std::is_constructible_v<rad::WeakRef<DerivedObject>, const rad::Ref<AtomicObject>&>);
+    static_assert(!std::is_assignable_v<rad::WeakRef<DerivedObject>&, const rad::Ref<AtomicObject>&>);
+
+    // Promote while the last strong reference is released on another thread.
+    for (int i = 0; i < 100; ++i)
+    {
+        rad::Ref<AtomicObject> shared = RAD_NEW AtomicObject(liveCount);
+        rad::WeakRef<AtomicObject> sharedWeak = shared;
+        std::thread releaser([shared = std::move(shared)]() mutable { shared.reset(); });
+        while (rad::Ref<AtomicObject> locked = sharedWeak.lock())
+        {
+            EXPECT_EQ(liveCount, 1);
+        }
+        releaser.join();
+        EXPECT_TRUE(sharedWeak.expired());
+        EXPECT_EQ(liveCount, 0);
+    }
+}
+
+class PooledObject : public rad::RefCounted<PooledObject>, public rad::PoolAllocated<PooledObject>
+{
+public:
+    int m_value[4] = {};
+};
+
+static rad::DeferredDestroyQueue* g_destroyQueue = nullptr;
+static int g_destroyedCount = 0;
+
+class DeferredObject : public rad::RefCounted<DeferredObject>
+{
+public:
+    ~DeferredObject() { ++g_destroyedCount; }
+    static void DestroyRefCounted(const DeferredObject* p)
+    {
+        g_destroyQueue->Push(p);
+    }
+};
+
+TEST(Core, RefCountedDestroy)
+{
+    g_destroyedCount = 0;
+    // The freed block is recycled by the next allocation on the same thread.
+    PooledObject* pooled = RAD_NEW PooledObject();
+    rad::Ref<PooledObject> ref = pooled;
+    ref.reset();
+    ref = RAD_NEW PooledObject();
+    EXPECT_EQ(ref.get(), pooled);
+    ref.reset();
+
+    rad::DeferredDestroyQueue queue;
+    g_destroyQueue = &queue;
+    rad::Ref<DeferredObject> deferred = RAD_NEW DeferredObject();
+    rad::WeakRef<DeferredObject> weak = deferred;
+    std::thread([deferred = std::move(deferred)]() mutable { deferred.reset(); }).join();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(g_destroyedCount, 0);
+    queue.Flush();
+    EXPECT_EQ(g_destroyedCount, 1);
+    // Destroyed immediately on the owner thread.
+    deferred = RAD_NEW DeferredObject();
+    deferred.reset();
+    EXPECT_EQ(g_destroyedCount, 2);
+    // Destroyed immediately on the other threads after closed.
+    deferred = RAD_NEW DeferredObject();
+    EXPECT_FALSE(queue.IsClosed());
+    queue.Close();
+    EXPECT_TRUE(queue.IsClosed());
+    std::thread([deferred = std::move(deferred)]() mutable { deferred.reset(); }).join();
+    EXPECT_EQ(g_destroyedCount, 3);
+    g_destroyQueue = nullptr;
+}
+
+TEST(Core, AtomicRef)
+{
+    using AtomicObject = Object<rad::RefCounterAtomic>;
+    std::atomic<int> liveCount = 0;
+    {
+        rad::AtomicRef<AtomicObject> atomicRef;
+        EXPECT_EQ(atomicRef.load(), nullptr);
+        rad::Ref<AtomicObject> first = RAD_NEW AtomicObject(liveCount);
+        atomicRef.store(first);
+        EXPECT_EQ(atomicRef.load(), first);
+        EXPECT_EQ(first->GetRefCount(), 2);
+
+        rad::Ref<AtomicObject> expected;
+        rad::Ref<AtomicObject> second = RAD_NEW AtomicObject(liveCount);
+        EXPECT_FALSE(atomicRef.compare_exchange_strong(expected, second));
+        EXPECT_EQ(expected, first);
+        EXPECT_TRUE(atomicRef.compare_exchange_strong(expected, second));
+        // The reference held is released after the readers have unpinned.
+        rad::EpochFlush();
+        EXPECT_EQ(first->GetRefCount(), 2);
+        EXPECT_EQ(second->GetRefCount(), 2);
+        {
+            auto guard = atomicRef.read();
+            EXPECT_EQ(guard.get(), second.get());
+            EXPECT_EQ(second->GetRefCount(), 2);
+        }
+        rad::Ref<AtomicObject> old = atomicRef.exchange(nullptr);
+        EXPECT_EQ(old, second);
+        EXPECT_FALSE(atomicRef.read());
+        rad::EpochFlush();
+        EXPECT_EQ(second->GetRefCount(), 2);
+        atomicRef = first;
+    }
+    rad::EpochFlush();
+    EXPECT_EQ(liveCount, 0);
+
+    // Readers load while the writers keep swapping.
+    {
+        rad::AtomicRef<AtomicObject> atomicRef(RAD_NEW AtomicObject(liveCount));
+        std::atomic<bool> stop = false;
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&]() {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    {
+                        auto guard = atomicRef.read();
+                        EXPECT_GE(guard->GetRefCount(), 1);
+                    }
+                    rad::Ref<AtomicObject> ref = atomicRef.load();
+                    EXPECT_GE(ref->GetRefCount(), 1);
+                    rad::Ref<AtomicObject> expected = ref;
+                    atomicRef.compare_exchange_strong(expected, RAD_NEW AtomicObject(liveCount));
+                }
+            });
+        }
+        for (int i = 0; i < 20000; ++i)
+        {
+            atomicRef.store(RAD_NEW AtomicObject(liveCount));
+        }
+        stop = true;
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+        rad::EpochFlush();
+        EXPECT_EQ(liveCount, 1);
+    }
+    EXPECT_EQ(liveCount, 0);
+}
@@ -0,0 +1,338 @@
+#include <gtest/gtest.h>
+#include <rad/Core/String.h>
+#include <rad/IO/File.h>
+#include <map>
+#include <random>
+#include <unordered_map>
+
+TEST(Core, StrToNumber)
+{
+    int32_t i32 = 0;
+    EXPECT_TRUE(rad::StrToInt("12345678", i32));
+    EXPECT_EQ(i32, 12345678);
+    EXPECT_TRUE(rad::StrToInt("-2147483648", i32));
+    EXPECT_EQ(i32, INT32_MIN);
+    EXPECT_TRUE(rad::StrToInt("+2147483647", i32));
+    EXPECT_EQ(i32, INT32_MAX);
+    EXPECT_FALSE(rad::StrToInt("2147483648", i32));
+    EXPECT_FALSE(rad::StrToInt("12a45678", i32));
+    EXPECT_FALSE(rad::StrToInt("", i32));
+    EXPECT_FALSE(rad::StrToInt("-", i32));
+    EXPECT_EQ(i32, INT32_MAX);
+
+    int64_t i64 = 0;
+    EXPECT_TRUE(rad::StrToInt("-9223372036854775808", i64));
+    EXPECT_EQ(i64, INT64_MIN);
+    EXPECT_TRUE(rad::StrToInt("00000000000000000000000042", i64));
+    EXPECT_EQ(i64, 42);
+    EXPECT_FALSE(rad::StrToInt("9223372036854775808", i64));
+
+    uint64_t u64 = 0;
+    EXPECT_TRUE(rad::StrToInt("18446744073709551615", u64));
+    EXPECT_EQ(u64, UINT64_MAX);
+    EXPECT_FALSE(rad::StrToInt("18446744073709551616", u64));
+    EXPECT_FALSE(rad::StrToInt("-1", u64));
+    // Parse the view only, not until the null terminator.
+    std::string_view digits = "1234567890123";
+    EXPECT_TRUE(rad::StrToInt(digits.substr(0, 9), u64));
+    EXPECT_EQ(u64, 123456789);
+
+    uint32_t hex = 0;
+    EXPECT_TRUE(rad::StrToHex("0xDeadBeef", hex));
+    EXPECT_EQ(hex, 0xDEADBEEF);
+    EXPECT_TRUE(rad::StrToHex("ff", hex));
+    EXPECT_EQ(hex, 0xFF);
+    EXPECT_FALSE(rad::StrToHex("0x", hex));
+    EXPECT_FALSE(rad::StrToHex("0x100000000", hex));
+
+    double f64 = 0;
+    EXPECT_TRUE(rad::StrToFloat("+1.5e3", f64));
+    EXPECT_EQ(f64, 1500.0);
+    EXPECT_FALSE(rad::StrToFloat("1.5x", f64));
+    EXPECT_FALSE(rad::StrToFloat("+-1", f64));
+
+    char buffer[32] = {};
+    std::string_view str(buffer, rad::StrFromFloat(0.1, buffer, sizeof(buffer)));
+    EXPECT_EQ(str, "0.1");
+    str = std::string_view(buffer, rad::StrFromFloat(1.0f / 3.0f, buffer, sizeof(buffer)));
+    float f32 = 0;
+    EXPECT_TRUE(rad::StrToFloat(str, f32));
+    EXPECT_EQ(f32, 1.0f / 3.0f);
+    str = std::string_view(buffer, rad::StrFromInt(INT64_MIN, buffer, sizeof(buffer)));
+    EXPECT_EQ(str, "-9223372036854775808");
+    EXPECT_EQ(rad::StrFromInt(uint64_t(12345), buffer, 4), 0);
+
+    EXPECT_TRUE(rad::StrIsDecInteger("-1234567890123456789"));
+    EXPECT_FALSE(rad::StrIsDecInteger("12345678901234567/9"));
+    EXPECT_TRUE(rad::StrIsNumeric(std::string_view("3.14!", 4)));
+}
+
+TEST(Core, StrReplace)
+{
+    EXPECT_EQ(rad::StrReplace("a-b-c", "-", "--"), "a--b--c");
+    std::string str = "a-b-c";
+    rad::StrReplaceInPlace(str, "-", "");
+    EXPECT_EQ(str, "abc");
+    rad::StrReplaceInPlace(str, "", "x");
+    EXPECT_EQ(str, "abc");
+
+    rad::StrReplacer replacer = {
+        { "he", "HE" }, { "she", "SHE" }, { "hers", "HERS" }, { "bc", "1" }, { "abcd", "2" },
+        { "d", "3" }, { "&", "&amp;" }, { "<", "&lt;" },
+    };
+    EXPECT_EQ(replacer.Replace("ushers"), "uSHErs");
+    EXPECT_EQ(replacer.Replace("hers"), "HERS");
+    EXPECT_EQ(replacer.Replace("her"), "HEr");
+    EXPECT_EQ(replacer.Replace("abcd"), "2");
+    EXPECT_EQ(replacer.Replace("abce"), "a1e");
+    EXPECT_EQ(replacer.Replace("xbcd"), "x13");
+    EXPECT_EQ(replacer.Replace("<a & b>"), "&lt;a &amp; b>");
+    EXPECT_EQ(replacer.Replace(""), "");
+    rad::StrReplacer replacer2 = { { "abcde", "X" }, { "b", "B" }, { "d", "D" } };
+    EXPECT_EQ(replacer2.Replace("abcdf abcde"), "aBcDf X");
+
+    // Streaming results must not depend on how the input is split.
+    const std::string text = "she sells abcd shells; hers <abc> & ushers abcabcd";
+    const std::string expected = replacer.Replace(text);
+    for (size_t chunkSize = 1; chunkSize <= 8; ++chunkSize)
+    {
+        rad::StrReplacer::Stream stream(replacer);
+        std::string output;
+        for (size_t i = 0; i < text.size(); i += chunkSize)
+        {
+            stream.Write(std::string_view(text).substr(i, chunkSize), output);
+        }
+        stream.Finish(output);
+        EXPECT_EQ(output, expected);
+    }
+
+    // A short match at the start of a long partial match, the matches in the text after it are kept.
+    rad::StrReplacer replacer3 = { { "a", "A" }, { "abbbbc", "X" } };
+    std::string text3;
+    for (int i = 0; i < 1000; ++i)
+    {
+        text3 += (i % 3 == 0) ? "abbbbc" : "abbbbd";
+    }
+    std::string expected3;
+    for (int i = 0; i < 1000; ++i)
+    {
+        expected3 += (i % 3 == 0) ? "X" : "Abbbbd";
+    }
+    EXPECT_EQ(replacer3.Replace(text3), expected3);
+    rad::StrReplacer replacer4 = { { "a", "A" }, { "bb", "B" }, { "abbbbc", "X" } };
+    EXPECT_EQ(replacer4.Replace("abbbbd abbbbc abbb"), "ABBd X ABb");
+    EXPECT_FALSE(replacer4.Add("c", "C"));
+    rad::StrReplacer replacer5;
+    EXPECT_FALSE(replacer5.Add("", "x"));
+    EXPECT_TRUE(replacer5.Add("c", "C"));
+}
+
+// The reference: the longest pattern at the leftmost position, the first added if the same.
+static std::string StrReplaceNaive(std::string_view text,
+    const std::vector<std::pair<std::string, std::string>>& patterns)
+{
+    std::string output;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        const std::pair<std::string, std::string>* best = nullptr;
+        for (const auto& pattern : patterns)
+        {
+            if (text.substr(pos).starts_with(pattern.first) &&
+                (!best || (pattern.first.size() > best->first.size())))
+            {
+                best = &pattern;
+            }
+        }
+        if (best)
+        {
+            output += best->second;
+            pos += best->first.size();
+        }
+        else
+        {
+            output += text[pos++];
+        }
+    }
+    return output;
+}
+
+TEST(Core, StrReplacerRandom)
+{
+    std::mt19937 random(42);
+    for (int round = 0; round < 200; ++round)
+    {
+        // Small alphabet for many overlaps.
+        std::vector<std::pair<std::string, std::string>> patterns(1 + random() % 6);
+        rad::StrReplacer replacer;
+        for (size_t i = 0; i < patterns.size(); ++i)
+        {
+            const size_t length = 1 + random() % 6;
+            for (size_t j = 0; j < length; ++j)
+            {
+                patterns[i].first += char('a' + random() % 3);
+            }
+            patterns[i].second = "<" + std::to_string(i) + ">";
+            replacer.Add(patterns[i].first, patterns[i].second);
+        }
+        replacer.Compile();
+        std::string text;
+        const size_t textLength = random() % 10000;
+        for (size_t i = 0; i < textLength; ++i)
+        {
+            text += char('a' + random() % 4);
+        }
+
+        const std::string expected = StrReplaceNaive(text, patterns);
+        ASSERT_EQ(replacer.Replace(text), expected);
+        const size_t chunkSize = 1 + random() % 10;
+        rad::StrReplacer::Stream stream(replacer);
+        std::string output;
+        for (size_t i = 0; i < text.size(); i += chunkSize)
+        {
+            stream.Write(std::string_view(text).substr(i, chunkSize), output);
+        }
+        stream.Finish(output);
+        ASSERT_EQ(output, expected);
+    }
+}
+
+TEST(Core, StrFormat)
+{
+    std::string str = "previous content";
+    EXPECT_EQ(rad::StrPrintInPlace(str, "%d-%s", 42, "abc"), 6);
+    EXPECT_EQ(str, "42-abc");
+    EXPECT_EQ(rad::StrPrint("%s", std::string(100, 'x').c_str()), std::string(100, 'x'));
+    str.clear();
+    EXPECT_EQ(rad::StrPrintInPlace(str, "%s", ""), 0);
+    EXPECT_TRUE(str.empty());
+    str.reserve(1024 * 1024);
+    EXPECT_EQ(rad::StrPrintInPlace(str, "%d", 7), 1);
+    EXPECT_EQ(str, "7");
+    EXPECT_EQ(rad::StrPrintInPlace(str, "%s", std::string(2000000, 'y').c_str()), 2000000);
+    EXPECT_EQ(str, std::string(2000000, 'y'));
+
+    rad::FormatBuffer<16> buffer;
+    rad::StrFormatTo(buffer, "{}/{}", "root", 123);
+    EXPECT_EQ(buffer.view(), "root/123");
+    rad::StrFormatTo(buffer, "/{:08x}", 0xABCDu);
+    EXPECT_EQ(buffer.view(), "root/123/0000abcd");
+    EXPECT_GE(buffer.capacity(), buffer.size());
+    EXPECT_STREQ(buffer.c_str(), "root/123/0000abcd");
+    buffer.clear();
+    buffer.append("path");
+    EXPECT_EQ(buffer.str(), "path");
+
+    std::string output = "log: ";
+    rad::StrFormatTo(output, "{} {}", 1.5, true);
+    EXPECT_EQ(output, "log: 1.5 true");
+    EXPECT_EQ(rad::StrFormatThreadLocal("{}+{}={}", 1, 2, 3), "1+2=3");
+}
+
+TEST(Core, StrFind)
+{
+    const std::string text = "[info] GET /api/v1/users/42 200 OK; [warn] POST /api/v2/orders 503 Service Unavailable";
+    for (std::string_view needle : { "GET", "[warn]", "Unavailable", "/api/v2/", "x", "v3", "K;", "" })
+    {
+        EXPECT_EQ(rad::StrFind(text, needle), text.find(needle));
+        EXPECT_EQ(rad::StrFind(text, needle, 20), text.find(needle, 20));
+    }
+    EXPECT_EQ(rad::StrFind(text, "a", text.size() + 1), std::string_view::npos);
+    EXPECT_TRUE(rad::StrContains(text, "503"));
+    EXPECT_FALSE(rad::StrContains(std::string_view(text).substr(0, 30), "503"));
+
+    rad::StrMultiFinder finder = { "503", "[warn]", "/orders", "Service", "v" };
+    size_t needleIndex = SIZE_MAX;
+    EXPECT_EQ(finder.Find(text, 0, &needleIndex), text.find("v"));
+    EXPECT_EQ(needleIndex, 4);
+    EXPECT_EQ(finder.Find(text, 20, &needleIndex), text.find("[warn]"));
+    EXPECT_EQ(needleIndex, 1);
+    EXPECT_EQ(finder.Find(text, text.find("503") - 1, &needleIndex), text.find("503"));
+    EXPECT_EQ(needleIndex, 0);
+    EXPECT_FALSE(finder.ContainsAny("[info] GET /api/1/users/42 200 OK"));
+    EXPECT_TRUE(finder.ContainsAny("v"));
+
+    // The needles that don't fit the masks are rejected.
+    EXPECT_EQ(finder.Add(""), std::string_view::npos);
+    while (finder.GetNeedleCount() < rad::StrMultiFinder::MaxNeedleCount)
+    {
+        const size_t index = finder.GetNeedleCount();
+        EXPECT_EQ(finder.Add("#" + std::to_string(index) + ";"), index);
+    }
+    EXPECT_EQ(finder.Add("extra"), std::string_view::npos);
+    EXPECT_EQ(finder.GetNeedleCount(), rad::StrMultiFinder::MaxNeedleCount);
+    EXPECT_EQ(finder.Find("extra #63;", 0, &needleIndex), 6);
+    EXPECT_EQ(needleIndex, 63);
+}
+
+TEST(Core, StrCompare)
+{
+    // Views are not null-terminated.
+    std::string_view abcd = "abcd";
+    EXPECT_EQ(rad::StrCompare(abcd.substr(0, 2), "ab"), 0);
+    EXPECT_LT(rad::StrCompare(abcd.substr(0, 2), abcd), 0);
+    EXPECT_TRUE(rad::StrCaseEqual(abcd.substr(0, 3), "ABC"));
+    EXPECT_FALSE(rad::StrCaseEqual(abcd, "ABC"));
+    EXPECT_GT(rad::StrCaseCompare("B", "a"), 0);
+    EXPECT_LT(rad::StrCaseCompare("abc", "ABCD"), 0);
+
+    const std::string path1 = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+    const std::string path2 = "/usr/share/fonts/TrueType/dejavu/DejaVuSans-Bold.ttf";
+    EXPECT_EQ(rad::StrMismatch(path1, path2), 17);
+    EXPECT_EQ(rad::StrCaseMismatch(path1, path2), 43);
+    EXPECT_EQ(rad::StrMismatch(path1, path1), path1.size());
+    EXPECT_FALSE(rad::StringLess()(abcd.substr(0, 2), "ab"));
+    EXPECT_TRUE(rad::StringLessCaseInsensitive()("ABC", abcd));
+
+    std::map<std::string, int, rad::StringLess> map = { { "ab", 1 }, { "abc", 2 } };
+    EXPECT_EQ(map.find(abcd.substr(0, 2))->second, 1);
+    std::unordered_map<std::string, int, rad::StringHash, rad::StringEqual> hashMap = { { "ab", 1 } };
+    EXPECT_EQ(hashMap.find(abcd.substr(0, 2))->second, 1);
+    EXPECT_EQ(hashMap.count(abcd), 0);
+    std::unordered_map<std::string, int,
+        rad::StringHashCaseInsensitive, rad::StringEqualCaseInsensitive> caseMap = { { path1, 1 } };
+    EXPECT_EQ(caseMap.count(rad::StrUpper(path1)), 1);
+}
+
+TEST(Core, StringBuilder)
+{
+    rad::StringBuilder builder(16);
+    std::string expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        builder.Append("line ");
+        rad::StrFormatTo(builder, "{}", i);
+        builder.Append('\n');
+        expected += "line " + std::to_string(i) + "\n";
+    }
+    const std::string large(100, 'x');
+    builder.Append(large);
+    expected += large;
+    EXPECT_EQ(builder.size(), expected.size());
+    EXPECT_GT(builder.GetChunkCount(), 1);
+    EXPECT_EQ(builder.ToString(), expected);
+
+    const std::string path = testing::TempDir() + "StringBuilder.txt";
+    rad::File file;
+    ASSERT_TRUE(file.Open(path, "wb"));
+    file.Write("head:", 1, 5);
+    EXPECT_EQ(file.WriteChunks(builder.GetChunks(), builder.GetChunkCount()), expected.size());
+    file.Close();
+    EXPECT_EQ(rad::File::ReadAll(path), "head:" + expected);
+
+    // Replace the file content chunk by chunk.
+    const std::string replacedPath = testing::TempDir() + "StringBuilderReplaced.txt";
+    rad::StrReplacer replacer = { { "line", "LINE" }, { "\n", ";" } };
+    ASSERT_TRUE(file.Open(path, "rb"));
+    rad::File replacedFile;
+    ASSERT_TRUE(replacedFile.Open(replacedPath, "wb"));
+    rad::StrReplace(replacer, file, replacedFile, 7);
+    file.Close();
+    replacedFile.Close();
+    EXPECT_EQ(rad::File::ReadAll(replacedPath), replacer.Replace("head:" + expected));
+
+    builder.Clear();
+    EXPECT_TRUE(builder.empty());
+    builder.Append("abc");
+    EXPECT_EQ(builder.ToString(), "abc");
+}
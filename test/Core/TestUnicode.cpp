@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <rad/Core/Unicode.h>
+
+TEST(Core, Unicode)
+{
+    // Mixed ASCII and 2/3/4-byte sequences, longer than a SIMD block.
+    const std::string u8 = "Hello, World! \xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80 and some trailing ASCII text.";
+    const std::u16string u16 = u"Hello, World! é中\U0001F600 and some trailing ASCII text.";
+    const std::u32string u32 = U"Hello, World! é中\U0001F600 and some trailing ASCII text.";
+
+    EXPECT_TRUE(rad::Utf8Validate(u8));
+    EXPECT_TRUE(rad::Utf16Validate(u16));
+    EXPECT_TRUE(rad::Utf32Validate(u32));
+    EXPECT_EQ(rad::Utf8CountCodePoints(u8), u32.size());
+    EXPECT_EQ(rad::Utf16LengthFromUtf8(u8), u16.size());
+    EXPECT_EQ(rad::Utf8LengthFromUtf16(u16), u8.size());
+    EXPECT_EQ(rad::Utf32LengthFromUtf16(u16), u32.size());
+    EXPECT_EQ(rad::Utf8LengthFromUtf32(u32), u8.size());
+    EXPECT_EQ(rad::Utf16LengthFromUtf32(u32), u16.size());
+
+    EXPECT_EQ(rad::StrU8ToU16(u8), u16);
+    EXPECT_EQ(rad::StrU8ToU32(u8), u32);
+    EXPECT_EQ(rad::StrU16ToU8(u16), u8);
+    EXPECT_EQ(rad::StrU32ToU8(u32), u8);
+    EXPECT_EQ(rad::StrWideToU8(rad::StrU8ToWide(u8)), u8);
+
+    std::u32string buffer32(u32.size(), U'\0');
+    EXPECT_EQ(rad::Utf16ToUtf32(u16, buffer32.data()), u32.size());
+    EXPECT_EQ(buffer32, u32);
+    std::u16string buffer16(u16.size(), u'\0');
+    EXPECT_EQ(rad::Utf32ToUtf16(u32, buffer16.data()), u16.size());
+    EXPECT_EQ(buffer16, u16);
+
+    // Overlong, surrogate, out of range, truncated and stray continuation.
+    for (std::string_view invalid : { "\xC0\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "ab\xE4\xB8", "\x80" })
+    {
+        EXPECT_FALSE(rad::Utf8Validate(invalid));
+        std::u16string dst(rad::Utf16LengthFromUtf8(invalid), u'\0');
+        EXPECT_EQ(rad::Utf8ToUtf16(invalid, dst.data()), 0);
+    }
+    EXPECT_FALSE(rad::Utf16Validate(std::u16string_view(u"\xD800" u"a", 2)));
+    EXPECT_FALSE(rad::Utf32Validate(std::u32string_view(U"\x110000", 1)));
+    // Invalid sequences are skipped, and the view length is respected.
+    EXPECT_EQ(rad::StrU8ToU16(std::string_view("a\xFF" "bc", 3)), u"ab");
+}